@@ -0,0 +1,131 @@
+/*
+	Checks HELPER::CountHues against the hue formula HELPER::GetHue uses, over raw pixel buffers so it runs
+	without Windows. It isn't part of the Visual Studio build, build and run it on its own, once with
+	HUE_NO_SIMD defined to check the plain version as well:
+
+		g++ -std=c++17 -O2 -I../src hueHistogramCheck.cpp ../src/hueHistogram.cpp -o hueCheck && ./hueCheck
+		g++ -std=c++17 -O2 -DHUE_NO_SIMD -I../src hueHistogramCheck.cpp ../src/hueHistogram.cpp -o hueCheck && ./hueCheck
+
+	Exits with 1 if any histogram differs
+*/
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "hueHistogram.h"
+
+// The same steps as HELPER::GetHue, which can't be built here as catHelper needs Windows
+static int GetHue(int red, int green, int blue)
+{
+	float min = std::min(std::min(red, green), blue);
+	float max = std::max(std::max(red, green), blue);
+
+	if (min == max)
+	{
+		return 0;
+	}
+
+	float hue = 0.0f;
+
+	if (max == red)
+	{
+		hue = (green - blue) / (max - min);
+	}
+	else if (max == green)
+	{
+		hue = 2.0f + (blue - red) / (max - min);
+	}
+	else
+	{
+		hue = 4.0f + (red - green) / (max - min);
+	}
+
+	hue = hue * 60;
+	if (hue < 0) hue = hue + 360;
+
+	// GetHue can give 360, which the histogram counts as 0
+	return (int)std::round(hue) % HUE_COUNT;
+}
+
+/*
+	Counts the hues of a buffer both ways and compares them
+
+	@param name Shown if the check fails
+	@param bgra The pixels
+	@param pixelCount Number of pixels from the start of the buffer
+	@return If the histograms match
+*/
+static bool Check(const std::string& name, const unsigned char* bgra, int pixelCount)
+{
+	std::vector<int> expected(HUE_COUNT, 1);
+	std::vector<int> counted(HUE_COUNT, 1); // CountHues adds to what's already there
+
+	for (int i = 0; i < pixelCount; ++i)
+	{
+		expected[GetHue(bgra[i * 4 + 2], bgra[i * 4 + 1], bgra[i * 4 + 0])]++;
+	}
+
+	HELPER::CountHues(bgra, pixelCount, counted.data());
+
+	for (int hue = 0; hue < HUE_COUNT; ++hue)
+	{
+		if (expected[hue] != counted[hue])
+		{
+			std::cout << "FAILED: " << name << ", hue " << hue << " counted " << counted[hue] << " expected " << expected[hue] << std::endl;
+			return false;
+		}
+	}
+
+	std::cout << "passed: " << name << std::endl;
+	return true;
+}
+
+int main()
+{
+	bool passed = true;
+
+	// Every colour once, with the alpha changing so it's known to be ignored
+	std::vector<unsigned char> colours;
+	colours.reserve(256 * 256 * 256 * 4);
+
+	for (int r = 0; r < 256; ++r)
+	{
+		for (int g = 0; g < 256; ++g)
+		{
+			for (int b = 0; b < 256; ++b)
+			{
+				colours.insert(colours.end(), { (unsigned char)b, (unsigned char)g, (unsigned char)r, (unsigned char)(r ^ b) });
+			}
+		}
+	}
+
+	passed &= Check("every colour", colours.data(), (int)(colours.size() / 4));
+
+	// Random icon sized buffers, sizes that don't fill the last block or the last four pixels, starting off alignment
+	std::mt19937 random(1);
+	std::vector<unsigned char> pixels(300 * 4 + 3);
+	for (unsigned char& byte : pixels) { byte = (unsigned char)random(); }
+
+	for (int count : { 0, 1, 3, 4, 5, 255, 256, 257, 300 })
+	{
+		passed &= Check(std::to_string(count) + " pixels", pixels.data(), count);
+		passed &= Check(std::to_string(count) + " pixels off alignment", pixels.data() + 3, count);
+	}
+
+	// Greys and the pure colours at the edges of the hue wheel
+	std::vector<unsigned char> edges;
+	for (int v = 0; v < 256; ++v)
+	{
+		edges.insert(edges.end(), { (unsigned char)v, (unsigned char)v, (unsigned char)v, 255 });
+		edges.insert(edges.end(), { (unsigned char)(255 - v), 0, 255, 255 });
+		edges.insert(edges.end(), { 0, (unsigned char)v, 255, 255 });
+	}
+
+	passed &= Check("greys and edges", edges.data(), (int)(edges.size() / 4));
+
+	std::cout << (passed ? "All hue checks passed" : "Hue checks FAILED") << std::endl;
+	return passed ? 0 : 1;
+}
@@ -24,6 +24,8 @@
 #include "cat.h"
 #include "input.h"
 #include "scene.h"
+#include "batchRunner.h"
+#include "entityBenchmark.h"
 #include "room.h"
 #include "monitorManager.h"
 #include "instanceLayer.h"
@@ -131,8 +133,6 @@ BOOL CreateHGLRC(HWND hWnd)
 	return TRUE;
 }
 
-GLuint HiconToTexture(HICON hIcon);
-
 LRESULT CALLBACK WindowFunc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
 	switch (msg) {
@@ -150,41 +150,31 @@ LRESULT CALLBACK WindowFunc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 			PostQuitMessage(0);
 			break;
 		}
-		//case WM_DROPFILES:
-		//{	
-		//	HDROP hDropInfo = (HDROP)wParam;
-		//	char sItem[MAX_PATH];
-		//	DragQueryFile(hDropInfo, 0, (LPWSTR)sItem, sizeof(sItem));
-
-		//	// Get the filepath
-		//	// -----------------------------------
-		//	//int i = 0;
-		//	//char current = sItem[i];
-		//	//std::string filePath = "";
-
-		//	//do 
-		//	//{
-		//	//	if (current != 0) 
-		//	//	{
-		//	//		filePath += current;
-		//	//	}
-
-		//	//	++i;
-		//	//	current = sItem[i];
-
-		//	//} while (current != -52 && i <= MAX_PATH);
-		//	// -----------------------------------
-
-		//	// Get the icon and create a texture from it
-		//	WORD* word = new WORD();
-		//	HICON icon = ExtractAssociatedIcon(NULL, (LPWSTR)sItem, word);
-
-		//	MainScene->OnFileDropped(icon);
-
-		//	delete word;
-		//	word = nullptr;
-		//	break;
-		//}
+		case WM_DISPLAYCHANGE:
+		{
+			CMonitorManager::GetInstance().OnDisplayChange();
+			return DefWindowProc(hWnd, msg, wParam, lParam);
+		}
+		case WM_SETTINGCHANGE:
+		{
+			// The taskbar moving or resizing changes the work areas
+			IfThenStatement(wParam == SPI_SETWORKAREA, CMonitorManager::GetInstance().OnDisplayChange());
+			return DefWindowProc(hWnd, msg, wParam, lParam);
+		}
+		case WM_DROPFILES:
+		{
+			// Only the first file is eaten, the icon is read off the main thread
+			HDROP hDropInfo = (HDROP)wParam;
+			wchar_t filePath[MAX_PATH];
+
+			if (MainScene != nullptr && DragQueryFileW(hDropInfo, 0, filePath, MAX_PATH) > 0)
+			{
+				MainScene->OnFileDropped(filePath);
+			}
+
+			DragFinish(hDropInfo);
+			break;
+		}
 		default:
 			return DefWindowProc(hWnd, msg, wParam, lParam);
 	}
@@ -194,6 +184,24 @@ LRESULT CALLBACK WindowFunc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
 int WINAPI WinMain(HINSTANCE hThisInst, HINSTANCE hPrevInst, LPSTR str, int nWinMode) 
 {
+	// "--batch <sweep file>" runs a batch of simulations instead of the cats, "--entity-benchmark" checks and times the entity store,
+	// anything else names the configs file to use
+	std::string commandLine = HELPER::Trim(str != nullptr ? str : "");
+
+	if (commandLine._Starts_with("--batch "))
+	{
+		CBatchRunner batch(HELPER::Trim(commandLine.substr(8)));
+		return batch.Run();
+	}
+
+	if (commandLine == "--entity-benchmark")
+	{
+		CEntityBenchmark benchmark;
+		return benchmark.Run();
+	}
+
+	std::string configsName = commandLine != "" ? commandLine : "Configs";
+
 	WNDCLASSEX wc;
 	memset(&wc, 0, sizeof(wc));
 	wc.cbSize = sizeof(WNDCLASSEX);
@@ -222,11 +230,22 @@ int WINAPI WinMain(HINSTANCE hThisInst, HINSTANCE hPrevInst, LPSTR str, int nWin
 
 	settings.AddDefaultStringVariable("monitors", "auto");
 	settings.AddDefaultStringVariable("f3-debug", "disabled");
-
-
-	if (std::filesystem::exists("Configs.txt"))
+	settings.AddDefaultStringVariable("worker-threads", "auto");
+	settings.AddDefaultStringVariable("profiler", "disabled");
+	settings.AddDefaultStringVariable("simulation-rate", "60");
+	settings.AddDefaultStringVariable("random-seed", "auto");
+	settings.AddDefaultStringVariable("replay", "disabled");
+	settings.AddDefaultStringVariable("time-scale", "1");
+	settings.AddDefaultStringVariable("cat-folder", "Resources\\Cats\\");
+	settings.AddDefaultStringVariable("run-seconds", "0");
+	settings.AddDefaultStringVariable("metrics-file", "disabled");
+	settings.AddDefaultStringVariable("window", "visible");
+	settings.AddDefaultStringVariable("allocation-check", "disabled");
+
+
+	if (std::filesystem::exists(configsName + ".txt"))
 	{
-		CGlobalVariables::ConfigSetting = new CConfigs(settings, "Configs");
+		CGlobalVariables::ConfigSetting = new CConfigs(settings, configsName);
 	}
 	else
 	{
@@ -245,8 +264,11 @@ int WINAPI WinMain(HINSTANCE hThisInst, HINSTANCE hPrevInst, LPSTR str, int nWin
 	int winWidth = winCombined.right - winCombined.left;
 	int winHeight = winCombined.bottom - winCombined.top;
 		
+	// Batch runs have their window hidden so they can't be seen or clicked
+	DWORD visibleStyle = CGlobalVariables::ConfigSetting->GetStringVariable("window") == "hidden" ? 0 : WS_VISIBLE;
+
 	HWND hWnd = CreateWindowEx(WS_EX_ACCEPTFILES | WS_EX_TOPMOST | WS_EX_TOOLWINDOW | WS_EX_TRANSPARENT, szAppName, wcWndName,
-							   WS_VISIBLE | WS_POPUP, winCombined.left - margin, winCombined.top - margin, winWidth + margin * 2.0f, winHeight + margin * 2.0f,
+							   visibleStyle | WS_POPUP, winCombined.left - margin, winCombined.top - margin, winWidth + margin * 2.0f, winHeight + margin * 2.0f,
 							   NULL, NULL, hThisInst, NULL);
 
 	LONG cur_style = GetWindowLong(hWnd, GWL_EXSTYLE);
@@ -317,6 +339,7 @@ int WINAPI WinMain(HINSTANCE hThisInst, HINSTANCE hPrevInst, LPSTR str, int nWin
 
 
 	MainScene->CleanUp();
+	int exitCode = MainScene->GetExitCode();
 
 	delete MainScene;
 	MainScene = nullptr;
@@ -324,5 +347,5 @@ int WINAPI WinMain(HINSTANCE hThisInst, HINSTANCE hPrevInst, LPSTR str, int nWin
 	delete CGlobalVariables::ConfigSetting;
 	CGlobalVariables::ConfigSetting = nullptr;
 
-	return (FALSE);
+	return exitCode;
 }
@@ -17,7 +17,7 @@ SleepingAction::SleepingAction(CCat* parentCat, float seconds) :
 
 void SleepingAction::Start()
 {
-	StartTime = std::chrono::steady_clock::now();
+	StartTime = TIMER::GetTotalSeconds();
 
 	ParentCat->SetAnimationIndex("Sleeping");
 	ParentCat->SetCurrentState(CatState::Sleeping);
@@ -25,7 +25,7 @@ void SleepingAction::Start()
 
 bool SleepingAction::Update()
 {
-	float duration = (float)std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - StartTime).count();
+	float duration = (float)(TIMER::GetTotalSeconds() - StartTime);
 	return duration >= Seconds;
 }
 
@@ -43,16 +43,16 @@ WalkTimedAction::~WalkTimedAction()
 
 void WalkTimedAction::Start()
 {
-	StartTime = std::chrono::steady_clock::now();
+	StartTime = TIMER::GetTotalSeconds();
 
 	ParentCat->Velocity.x = (float)WalkDirection * ParentCat->WalkSpeed;
-	ParentCat->SetAnimationIndex("Walking " + std::string(WalkDirection == DIRECTION::RIGHT ? "Right" : "Left"));
+	ParentCat->SetAnimationIndex(WalkDirection == DIRECTION::RIGHT ? "Walking Right" : "Walking Left");
 	ParentCat->SetCurrentState(CatState::Walking);
 }
 
 bool WalkTimedAction::Update()
 {
-	float duration = (float)std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - StartTime).count();
+	float duration = (float)(TIMER::GetTotalSeconds() - StartTime);
 
 	if (duration >= Seconds)
 	{
@@ -87,7 +87,7 @@ void WalkTargetAction::Start()
 	WalkDirection = TargetX >= ParentCat->Location.x ? DIRECTION::RIGHT : DIRECTION::LEFT;
 
 	ParentCat->Velocity.x = (float)WalkDirection * ParentCat->WalkSpeed;
-	ParentCat->SetAnimationIndex("Walking " + std::string(WalkDirection == DIRECTION::RIGHT ? "Right" : "Left"));
+	ParentCat->SetAnimationIndex(WalkDirection == DIRECTION::RIGHT ? "Walking Right" : "Walking Left");
 	ParentCat->SetCurrentState(CatState::Walking);
 }
 
@@ -149,7 +149,9 @@ void JumpingAction::QueueJumpWaitFunction(CCat* parentCat, HWND window, float ta
 		}
 
 		// Return once within 10 pixels
-		return (parentCat->Location.y - topValue) < 10.0f;
+		bool landed = (parentCat->Location.y - topValue) < 10.0f;
+		IfThenStatement(landed, parentCat->GetMetrics().JumpsSucceeded++);
+		return landed;
 
 	}));
 }
@@ -193,6 +195,7 @@ void JumpingAction::QueueJumpingActions(CCat* parentCat, HWND window)
 void JumpingAction::Start()
 {
 	RECT bounds;
+	ParentCat->GetMetrics().JumpsAttempted++;
 
 	if (Window != nullptr && CWindowsManager::GetInstance().GetWindowBoundry(Window, bounds))
 	{
@@ -229,6 +232,10 @@ void CarriedAction::Start()
 {
 	ParentCat->SetCurrentState(CatState::Carried);
 	ParentCat->SetAnimationIndex("Carried");
+
+	// The cat snaps to the mouse when picked up
+	ParentCat->Location = glm::vec3(GINPUT::GetMouseLocation(), 0.0f);
+	ParentCat->ResetInterpolation();
 }
 
 bool CarriedAction::Update()
@@ -305,6 +312,8 @@ BounceAction::BounceAction(CCat* parentCat) :
 	Action(parentCat)
 {
 	OldVelocity = glm::vec2();
+	SlidingLeft = parentCat->GetAnimationLibrary()->GetHandle("Sliding Left");
+	SlidingRight = parentCat->GetAnimationLibrary()->GetHandle("Sliding Right");
 }
 
 BounceAction::~BounceAction()
@@ -340,12 +349,12 @@ bool BounceAction::Update()
 	// Cat starts sliding once there is no more bouncing
 	if (ParentCat->Velocity.y == 0 && OldVelocity.y == 0)
 	{
-		std::string current = ParentCat->GetAnimationIndex();
-		std::string sliding = "Sliding " + (std::string)(ParentCat->Velocity.x > 0.0f ? "Left" : "Right");
-		bool isSliding = current.rfind("Sliding", 0) == 0;
+		AnimationHandle current = ParentCat->GetAnimationHandle();
+		AnimationHandle sliding = ParentCat->Velocity.x > 0.0f ? SlidingLeft : SlidingRight;
+		bool isSliding = current == SlidingLeft || current == SlidingRight;
 		bool isFastEnough = std::abs(ParentCat->Velocity.x) > 50.0f;
 
-		ParentCat->SetAnimationIndex(isSliding ? (isFastEnough ? sliding : current) : sliding);
+		if (!isSliding || isFastEnough) { ParentCat->SetAnimation(sliding); }
 
 		// Clear transforms
 		ParentCat->RotationZ = 0;
@@ -376,7 +385,7 @@ WaitAction::WaitAction(CCat* parentCat, std::function<bool()> function) :
 
 void WaitAction::Start()
 {
-	StartTime = std::chrono::steady_clock::now();
+	StartTime = TIMER::GetTotalSeconds();
 }
 
 bool WaitAction::Update()
@@ -387,22 +396,27 @@ bool WaitAction::Update()
 	}
 	else
 	{
-		std::chrono::duration<float> tempTotalSec = std::chrono::steady_clock::now() - StartTime;
-		float duration = tempTotalSec.count();
+		float duration = (float)(TIMER::GetTotalSeconds() - StartTime);
 		return duration >= Seconds;
 	}
 }
 
 PlayAnimationAction::PlayAnimationAction(CCat* parentCat, std::string animationID) :
+	PlayAnimationAction(parentCat, parentCat->GetAnimationLibrary()->GetHandle(animationID))
+{
+}
+
+PlayAnimationAction::PlayAnimationAction(CCat* parentCat, AnimationHandle animation) :
 	Action(parentCat)
 {
-	IsFinished = parentCat->GetAnimation(animationID).AnimationType == EAnimationType::Loop;
-	AnimationID = animationID;
+	// Looping animations never end so finish straight away
+	IsFinished = animation == NO_ANIMATION || parentCat->GetAnimationLibrary()->GetAnimation(animation).AnimationType == EAnimationType::Loop;
+	Animation = animation;
 }
 
 void PlayAnimationAction::Start()
 {
-	ParentCat->SetAnimationIndex(AnimationID);
+	ParentCat->SetAnimation(Animation);
 }
 
 bool PlayAnimationAction::Update()
@@ -425,10 +439,9 @@ void SittingAction::Start()
 
 void SittingAction::QueueSittingActions(CCat* parentCat, float seconds)
 {
-	// Pregenerate the random device and get the idle animations
-	std::vector<std::pair<std::string, float>> idleAnimations = parentCat->GetIdleAnimations();
-	auto rd = std::random_device{};
-	auto rng = std::default_random_engine{ rd() };
+	// Get the cat's random numbers and the idle animations
+	std::vector<std::pair<AnimationHandle, float>> idleAnimations = parentCat->GetIdleAnimations();
+	CRandom& rng = parentCat->GetRandom();
 
 	float leftOverTime = seconds;
 
@@ -436,7 +449,7 @@ void SittingAction::QueueSittingActions(CCat* parentCat, float seconds)
 	while (leftOverTime > 0.001f)
 	{
 		// Generate a time to hold the neutral pose
-		float waitTime = std::min(leftOverTime, HELPER::Random(5.0f, 10.0f));
+		float waitTime = std::min(leftOverTime, rng.Range(5.0f, 10.0f));
 		leftOverTime -= waitTime;
 
 		// Queue on a sitting/wait animation
@@ -449,7 +462,7 @@ void SittingAction::QueueSittingActions(CCat* parentCat, float seconds)
 			std::shuffle(std::begin(idleAnimations), std::end(idleAnimations), rng);
 
 			// Loop through and find an animation that fits within the remaining time
-			for (std::pair<std::string, float> animation : idleAnimations)
+			for (const std::pair<AnimationHandle, float>& animation : idleAnimations)
 			{
 				if (animation.second <= leftOverTime)
 				{
@@ -479,6 +492,8 @@ WalkToWindowAction::WalkToWindowAction(CCat* parentCat, HWND targetWindow) :
 	WM(CWindowsManager::GetInstance())
 {
 	TargetWindow = targetWindow;
+	WalkingLeft = parentCat->GetAnimationLibrary()->GetHandle("Walking Left");
+	WalkingRight = parentCat->GetAnimationLibrary()->GetHandle("Walking Right");
 }
 
 WalkToWindowAction::~WalkToWindowAction()
@@ -543,14 +558,13 @@ bool WalkToWindowAction::Update()
 
 		// Get current and target directions
 		DIRECTION walkDirection = targetX >= ParentCat->Location.x ? DIRECTION::RIGHT : DIRECTION::LEFT;
-		std::string targetAnimationID = (walkDirection == DIRECTION::LEFT ? "Walking Left" : "Walking Right");
-		std::string currentAnimationID = ParentCat->GetAnimationIndex();
+		AnimationHandle targetAnimation = (walkDirection == DIRECTION::LEFT ? WalkingLeft : WalkingRight);
 
 		// Only update direction if required
-		if (targetAnimationID != currentAnimationID)
+		if (targetAnimation != ParentCat->GetAnimationHandle())
 		{
 			ParentCat->Velocity.x = (float)walkDirection * ParentCat->WalkSpeed;
-			ParentCat->SetAnimationIndex(targetAnimationID);
+			ParentCat->SetAnimation(targetAnimation);
 		}
 
 
@@ -1,9 +1,10 @@
 #pragma once
 #include <functional>
 #include <windows.h>
-#include <chrono>
 #include <glm.hpp>
 
+#include "animationLibrary.h"
+
 class CCat;
 class CWindowsManager;
 class CMonitorManager;
@@ -39,13 +40,14 @@ struct PlayAnimationAction :
 {
 public:
 	PlayAnimationAction(CCat* parentCat, std::string animationID);
+	PlayAnimationAction(CCat* parentCat, AnimationHandle animation);
 
 	void Start() override;
 	bool Update() override;
 	void OnAnimationEnd() override;
 
 private:
-	std::string AnimationID;
+	AnimationHandle Animation;
 	bool IsFinished;
 };
 
@@ -62,6 +64,9 @@ public:
 private:
 	HWND TargetWindow;
 	CWindowsManager& WM;
+
+	AnimationHandle WalkingLeft;
+	AnimationHandle WalkingRight;
 };
 
 struct WalkTargetAction :
@@ -92,7 +97,7 @@ public:
 private:
 	DIRECTION WalkDirection;
 	float Seconds;
-	std::chrono::steady_clock::time_point StartTime;
+	double StartTime; // Simulation seconds the action started at
 };
 
 struct WaitAction :
@@ -107,7 +112,7 @@ public:
 
 private:
 	float Seconds;
-	std::chrono::steady_clock::time_point StartTime;
+	double StartTime; // Simulation seconds the action started at
 	std::function<bool()> Function;
 };
 
@@ -133,7 +138,7 @@ public:
 
 private:
 	float Seconds;
-	std::chrono::steady_clock::time_point StartTime;
+	double StartTime; // Simulation seconds the action started at
 };
 
 struct CarriedAction :
@@ -169,6 +174,9 @@ public:
 
 private:
 	glm::vec2 OldVelocity;
+
+	AnimationHandle SlidingLeft;
+	AnimationHandle SlidingRight;
 };
 
 struct FallingAction :
@@ -0,0 +1,295 @@
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <thread>
+#include <algorithm>
+
+#include "batchRunner.h"
+#include "helper.h"
+#include "animationLibrary.h"
+
+#define BATCH_TIME_SCALE "600" // Ten simulated minutes a second unless the sweep says otherwise
+#define BATCH_RUN_SECONDS "3600"
+#define BATCH_POLL_MILLISECONDS 50
+
+/*
+	Quotes a value for the CSV if it would break the columns
+*/
+static std::string CSVField(const std::string& value)
+{
+	IfThenReturn(value.find_first_of(",\"\n") == std::string::npos, value);
+
+	std::string quoted = "\"";
+	for (char c : value) { quoted += (c == '"') ? "\"\"" : std::string(1, c); }
+	return quoted + "\"";
+}
+
+CBatchRunner::CBatchRunner(std::string sweepFilename)
+{
+	SweepFilename = sweepFilename;
+	OutputFilename = "BatchResults.csv";
+	BatchFolder = "Batch\\";
+	ProcessCount = 0;
+	RunsPerSetting = 1;
+}
+
+/*
+	Runs every combination in the sweep file, as many at once as there are processors, then writes the results
+
+	@return 0 if the batch ran, 1 if the sweep file couldn't be loaded
+*/
+int CBatchRunner::Run()
+{
+	IfThenReturn(!LoadSweep(), 1);
+	GenerateRuns();
+
+	// Every run shares the resources folder, compile the animations here so the runs only ever load them
+	CAnimationLibrary::CompileLibraries();
+
+	char executable[MAX_PATH] = { };
+	GetModuleFileNameA(NULL, executable, MAX_PATH);
+
+	std::cout << "Batch: " << Runs.size() << " runs, " << ProcessCount << " at a time" << std::endl;
+
+	int next = 0;
+	int running = 0;
+	int finished = 0;
+
+	while (finished < (int)Runs.size())
+	{
+		// Keep every process slot busy
+		while (running < ProcessCount && next < (int)Runs.size())
+		{
+			SRun& run = Runs[next++];
+
+			if (WriteRunFiles(run) && StartRun(run, executable))
+			{
+				running++;
+			}
+			else
+			{
+				run.Finished = true;
+				finished++;
+			}
+		}
+
+		for (SRun& run : Runs)
+		{
+			if (run.Started && !run.Finished && WaitForSingleObject(run.Process.hProcess, 0) == WAIT_OBJECT_0)
+			{
+				GetExitCodeProcess(run.Process.hProcess, &run.ExitCode);
+				CloseHandle(run.Process.hProcess);
+				CloseHandle(run.Process.hThread);
+
+				run.Finished = true;
+				running--;
+				finished++;
+
+				std::cout << "Batch: " << finished << "/" << Runs.size() << " finished" << std::endl;
+			}
+		}
+
+		Sleep(BATCH_POLL_MILLISECONDS);
+	}
+
+	WriteResults();
+	return 0;
+}
+
+bool CBatchRunner::LoadSweep()
+{
+	std::ifstream file(SweepFilename);
+
+	if (!file.is_open())
+	{
+		std::cout << "WARNING: Unable to open sweep file " << SweepFilename << std::endl;
+		return false;
+	}
+
+	std::string processes = "auto";
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		line = HELPER::Trim(line);
+		size_t split = line.find(':');
+		IfThenStatement(line.empty() || line[0] == '#' || split == std::string::npos, continue);
+
+		std::string name = HELPER::Trim(line.substr(0, split));
+		std::string value = HELPER::Trim(line.substr(split + 1));
+
+		if (name == "output") { OutputFilename = value; }
+		else if (name == "batch-folder") { BatchFolder = value.back() == '\\' ? value : value + '\\'; }
+		else if (name == "processes") { processes = value; }
+		else if (name == "runs-per-setting") { RunsPerSetting = std::max(1, std::atoi(value.c_str())); }
+		else
+		{
+			std::vector<std::string> values;
+			HELPER::SplitString(value, values, ',');
+			for (std::string& v : values) { v = HELPER::Trim(v); }
+
+			IfThenStatement(values.empty(), values.push_back(""));
+			IfThenStatement(values.size() > 1, SweptSettings.push_back(name));
+			Settings.push_back({ name, values });
+		}
+	}
+
+	int hardwareThreads = std::max(1, (int)std::thread::hardware_concurrency());
+	ProcessCount = (processes != "" && std::all_of(processes.begin(), processes.end(), ::isdigit)) ? std::max(1, std::stoi(processes)) : hardwareThreads;
+
+	return true;
+}
+
+/*
+	Expands the swept settings into one run per combination, repeated for runs-per-setting
+*/
+void CBatchRunner::GenerateRuns()
+{
+	std::vector<int> choice(Settings.size(), 0);
+	bool done = false;
+
+	while (!done)
+	{
+		for (int repeat = 0; repeat < RunsPerSetting; ++repeat)
+		{
+			SRun run = { (int)Runs.size(), { }, { }, false, false, 0 };
+
+			for (int i = 0; i < (int)Settings.size(); ++i)
+			{
+				run.Settings[Settings[i].first] = Settings[i].second[choice[i]];
+			}
+
+			// Runs are unseen and fast unless the sweep says otherwise, one worker each since every core has a run
+			run.Settings.insert({ "random-seed", std::to_string(run.Index + 1) });
+			run.Settings.insert({ "time-scale", BATCH_TIME_SCALE });
+			run.Settings.insert({ "run-seconds", BATCH_RUN_SECONDS });
+			run.Settings.insert({ "window", "hidden" });
+			run.Settings.insert({ "worker-threads", "1" });
+			run.Settings.insert({ "cat-count", "1" });
+
+			Runs.push_back(run);
+		}
+
+		// Move on to the next combination, the last setting changes fastest
+		done = true;
+
+		for (int i = (int)Settings.size() - 1; i >= 0; --i)
+		{
+			if (++choice[i] < (int)Settings[i].second.size())
+			{
+				done = false;
+				break;
+			}
+
+			choice[i] = 0;
+		}
+	}
+}
+
+std::string CBatchRunner::GetRunFolder(const SRun& run)
+{
+	return BatchFolder + "run-" + std::to_string(run.Index) + "\\";
+}
+
+/*
+	Gives the run a clean folder with its Configs.txt and cat files
+*/
+bool CBatchRunner::WriteRunFiles(SRun& run)
+{
+	std::string folder = GetRunFolder(run);
+	std::error_code error;
+
+	std::filesystem::remove_all(folder, error);
+	std::filesystem::create_directories(folder + "Cats", error);
+
+	std::ofstream configs(folder + "Configs.txt", std::ofstream::trunc);
+
+	if (!configs.is_open())
+	{
+		std::cout << "WARNING: Unable to write the configs for run " << run.Index << std::endl;
+		return false;
+	}
+
+	std::string catSettings;
+
+	for (auto& setting : run.Settings)
+	{
+		const std::string& name = setting.first;
+
+		if (name._Starts_with("cat-") && name != "cat-count" && name != "cat-folder")
+		{
+			catSettings += name.substr(4) + ": " + setting.second + "\n";
+		}
+		else if (name != "cat-count" && name != "cat-folder" && name != "metrics-file")
+		{
+			configs << name << ": " << setting.second << "\n";
+		}
+	}
+
+	configs << "cat-folder: " << folder << "Cats\\\n";
+	configs << "metrics-file: " << folder << "Metrics.csv\n";
+
+	int catCount = std::max(1, std::atoi(run.Settings["cat-count"].c_str()));
+
+	for (int i = 1; i <= catCount; ++i)
+	{
+		std::ofstream cat(folder + "Cats\\Cat-" + std::to_string(i) + ".txt", std::ofstream::trunc);
+		cat << catSettings;
+	}
+
+	return true;
+}
+
+bool CBatchRunner::StartRun(SRun& run, const std::string& executable)
+{
+	std::string commandLine = "\"" + executable + "\" " + GetRunFolder(run) + "Configs";
+
+	STARTUPINFOA startupInfo = { };
+	startupInfo.cb = sizeof(startupInfo);
+
+	run.Started = CreateProcessA(NULL, &commandLine[0], NULL, NULL, FALSE, 0, NULL, NULL, &startupInfo, &run.Process) != 0;
+	IfThenStatement(!run.Started, std::cout << "WARNING: Unable to start run " << run.Index << std::endl);
+
+	return run.Started;
+}
+
+/*
+	Gathers every run's metrics into the output CSV, one row per run with the settings that were swept
+*/
+void CBatchRunner::WriteResults()
+{
+	std::ofstream output(OutputFilename, std::ofstream::trunc);
+
+	if (!output.is_open())
+	{
+		std::cout << "WARNING: Unable to write batch results to " << OutputFilename << std::endl;
+		return;
+	}
+
+	std::string metricsHeader;
+	std::vector<std::string> metrics(Runs.size());
+
+	for (SRun& run : Runs)
+	{
+		std::ifstream file(GetRunFolder(run) + "Metrics.csv");
+		std::string header;
+
+		IfThenStatement(std::getline(file, header) && std::getline(file, metrics[run.Index]) && metricsHeader == "", metricsHeader = header);
+	}
+
+	output << "run,random-seed";
+	for (const std::string& name : SweptSettings) { IfThenStatement(name != "random-seed", output << "," << CSVField(name)); }
+	output << ",status" << (metricsHeader != "" ? "," + metricsHeader : "") << "\n";
+
+	for (SRun& run : Runs)
+	{
+		output << run.Index << "," << CSVField(run.Settings["random-seed"]);
+		for (const std::string& name : SweptSettings) { IfThenStatement(name != "random-seed", output << "," << CSVField(run.Settings[name])); }
+
+		// A run without metrics never reached its end, it crashed or every cat was closed
+		std::string status = metrics[run.Index] != "" ? "ok" : (run.Started ? "failed (exit code " + std::to_string(run.ExitCode) + ")" : "not started");
+		output << "," << CSVField(status) << (metrics[run.Index] != "" ? "," + metrics[run.Index] : "") << "\n";
+	}
+
+	std::cout << "Batch: results written to " << OutputFilename << std::endl;
+}
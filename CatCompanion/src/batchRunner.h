@@ -0,0 +1,52 @@
+#pragma once
+#include <Windows.h>
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+	Runs many cat simulations at once to compare settings. The cats share global state with the rest of
+	the program, so each run is its own copy of the program with a hidden window, its own configs and
+	its own cat folder, running at a high time scale. The runs' metrics are gathered into one CSV.
+
+	The sweep file uses the configs format, a setting given several comma separated values is swept and
+	every combination is run. Settings starting with "cat-" go into the cat files, "cat-count" sets how
+	many cats there are and everything else goes into the run's Configs.txt (replay, time-scale, run-seconds...).
+	"output", "processes", "runs-per-setting" and "batch-folder" control the batch itself
+*/
+class CBatchRunner
+{
+public:
+	CBatchRunner(std::string sweepFilename);
+
+	int Run(); // Returns the exit code for the program
+
+private:
+	struct SRun
+	{
+		int Index;
+		std::map<std::string, std::string> Settings;
+		PROCESS_INFORMATION Process;
+		bool Started;
+		bool Finished;
+		DWORD ExitCode;
+	};
+
+	std::string SweepFilename;
+	std::string OutputFilename;
+	std::string BatchFolder;
+	int ProcessCount;
+	int RunsPerSetting;
+
+	std::vector<std::pair<std::string, std::vector<std::string>>> Settings; // In the order they're in the sweep file
+	std::vector<std::string> SweptSettings; // Settings with more than one value, these become columns
+	std::vector<SRun> Runs;
+
+	bool LoadSweep();
+	void GenerateRuns();
+	bool WriteRunFiles(SRun& run);
+	bool StartRun(SRun& run, const std::string& executable);
+	void WriteResults();
+
+	std::string GetRunFolder(const SRun& run);
+};
@@ -14,6 +14,7 @@
 #include "graphics.h"
 #include "mesh.h"
 #include "program.h"
+#include "profiler.h"
 
 #include "scene.h"
 #include "actions.h"
@@ -25,8 +26,16 @@
 #include "catHelper.h"
 #include "texturedParticleLayer.h"
 #include "catManager.h"
+#include "iconPipeline.h"
+#include "renderStats.h"
+#include "frameArena.h"
+
+#define MAX_STEP_DISTANCE 8.0f // Pixels a cat moves before its movement is split up, half the height of an unscaled cat
+#define MAX_SUB_STEPS 32
 
 bool CCat::HasLoadedHues = false;
+unsigned long long CCat::NextRandomStream = 0;
+std::vector<std::pair<AnimationHandle, float>> CCat::IdleAnimations;
 
 CCat::CCat(CCatManager* parent, CConfigs* configs, glm::vec2 location) :
 	MM(CMonitorManager::GetInstance()),
@@ -36,6 +45,7 @@ CCat::CCat(CCatManager* parent, CConfigs* configs, glm::vec2 location) :
 {
 	ParentManager = parent;
 	Configs = configs;
+	Random.Seed(HELPER::GetRandomSeed(), NextRandomStream++);
 
 	// Update default colours
 	std::fill(std::begin(Colours), std::end(Colours), glm::vec3());
@@ -79,6 +89,7 @@ CCat::CCat(CCatManager* parent, CConfigs* configs, glm::vec2 location) :
 	float scale = Configs->GetFloatVariable("scale");
 
 	Offset = glm::vec3();
+	BuiltOffset = Offset;
 	Location = glm::vec3(location, 0.0f);
 	Scale = glm::vec3(scale, scale, 1.0f);
 	Acceleration = glm::vec2(0.0f, 5000.0f);
@@ -91,6 +102,8 @@ CCat::CCat(CCatManager* parent, CConfigs* configs, glm::vec2 location) :
 	CurrentState = CatState::Sitting;
 
 	IconObject = nullptr;
+	IconTexture = 0;
+	IconHash = 0;
 	Parent = parent->Parent;
 
 	TexturedParticleType heartParticles;
@@ -105,8 +118,9 @@ CCat::CCat(CCatManager* parent, CConfigs* configs, glm::vec2 location) :
 	Parent->ParticlesLayer->AddParticleType("Hearts", heartParticles);
 
 	IsSpawningHearts = false;
+	HeartAlarm = NO_ALARM;
 
-	SittingAction::QueueSittingActions(this, HELPER::Random(2.0f, 5.0f));
+	SittingAction::QueueSittingActions(this, Random.Range(2.0f, 5.0f));
 }
 
 CCat::~CCat()
@@ -116,6 +130,7 @@ CCat::~CCat()
 
 	if (IconObject != nullptr)
 	{
+		ParentManager->GetIconPipeline().Release(IconHash);
 		delete IconObject;
 		IconObject = nullptr;
 	}
@@ -123,17 +138,32 @@ CCat::~CCat()
 	ClearActions();
 }
 
+/*
+	Update the parts of the cat that only depend on itself, this is run across the job system alongside
+	the other layers. Nothing else reads the colours during the update so when they change doesn't matter
+*/
+void CCat::UpdateParallel()
+{
+	{ PROFILE_SCOPE("CCat::UpdateColours"); UpdateColours(); }
+}
+
+/*
+	A step of the cat runs in three parts so the physics of every cat can be run across the job system:
+	Update, then UpdatePhysics, then UpdateLate. Physics still runs after the actions have set the velocity
+	for the step and before the icon and sprite are moved on, the same order as one serial update
+*/
 void CCat::Update()
 {
-	OldLoc = Location;
+	{ PROFILE_SCOPE("CCat::UpdateMouseEvents"); UpdateMouseEvents(); }
+	{ PROFILE_SCOPE("CCat::ProcessActions"); ProcessActions(); }
+}
 
-	UpdateColours();
-	UpdateMouseEvents();
-	ProcessActions();
-	UpdatePhysics();
-	UpdateIcon();
+void CCat::UpdateLate()
+{
+	{ PROFILE_SCOPE("CCat::UpdateIcon"); UpdateIcon(); }
+	{ PROFILE_SCOPE("CSprite::Update"); CSprite::Update(); }
 
-	CSprite::Update();
+	IfThenStatement(CurrentState == CatState::Sleeping, Metrics.SecondsAsleep += TIMER::GetDeltaSeconds());
 }
 
 void CCat::Draw(glm::mat4& pv)
@@ -148,51 +178,50 @@ void CCat::Draw(glm::mat4& pv)
 	if (NameAlpha > 0.0f && Name != "")
 	{
 		//glm::ivec2 location = glm::ivec2(Location.x - NameDimensions.x * 0.5f, Location.y - GetImageHeight() * CScene::TileScaler - 25.0f);
-		glm::ivec2 location = glm::ivec2(Location.x - NameDimensions.x * 0.5f, Location.y - 28.0f * Scale.x);
+		glm::vec3 renderLocation = GetRenderLocation();
+		glm::ivec2 location = glm::ivec2(renderLocation.x - NameDimensions.x * 0.5f, renderLocation.y - 28.0f * Scale.x);
 		GFX::DrawString(pv, NameFont, Name, location, glm::vec4(1.0f, 1.0f, 1.0f, NameAlpha));
 	}
 }
 
-void CCat::OnFileDropped(HICON icon)
+bool CCat::CanEatIcon()
 {
-	if ((CurrentState == CatState::Sitting ||
-		 CurrentState == CatState::Sleeping ||
-		 CurrentState == CatState::Walking) &&
-		CurrentState != CatState::IconEating &&
-		CurrentState != CatState::IconProcessing &&
-		CurrentState != CatState::IconExpanding &&
-		CurrentState != CatState::IconFalling &&
-		IconObject == nullptr)
-	{
-		IconTexture = HiconToTexture(icon);
-		std::vector<int> hues;
-		HELPER::GetTopHues(icon, hues);
+	return (CurrentState == CatState::Sitting ||
+			CurrentState == CatState::Sleeping ||
+			CurrentState == CatState::Walking) &&
+		   IconObject == nullptr;
+}
 
-		for (int i = 0; i < hues.size(); ++i)
-		{
-			HELPER::PrintToOutput(std::to_string(i) + ":" + std::to_string(hues[i]) + ", ");
-		}
+/*
+	Starts eating an icon the icon pipeline has got ready
 
-		IconObject = new CObject(CProgram::GetProgram("Texture"), CMesh::GetMesh("2D Square"));
-		IconObject->UpdateUniformTexture("tex", IconTexture);
+	@param texture The icon's texture, owned by the pipeline
+	@param iconHash The icon's key in the pipeline, used to hand the texture back
+*/
+void CCat::EatIcon(GLuint texture, unsigned long long iconHash)
+{
+	IconTexture = texture;
+	IconHash = iconHash;
 
-		IconObject->Scale *= 1.0f;
-		IconObject->Scale.y *= -1.0f;
-		IconObject->Location = Location;
-		IconObject->Pivot = glm::vec3(0.5f, 0.5f, 0.0f);
+	IconObject = new CObject(CProgram::GetProgram("Texture"), CMesh::GetMesh("2D Square"));
+	IconObject->UpdateUniformTexture("tex", IconTexture);
 
-		IconVelocity = glm::vec3(0.0f, -375.0f, 0.0f);
+	IconObject->Scale *= 1.0f;
+	IconObject->Scale.y *= -1.0f;
+	IconObject->Location = Location;
+	IconObject->Pivot = glm::vec3(0.5f, 0.5f, 0.0f);
 
-		CurrentState = CatState::IconExpanding;
+	IconVelocity = glm::vec3(0.0f, -375.0f, 0.0f);
 
-		ClearActions();
-		QueueAction(new PlayAnimationAction(this, "Idle"));
-		QueueAction(new WaitAction(this, 0.75f));
-		QueueAction(new FunctionAction([this]() { CurrentState = CatState::IconFalling; }));
-		QueueAction(new PlayAnimationAction(this, "Eating Icon"));
-		QueueAction(new FunctionAction([this]() { CurrentState = CatState::IconProcessing; }));
-		QueueAction(new WaitAction(this, 0.75f));
-	}
+	CurrentState = CatState::IconExpanding;
+
+	ClearActions();
+	QueueAction(new PlayAnimationAction(this, "Idle"));
+	QueueAction(new WaitAction(this, 0.75f));
+	QueueAction(new FunctionAction([this]() { CurrentState = CatState::IconFalling; }));
+	QueueAction(new PlayAnimationAction(this, "Eating Icon"));
+	QueueAction(new FunctionAction([this]() { CurrentState = CatState::IconProcessing; }));
+	QueueAction(new WaitAction(this, 0.75f));
 }
 
 
@@ -215,6 +244,7 @@ void CCat::OnRMBUp()
 	if (IsSpawningHearts)
 	{
 		IsSpawningHearts = false;
+		ALARM::Cancel(HeartAlarm);
 
 		HCURSOR normalCursor = LoadCursor(NULL, IDC_ARROW);
 		SetCursor(normalCursor);
@@ -228,6 +258,7 @@ void CCat::OnRMBHeld()
 	SetClassLongPtr(CScene::hWnd, GCLP_HCURSOR, reinterpret_cast<LONG_PTR>(PattingCursor));
 
 	IsSpawningHearts = true;
+	ALARM::Cancel(HeartAlarm); // Only ever one heart alarm running
 	SpawnHeart();
 }
 
@@ -241,11 +272,12 @@ void CCat::UpdateMouseEvents()
 {
 	if (CurrentState != CatState::Carried)
 	{
-		bool inBounds = IsInBounds(GINPUT::GetMouseLocation());
+		// Only the cat on top shows its name, the manager has already found it
+		bool inBounds = ParentManager->GetHoveredCat() == this;
 
 		if (inBounds)
 		{
-			FM.SetFocused();
+			FM.AddInteractiveRect(GetBoundsWind());
 
 			NameAlpha += NameAlphaRate * TIMER::GetDeltaSeconds();
 			NameAlpha = std::min(1.0f, NameAlpha);
@@ -311,12 +343,18 @@ void CCat::UpdateActions()
 {
 	if (CurrentState != CatState::Sitting)
 	{
-		SittingAction::QueueSittingActions(this, HELPER::Random(10.0f, 60.0f));
+		SittingAction::QueueSittingActions(this, Random.Range(10.0f, 60.0f));
 	}
 	else
 	{
+		// 10% chance to head over to the window under the mouse, however many jumps away it is
+		if (Random.Chance(10.0f) && TryRouteToMouse())
+		{
+			return;
+		}
+
 		// 70% chance to try jump to a window
-		if (HELPER::Random(0.0f, 100.0f) <= 70.0f && TryJumpToWindow())
+		if (Random.Chance(70.0f) && TryJumpToWindow())
 		{
 			// TryJumpToWindow adds it's actions so no need to continue
 			return;
@@ -328,7 +366,7 @@ void CCat::UpdateActions()
 		{
 			// Calculate a random target point
 			float halfWidth = GetBoundsWidth() * 0.5f;
-			float targetX = HELPER::Random(windowBounds.left + halfWidth, windowBounds.right - halfWidth);
+			float targetX = Random.Range(windowBounds.left + halfWidth, windowBounds.right - halfWidth);
 			float delta = targetX - Location.x;
 			float absolute = std::abs(delta);
 			float sign = HELPER::Sign(delta);
@@ -344,15 +382,15 @@ void CCat::UpdateActions()
 		else
 		{
 			// Walk in a random direction for 4-10 seconds
-			Actions.push(new WalkTimedAction(this, (DIRECTION)((rand() % 2) * 2 - 1), HELPER::Random(4.0f, 10.0f)));
+			Actions.push(new WalkTimedAction(this, (DIRECTION)(Random.Range(2) * 2 - 1), Random.Range(4.0f, 10.0f)));
 		}
 
 		// 10% chance to yawn and fall asleep for 5-10minutes after walking
-		if (HELPER::Random(0.0f, 100.0f) <= 10.0f)
+		if (Random.Chance(10.0f))
 		{
 			Actions.push(new FunctionAction([this]() { SetCurrentState(CatState::Sitting); }));
 			Actions.push(new PlayAnimationAction(this, "Idle Yawn"));
-			Actions.push(new SleepingAction(this, HELPER::Random(300.0f, 600.0f)));
+			Actions.push(new SleepingAction(this, Random.Range(300.0f, 600.0f)));
 			Actions.push(new PlayAnimationAction(this, "Idle Yawn"));
 		}
 	}
@@ -369,16 +407,32 @@ void CCat::UpdatePhysics()
 	}
 	else
 	{
-		Location += glm::vec3(Velocity * TIMER::GetDeltaSeconds(), 0.0f);
+		// Fast cats move in several smaller steps so they can't skip past a monitor edge in one go
+		glm::vec2 distance = glm::abs(Velocity * TIMER::GetDeltaSeconds());
+		int steps = std::clamp((int)std::ceil(std::max(distance.x, distance.y) / MAX_STEP_DISTANCE), 1, MAX_SUB_STEPS);
+		float stepSeconds = TIMER::GetDeltaSeconds() / steps;
 
-		glm::vec3 oldLocation = Location;
-		WindowCollision();
-		ConfineToMonitors();
+		for (int i = 0; i < steps; ++i)
+		{
+			glm::vec3 from = Location;
+			Location += glm::vec3(Velocity * stepSeconds, 0.0f);
 
-		glm::vec3 locA = HELPER::RoundToPlaces(Location, 1);
-		glm::vec3 locB = HELPER::RoundToPlaces(oldLocation, 1);
+			glm::vec3 sweptLocation = Location;
+			WindowCollision(from);
 
-		Velocity *= glm::vec2(1.0f - glm::abs(glm::sign(locA - locB)));
+			// Windows only ever stop the fall, landing part way through the step moves the cat back along x as well
+			IfThenStatement(HELPER::RoundToPlaces(Location, 1).y != HELPER::RoundToPlaces(sweptLocation, 1).y, Velocity.y = 0.0f);
+
+			sweptLocation = Location;
+			ConfineToMonitors();
+
+			glm::vec3 locA = HELPER::RoundToPlaces(Location, 1);
+			glm::vec3 locB = HELPER::RoundToPlaces(sweptLocation, 1);
+
+			// Stop moving along any axis the monitor edges pushed the cat back on
+			Velocity *= glm::vec2(1.0f - glm::abs(glm::sign(locA - locB)));
+			IfThenStatement(Velocity == glm::vec2(), break);
+		}
 
 		if (Velocity.y == 0.0f && CurrentState != CatState::Walking)
 		{
@@ -389,12 +443,15 @@ void CCat::UpdatePhysics()
 
 void CCat::ConfineToMonitors()
 {
+	PROFILE_SCOPE("CCat::ConfineToMonitors");
+
 	// Offset to the top left and right position
 	const glm::vec2 topLeftOffset = glm::vec2(GetBoundsWidth() * 0.5f, GetBoundsHeight());
 	const glm::vec2 topRightOffset = glm::vec2(-GetBoundsWidth() * 0.5f, 0.0f);
 
-	// All monitors
-	std::vector<HMONITOR> monitors = MM.GetMonitors();
+	// All monitors, taken once so they can't change part way through
+	const SMonitorTopology& topology = MM.GetTopology();
+	const std::vector<HMONITOR>& monitors = topology.Monitors;
 
 	// Used to find the shortest distance to move
 	float length = (float)INT_MAX;
@@ -404,7 +461,8 @@ void CCat::ConfineToMonitors()
 	glm::vec2 oldLocation = MM.WindowToDesktop(glm::vec2(Location));
 
 	// Collection of intersections with the monitors
-	std::vector<RECT> intersections;
+	FrameVector<RECT> intersections;
+	intersections.reserve(monitors.size());
 
 	// Get player boundry
 	RECT bounds = GetBoundsDesk();
@@ -418,7 +476,7 @@ void CCat::ConfineToMonitors()
 	{
 		// Retrieve the data of the current monitor
 		int monitor = (int)monitors[i];
-		MonitorInfo& info = MM.GetMonitorDetail(monitor);
+		const MonitorInfo& info = topology.GetDetail(monitor);
 
 		// Get the intersection rectangle between the monitor and the cat
 		RECT tempIntersection;
@@ -612,12 +670,19 @@ void CCat::ConfineToMonitors()
 	}
 }
 
-void CCat::WindowCollision()
+/*
+	Lands the cat on the first platform its feet crossed while moving from a location to where it is now,
+	the crossing point is found along the whole move so a fast cat can't pass through a platform
+
+	@param from Where the cat moved from
+*/
+void CCat::WindowCollision(glm::vec3 from)
 {
 	float halfPlayerWidth = GetBoundsWidth() * 0.5f;
-	float playerHeight = GetBoundsHeight();
 
 	HWND newWind = NULL;
+	glm::vec3 to = Location;
+	float firstCrossing = 2.0f; // Fraction of the move at which the feet reach the platform that is landed on
 
 	// Only collide with windows if the cat is traveling downwards
 	if (Velocity.y > 0)
@@ -630,28 +695,29 @@ void CCat::WindowCollision()
 		{
 			if (p.Hwnd == CurrentWindow)
 			{
-				if (Location.x + halfPlayerWidth > p.Left && Location.x - halfPlayerWidth < p.Right && // Within line segment
-					Location.y >= p.Height)  // Let the player drop if the window moves down
+				// Any of the window's segments can be the one under the cat, so the others don't knock it off
+				if (to.x + halfPlayerWidth > p.Left && to.x - halfPlayerWidth < p.Right && // Within line segment
+					to.y >= p.Height)  // Let the player drop if the window moves down
 				{
+					// Staying on the window comes before landing on anything else
+					firstCrossing = 0.0f;
 					newWind = CurrentWindow;
-					Location.y = p.Height;
-				}
-				else
-				{
-					CurrentWindow = NULL;
+					Location = glm::vec3(to.x, p.Height, Location.z);
 				}
 			}
-			else
+			else if (from.y <= p.Height && to.y > p.Height) // Check if player has tried to travel through the window
 			{
-				if (OldLoc.y <= p.Height && Location.y > p.Height) // Check if player has tried to travel through the window
+				// Where the cat was when its feet reached the height of the platform
+				float crossing = (p.Height - from.y) / (to.y - from.y);
+				float crossingX = from.x + (to.x - from.x) * crossing;
+
+				if (crossing < firstCrossing && crossingX + halfPlayerWidth > p.Left && crossingX - halfPlayerWidth < p.Right) // Within line segment
 				{
-					if (Location.x + halfPlayerWidth > p.Left && Location.x - halfPlayerWidth < p.Right) // Within line segment
-					{
-						// Lock to the top of the window
-						Location.y = p.Height;
-						Velocity.y = 0.0f;
-						newWind = p.Hwnd;
-					}
+					// Lock to the top of the window
+					firstCrossing = crossing;
+					Location = glm::vec3(crossingX, p.Height, Location.z);
+					Velocity.y = 0.0f;
+					newWind = p.Hwnd;
 				}
 			}
 		}
@@ -694,7 +760,7 @@ void CCat::UpdateIcon()
 
 			default:
 			{
-				glDeleteTextures(1, &IconTexture);
+				ParentManager->GetIconPipeline().Release(IconHash);
 				IconTexture = 0;
 
 				delete IconObject;
@@ -717,15 +783,51 @@ float CCat::GetBoundsHeight()
 	return 16.0f * Scale.x;
 }
 
-bool CCat::IsInBounds(glm::vec2 location)
+void CCat::GetBounds(glm::vec2& topLeft, glm::vec2& botRight)
 {
 	float width = GetBoundsWidth();
 	float height = GetBoundsHeight();
 
-	glm::vec2 loc = glm::vec2(Location.x - width * 0.5f, Location.y - height);
-	glm::vec2 size = glm::vec2(width, height);
+	topLeft = glm::vec2(Location.x - width * 0.5f, Location.y - height);
+	botRight = topLeft + glm::vec2(width, height);
+}
+
+/*
+	Finds the area the cat's sprite covers where it will be drawn this frame
+
+	@param bounds Set to the area in cat window coordinates
+	@return False if the cat is also drawing its name or an icon, which can reach outside the sprite
+*/
+bool CCat::GetDrawBounds(RECT& bounds)
+{
+	IfThenReturn(NameAlpha > 0.0f || IconObject != nullptr, false);
+
+	// The sprite is a unit square put in place by the model matrix, moved to where it's drawn between steps
+	glm::mat4& model = GetModelMatrix();
+	glm::vec2 renderOffset = glm::vec2(GetRenderLocation() - Location);
+	glm::vec2 corners[4] = { glm::vec2(0.0f, 0.0f), glm::vec2(1.0f, 0.0f), glm::vec2(0.0f, 1.0f), glm::vec2(1.0f, 1.0f) };
+
+	glm::vec2 topLeft = glm::vec2(INT_MAX);
+	glm::vec2 botRight = glm::vec2(INT_MIN);
+
+	for (glm::vec2 corner : corners)
+	{
+		glm::vec2 point = glm::vec2(model * glm::vec4(corner, 0.0f, 1.0f)) + renderOffset;
+		topLeft = glm::min(topLeft, point);
+		botRight = glm::max(botRight, point);
+	}
 
-	return HELPER::InBounds(location, loc, loc + size);
+	bounds = RECT{ (LONG)std::floor(topLeft.x), (LONG)std::floor(topLeft.y), (LONG)std::ceil(botRight.x), (LONG)std::ceil(botRight.y) };
+	return true;
+}
+
+bool CCat::IsInBounds(glm::vec2 location)
+{
+	glm::vec2 topLeft;
+	glm::vec2 botRight;
+	GetBounds(topLeft, botRight);
+
+	return HELPER::InBounds(location, topLeft, botRight);
 }
 
 int CCat::GetNumberOfColours()
@@ -754,9 +856,14 @@ void CCat::SetName(std::string name)
 	NameDimensions = NameFont->TextBounds(Name, 1.0f);
 }
 
-void CCat::SetListIterator(std::list<CCat*>::iterator listIt)
+void CCat::SetHandle(CatHandle handle)
 {
-	ListIt = listIt;
+	Handle = handle;
+}
+
+CatHandle CCat::GetHandle()
+{
+	return Handle;
 }
 
 std::string CCat::GetName()
@@ -771,11 +878,13 @@ std::string CCat::GetName()
 /// <returns>true if the location is valid</returns>
 bool CCat::IsLocationValid(glm::vec3 location)
 {
-	// All monitors
-	std::vector<HMONITOR> monitors = MM.GetMonitors();
+	// All monitors, taken once so they can't change part way through
+	const SMonitorTopology& topology = MM.GetTopology();
+	const std::vector<HMONITOR>& monitors = topology.Monitors;
 
 	// List of all the intersections with the monitors
-	std::vector<RECT> intersections;
+	FrameVector<RECT> intersections;
+	intersections.reserve(monitors.size());
 	bool isInMonitor = false;
 
 	// Get player boundry
@@ -793,7 +902,7 @@ bool CCat::IsLocationValid(glm::vec3 location)
 	{
 		// Retrieve the data of the current monitor
 		int monitor = (int)monitors[i];
-		MonitorInfo& info = MM.GetMonitorDetail(monitor);
+		const MonitorInfo& info = topology.GetDetail(monitor);
 
 		// Get the intersection rectangle between the monitor and the cat
 		RECT tempIntersection;
@@ -949,6 +1058,23 @@ void CCat::QueueAction(Action* newAction)
 	Actions.push(newAction);
 }
 
+CRandom& CCat::GetRandom()
+{
+	return Random;
+}
+
+SCatMetrics& CCat::GetMetrics()
+{
+	return Metrics;
+}
+
+void SCatMetrics::Add(const SCatMetrics& other)
+{
+	JumpsAttempted += other.JumpsAttempted;
+	JumpsSucceeded += other.JumpsSucceeded;
+	SecondsAsleep += other.SecondsAsleep;
+}
+
 CConfigs* CCat::GetConfigs()
 {
 	return Configs;
@@ -967,90 +1093,93 @@ void CCat::Duplicate()
 
 void CCat::Delete()
 {
-	ParentManager->DeleteCat(ListIt);
+	ParentManager->DeleteCat(Handle);
 }
 
 bool CCat::TryJumpToWindow()
 {
-	// Retrieve and shuffle windows so other windows (not just the same one) get a chance
-	std::vector<Platform> windows = WM.GetPlatforms();
+	const Platform* target = nullptr;
 
-	std::vector<int> iteration(windows.size());
-	std::iota(iteration.begin(), iteration.end(), 0);
-	std::shuffle(iteration.begin(), iteration.end(), std::default_random_engine(std::chrono::system_clock::now().time_since_epoch().count()));
-
-	// Loop through each window
-	for (int i : iteration)
 	{
-		Platform p = windows[i];
-		HWND hWnd = p.Hwnd;
+		PROFILE_SCOPE("CCat::TryJumpToWindow");
+
+		// Find the platforms within reach and shuffle them so other windows (not just the same one) get a chance
+		FrameVector<const Platform*> candidates;
+		WM.GetPlatformGraph().GetJumpTargets(CurrentWindow, Location.y, JumpHeight, candidates);
+		std::shuffle(candidates.begin(), candidates.end(), Random);
 
-		// Make sure the window exists and that it is not the window currently stood upon
-		if (CurrentWindow != hWnd)
+		// Loop through each reachable platform
+		for (const Platform* p : candidates)
 		{
-			// Check if the window is low enough to jump to
-			if (p.Height < Location.y &&
-				p.Height >= Location.y - JumpHeight)
+			// Find the exact location to jump up
+			float targetX = std::clamp(Location.x, p->Left, p->Right);
+
+			// Make sure the locations is valid (not intersecting with monitors)
+			if (IsLocationValid(glm::vec3(targetX, p->Height - 10, 0.0f)))
 			{
-				// Retrieve the bounds of the window currently stood upon
-				RECT sourceBounds;
-				if (CurrentWindow != nullptr && WM.GetWindowBoundryLocalCoords(CurrentWindow, sourceBounds))
-				{
-					// Make sure that the cat has a spot to stand on
-					if (sourceBounds.left < p.Right && sourceBounds.right > p.Left)
-					{
-						// Find the exact location to jump up
-						float targetX = std::clamp(Location.x, (float)p.Left, (float)p.Right);
-
-						// Make sure the locations is valid (not intersecting with monitors)
-						if (IsLocationValid(glm::vec3(targetX, p.Height - 10, 0.0f)))
-						{
-							// Walk to and jump onto the window!
-							Actions.push(new WalkToWindowAction(this, hWnd));
-							JumpingAction::QueueJumpingActions(this, hWnd);
-							return true;
-						}
-					}
-				}
-				else
-				{
-					// Find the exact location to jump up
-					float targetX = std::clamp(Location.x, (float)p.Left, (float)p.Right);
-
-					// Make sure the locations is valid (not intersecting with monitors)
-					if (IsLocationValid(glm::vec3(targetX, p.Height - 10, 0.0f)))
-					{
-						// Walk to and jump onto the window!
-						Actions.push(new WalkToWindowAction(this, hWnd));
-						JumpingAction::QueueJumpingActions(this, hWnd);
-						return true;
-					}
-				}
+				target = p;
+				break;
 			}
 		}
 	}
 
 	// No valid windows found
-	return false;
+	IfThenReturn(target == nullptr, false);
+
+	// Walk to and jump onto the window!
+	Actions.push(new WalkToWindowAction(this, target->Hwnd));
+	JumpingAction::QueueJumpingActions(this, target->Hwnd);
+	return true;
 }
 
-std::vector<std::pair<std::string, float>> CCat::GetIdleAnimations()
+/*
+	Plans a route of walks and jumps to a window and queues the actions to follow it,
+	the actions give up on the rest of the route if the windows move out of the way
+
+	@param target The window to get onto
+	@return If a route was found
+*/
+bool CCat::TryRouteToWindow(HWND target)
 {
-	std::vector<std::pair<std::string, float>> idleAnimations;
+	IfThenReturn(target == NULL || target == CurrentWindow, false);
 
-	// Loop through each animation
-	for (std::map<const std::string, SSpriteAnimation>::iterator it = Animations.begin(); it != Animations.end(); it++)
+	std::vector<SRouteHop> route;
+	IfThenReturn(!WM.GetPlatformGraph().FindRoute(CurrentWindow, Location.y, JumpHeight, target, route) || route.empty(), false);
+
+	float halfWidth = GetBoundsWidth() * 0.5f;
+	float x = Location.x;
+
+	for (const SRouteHop& hop : route)
 	{
-		// Check if the name starts with Idle
-		if (it->first.rfind("Idle ", 0) == 0)
+		const Platform& p = hop.Target;
+
+		if (hop.IsJump)
+		{
+			Actions.push(new WalkToWindowAction(this, p.Hwnd));
+			JumpingAction::QueueJumpingActions(this, p.Hwnd);
+			x = std::clamp(x, p.Left, p.Right);
+		}
+		else
 		{
-			// Calculate the length of the animation and add it to the return list
-			float animationLength = (it->second.Frames.size() / it->second.FPS) * (it->second.AnimationType == EAnimationType::PingPong ? 2.0f : 1.0f);
-			idleAnimations.push_back(std::make_pair(it->first, animationLength));
+			// Walk far enough onto the platform to be stood on it, narrow platforms are walked to the middle of
+			float centre = (p.Left + p.Right) * 0.5f;
+			x = p.Right - p.Left <= halfWidth * 2.0f ? centre : (centre > x ? p.Left + halfWidth : p.Right - halfWidth);
+			Actions.push(new WalkTargetAction(this, x));
 		}
 	}
 
-	return idleAnimations;
+	return true;
+}
+
+bool CCat::TryRouteToMouse()
+{
+	glm::vec2 mouse = GINPUT::GetMouseLocation();
+	return TryRouteToWindow(WM.GetPlatformGraph().FindWindowBelow(mouse.x, mouse.y));
+}
+
+const std::vector<std::pair<AnimationHandle, float>>& CCat::GetIdleAnimations()
+{
+	return IdleAnimations;
 }
 
 RECT CCat::GetBoundsWind()
@@ -1096,81 +1225,59 @@ void CCat::ClearSubsequentActions()
 	}
 }
 
+/*
+	Uses the shared cat animations loaded from Resources\\Animations\\Cat.anim
+*/
 void CCat::GenerateAnimations()
 {
-	CTexture* bouncingTexture = CTexture::GetTexture("CatRolling");
-	SSpriteAnimation bouncing = SSpriteAnimation{ bouncingTexture, 1, 1, bouncingTexture->GetDimensions() / glm::ivec2(2, 2), { { 0, 0 } }, EAnimationType::Loop, 0.0f };
-	Animations.insert({ "Bouncing", bouncing });
-
-	CTexture* slidingTexture = CTexture::GetTexture("CatSliding");
-	SSpriteAnimation slidingL = SSpriteAnimation{ slidingTexture, 1, 1, slidingTexture->GetDimensions() / glm::ivec2(2, 1), { { 0, 0 } }, EAnimationType::Loop, 0.0f };
-	SSpriteAnimation slidingR = SSpriteAnimation{ slidingTexture, 1, 1, slidingTexture->GetDimensions() / glm::ivec2(2, 1), { { 0, 0 } }, EAnimationType::Loop, 0.0f, true };
-	Animations.insert({ "Sliding Left", slidingL });
-	Animations.insert({ "Sliding Right", slidingR });
-
-	CTexture* sleepingTexture = CTexture::GetTexture("SleepingSpritesheet");
-	SSpriteAnimation sleeping = SSpriteAnimation{ sleepingTexture, 3, 1, glm::vec2((sleepingTexture->GetWidth() / 3) * 0.5f, sleepingTexture->GetHeight()), { { 0, 0 }, { 1, 0 }, { 2, 0 } }, EAnimationType::PingPong, 1.0f };
-	Animations.insert({ "Sleeping", sleeping });
-
-	CTexture* idleTexture = CTexture::GetTexture("IdleSpritesheet");
-	glm::vec2 idleOffset = glm::vec2((idleTexture->GetWidth() / 3) * 0.5f, (idleTexture->GetHeight() / 3.0f));
-	SSpriteAnimation idle = SSpriteAnimation{ idleTexture, 3, 3, idleOffset, { { 0, 0 } }, EAnimationType::Loop, 0.0f };
-	Animations.insert({ "Idle", idle });
-
-	SSpriteAnimation idleBlink = SSpriteAnimation{ idleTexture, 3, 3, idleOffset, { { 0, 0 }, { 1, 0 }, { 0, 0 } }, EAnimationType::Toggle, 2.0f };
-	Animations.insert({ "Idle Blink", idleBlink });
-
-	SSpriteAnimation idleTail = SSpriteAnimation{ idleTexture, 3, 3, idleOffset, { { 0, 0 }, { 2, 0 }, { 0, 1 }, { 1, 1 }, { 2, 1 }, { 0, 0 } }, EAnimationType::Toggle, 4.0f };
-	Animations.insert({ "Idle Tail", idleTail });
-
-	SSpriteAnimation idleYawn = SSpriteAnimation{ idleTexture, 3, 3, idleOffset, { { 0, 0 }, { 0, 2 }, { 1, 2 }, { 2, 2 }, { 2, 2 }, { 2, 2 }, { 1, 2 }, { 0, 2 }, { 0, 0 }, }, EAnimationType::Toggle, 4.0f };
-	Animations.insert({ "Idle Yawn", idleYawn });
-
-	CTexture* walkingTexture = CTexture::GetTexture("CatSpriteSheet_v1");
-	std::vector<glm::ivec2> walkingFrames = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 0, 1 }, { 1, 1 }, { 2, 1 }, { 0, 2 }, { 1, 2 } };
-
-	SSpriteAnimation walkingL = { walkingTexture, 3, 3, glm::vec2((walkingTexture->GetWidth() / 4) * 0.5f, (walkingTexture->GetHeight() / 3.0f)), walkingFrames, EAnimationType::Loop, 12.0f, true };
-	Animations.insert({ "Walking Left", walkingL });
-
-	SSpriteAnimation walkingR = { walkingTexture, 3, 3, glm::vec2((walkingTexture->GetWidth() / 4) * 0.5f, (walkingTexture->GetHeight() / 3.0f)), walkingFrames, EAnimationType::Loop, 12.0f };
-	Animations.insert({ "Walking Right", walkingR });
-
-	CTexture* jumpStartTexture = CTexture::GetTexture("JumpStartSpritesheet");
-	std::vector<glm::ivec2> jumpStartFrames = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 0, 1 }, { 1, 1 }, { 2, 1 } };
-	SSpriteAnimation jumpingStart = SSpriteAnimation{ jumpStartTexture, 3, 2, jumpStartTexture->GetDimensions() / glm::ivec2(3, 2) / glm::ivec2(2, 1), jumpStartFrames, EAnimationType::Toggle, 40.0f };
-	Animations.insert({ "Jumping Start", jumpingStart });
-
-	CTexture* jumpMiddleTexture = CTexture::GetTexture("JumpMiddleSpritesheet");
-	std::vector<glm::ivec2> jumpMiddleFrames = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 0, 1 }, { 1, 1 }, { 2, 1 }, { 0, 2 }, { 1, 2 }, { 2, 2 } };
-	SSpriteAnimation jumpingMiddle = SSpriteAnimation{ jumpMiddleTexture, 3, 3, jumpMiddleTexture->GetDimensions() / glm::ivec2(3, 3) / glm::ivec2(2, 2), jumpMiddleFrames, EAnimationType::Loop, 10.0f };
-	Animations.insert({ "Jumping Middle", jumpingMiddle });
-
-	CTexture* jumpEndTexture = CTexture::GetTexture("JumpEndSpritesheet");
-	std::vector<glm::ivec2> jumpEndFrames = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 0, 1 }, { 1, 1 } };
-	SSpriteAnimation jumpingEnd = SSpriteAnimation{ jumpEndTexture, 3, 2, glm::vec2(jumpEndTexture->GetDimensions()) / glm::vec2(3, 2) * glm::vec2(0.5, 0.65), jumpEndFrames, EAnimationType::Toggle, 30.0f };
-	Animations.insert({ "Jumping End", jumpingEnd });
-
-	CTexture* carriedTexture = CTexture::GetTexture("CarriedSpritesheet");
-	SSpriteAnimation carried = SSpriteAnimation{ carriedTexture, 3, 2, glm::vec2((carriedTexture->GetWidth() / 3.0f) * 0.5f, (carriedTexture->GetHeight() / 2.0f) * 0.5f), EAnimationType::Loop, 10.0f };
-	Animations.insert({ "Carried", carried });
-
-	CTexture* eatingTexture = CTexture::GetTexture("CatEatingSpritesheet");
-	SSpriteAnimation eatingIcon = SSpriteAnimation{ eatingTexture, 3, 1, glm::vec2(eatingTexture->GetDimensions()) / glm::vec2(3, 1) * glm::vec2(0.5f, 1.0f), { { 0, 0 }, { 1, 0 },{ 1, 0 }, { 2, 0 } }, EAnimationType::Toggle, 7.0f };
-	Animations.insert({ "Eating Icon", eatingIcon });
-
-	//CTexture* fallingTexture = CTexture::GetTexture("CatFalling");
-	//SSpriteAnimation falling = SSpriteAnimation{ fallingTexture, 1, 2, glm::vec2(fallingTexture->GetDimensions()) / glm::vec2(1, 2) * glm::vec2(0.5f, 1.0f), { { 0, 0 }, { 0, 1 } }, EAnimationType::Loop, 7.0f };
-	//Animations.insert({ "Falling", falling });
-	//
-	//CTexture* standingTexture = CTexture::GetTexture("CatStanding");
-	//SSpriteAnimation standing = SSpriteAnimation{ standingTexture, 1, 1, glm::vec2(standingTexture->GetDimensions()) * glm::vec2(0.5f, 1.0f), { { 0, 0 } }, EAnimationType::Loop, 0.0f };
-	//Animations.insert({ "Standing", standing });
+	CAnimationLibrary* library = CAnimationLibrary::GetLibrary("Cat");
+
+	if (library == nullptr)
+	{
+		// Keep running with no animations rather than crashing, every lookup will warn instead
+		HELPER::PrintToOutput("WARNING: Cat animations have not been loaded");
+		library = new CAnimationLibrary();
+		CAnimationLibrary::SetLibrary("Cat", library);
+	}
+
+	IfThenStatement(IdleAnimations.empty(), FindIdleAnimations(library));
+	SetAnimationLibrary(library);
+}
+
+/*
+	Finds the idle animations that can be played while sitting, these are the ones starting with "Idle "
+
+	@param library The cat animation library
+*/
+void CCat::FindIdleAnimations(CAnimationLibrary* library)
+{
+	IdleAnimations.clear();
+
+	for (AnimationHandle handle = 0; handle < library->GetAnimationCount(); ++handle)
+	{
+		IfThenStatement(library->GetName(handle).rfind("Idle ", 0) != 0, continue);
+		IdleAnimations.push_back(std::make_pair(handle, library->GetAnimation(handle).Length));
+	}
 }
 
 void CCat::UpdateModelMatrix()
 {
 	CSprite::UpdateModelMatrix();
-	ModelMatrix = glm::translate(glm::mat4(), Offset) * ModelMatrix;
+	ModelMatrix[3] += glm::vec4(Offset, 0.0f); // Same as translating by the offset first
+}
+
+/*
+	Adds the offset to the transform values that rebuild the model matrix
+
+	@return If the model matrix needs to be rebuilt
+*/
+bool CCat::HasTransformChanged()
+{
+	bool changed = CSprite::HasTransformChanged();
+	IfThenReturn(Offset == BuiltOffset, changed);
+
+	BuiltOffset = Offset;
+	return true;
 }
 
 void CCat::OnAnimationEnd()
@@ -1196,74 +1303,6 @@ void CCat::UpdateColours()
 	}
 }
 
-GLuint CCat::HiconToTexture(HICON hIcon)
-{
-	GLuint textureID = 0;
-
-	// Get the data of the icon
-	ICONINFO iconData;
-	if (::GetIconInfo(hIcon, &iconData) == FALSE) return NULL;
-
-	// Create a new DC to copy to
-	HDC mainDC = ::GetDC(NULL);
-	HDC memDC = ::CreateCompatibleDC(mainDC);
-
-	if (mainDC == NULL || memDC == NULL) return NULL;
-
-	BITMAP bmp;
-	if (::GetObject(iconData.hbmColor, sizeof(BITMAP), &bmp))
-	{
-		// Dimensions
-		DWORD  width = iconData.xHotspot * 2;
-		DWORD  height = iconData.yHotspot * 2;
-
-		// Generate the info of the bitmap
-		BITMAPINFO mybmi;
-		mybmi.bmiHeader.biSize = sizeof(mybmi);
-		mybmi.bmiHeader.biWidth = width;
-		mybmi.bmiHeader.biHeight = height;
-		mybmi.bmiHeader.biPlanes = 1;
-		mybmi.bmiHeader.biBitCount = 32;
-		mybmi.bmiHeader.biCompression = BI_RGB;
-		mybmi.bmiHeader.biSizeImage = ((width * (mybmi.bmiHeader.biBitCount / 8) + 3) & -4) * height;
-
-		// The bits of the texture
-		unsigned char* bits;
-
-		HBITMAP newbitmap = CreateDIBSection(memDC, &mybmi, DIB_RGB_COLORS, (VOID**)&bits, 0, 0);
-		if (!newbitmap) { return NULL; }
-
-		int result = GetDIBits(memDC, iconData.hbmColor, 0, height, bits, (BITMAPINFO*)&mybmi, DIB_RGB_COLORS);
-		if (!result) { return NULL; }
-
-		// Generate a new texture
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// Pixel alignment
-		glPixelStorei(GL_UNPACK_SWAP_BYTES, GL_FALSE);
-		glPixelStorei(GL_UNPACK_LSB_FIRST, GL_TRUE);
-		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-		glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
-		glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-		// Generate the texture
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, bits);
-
-		// Specify the min mag filters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	}
-
-	::DeleteObject(iconData.hbmColor);
-	::DeleteObject(iconData.hbmMask);
-	::DeleteDC(memDC);
-	::ReleaseDC(NULL, mainDC);
-
-	return textureID;
-}
-
 void CCat::SpawnHeart()
 {
 	if (IsSpawningHearts)
@@ -1274,6 +1313,6 @@ void CCat::SpawnHeart()
 			Parent->ParticlesLayer->SpawnParticle(GINPUT::GetMouseLocation(), "Hearts");
 		}
 
-		SetAlarm(SpawningHeartInterval, std::bind(&CCat::SpawnHeart, this));
+		HeartAlarm = SetAlarm(SpawningHeartInterval, std::bind(&CCat::SpawnHeart, this));
 	}
 }
\ No newline at end of file
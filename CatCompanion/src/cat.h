@@ -1,11 +1,11 @@
 #pragma once
 #include <Windows.h>
 #include <queue>
-#include <list>
-#include <chrono>
 #include <wtypes.h>
 
 #include "sprite.h"
+#include "random.h"
+#include "slotMap.h"
 
 class CFont;
 class CScene;
@@ -17,6 +17,8 @@ class CConfigs;
 
 struct Action;
 
+typedef SSlotHandle CatHandle;
+
 enum class DIRECTION
 {
 	LEFT = -1,
@@ -39,6 +41,16 @@ enum class CatState
 	IconProcessing,
 };
 
+// What a cat has done, added up for batch runs
+struct SCatMetrics
+{
+	int JumpsAttempted = 0;
+	int JumpsSucceeded = 0;
+	float SecondsAsleep = 0.0f;
+
+	void Add(const SCatMetrics& other);
+};
+
 class CCat :
 	public CSprite
 {
@@ -46,16 +58,19 @@ public:
 	CCat(CCatManager* parent, CConfigs* configs, glm::vec2 location);
 	virtual ~CCat();
 
+	void UpdateParallel();
 	void Update() override;
+	void UpdateLate();
 	void Draw(glm::mat4& pv = CCamera::GetProjViewMatrix()) override;
-	void OnFileDropped(HICON icon);
+	bool CanEatIcon();
+	void EatIcon(GLuint texture, unsigned long long iconHash);
 
 	void UpdateMouseEvents();
 	void ProcessActions();
 	void UpdateActions();
 	void UpdatePhysics();
 	void ConfineToMonitors();
-	void WindowCollision();
+	void WindowCollision(glm::vec3 from);
 	void UpdateIcon();
 
 	void OnLMBDown();
@@ -67,6 +82,8 @@ public:
 
 	float GetBoundsWidth();
 	float GetBoundsHeight();
+	void GetBounds(glm::vec2& topLeft, glm::vec2& botRight);
+	bool GetDrawBounds(RECT& bounds);
 	bool IsInBounds(glm::vec2 location);
 
 	int GetNumberOfColours();
@@ -74,7 +91,8 @@ public:
 	void SetColour(int index, glm::vec3 colour);
 
 	CConfigs* GetConfigs();
-	void SetListIterator(std::list<CCat*>::iterator listIt);
+	void SetHandle(CatHandle handle);
+	CatHandle GetHandle();
 
 	void SetCurrentState(CatState newState);
 	CatState GetCurrentState();
@@ -84,12 +102,16 @@ public:
 	void QueueAction(Action* newAction);
 
 	bool TryJumpToWindow();
-	std::vector<std::pair<std::string, float>> GetIdleAnimations();
+	bool TryRouteToWindow(HWND target);
+	bool TryRouteToMouse();
+	const std::vector<std::pair<AnimationHandle, float>>& GetIdleAnimations();
 	bool IsLocationValid(glm::vec3 location);
 	HWND GetCurrentWindow();
 	
 	void SetName(std::string name);
 	std::string GetName();
+	CRandom& GetRandom();
+	SCatMetrics& GetMetrics();
 
 	void Duplicate();
 	void Delete();
@@ -109,7 +131,7 @@ private:
 	CCatManager* ParentManager;
 	CScene* Parent;
 	CConfigs* Configs;
-	std::list<CCat*>::iterator ListIt;
+	CatHandle Handle;
 
 	std::string Name;
 	glm::ivec2 NameDimensions;
@@ -119,14 +141,17 @@ private:
 
 
 	CObject* IconObject;
-	GLuint IconTexture;
+	GLuint IconTexture; // Owned by the icon pipeline, handed back once eaten
+	unsigned long long IconHash;
 	glm::vec3 IconVelocity;
 
 	float FloorY;
-	glm::vec3 OldLoc;
 	HWND CurrentWindow;
 
 	CatState CurrentState;
+	CRandom Random; // Each cat has its own sequence so one cat's choices don't change another's
+	static unsigned long long NextRandomStream;
+	SCatMetrics Metrics;
 
 	Action* CurrentAction;
 	std::queue<Action*> Actions;
@@ -134,7 +159,6 @@ private:
 	glm::vec3 Colours[255];
 	int NumberOfColours;
 
-	std::chrono::steady_clock::time_point RClickTimePoint;
 	bool RButtonDown;
 
 	RECT GetBoundsWind();
@@ -143,18 +167,23 @@ private:
 	void UpdateColours();
 	void GenerateAnimations() override;
 	void UpdateModelMatrix() override;
+	bool HasTransformChanged() override;
 	void OnAnimationEnd() override;
 
-	GLuint HiconToTexture(HICON hIcon);
 
 	void CalculateHues();
 
 	bool IsSpawningHearts;
+	AlarmHandle HeartAlarm;
 	float SpawningHeartInterval = 0.1f;
 
 	HCURSOR PattingCursor;
+	glm::vec3 BuiltOffset; // The offset the model matrix was last built with
 
 	static bool HasLoadedHues;
+	static std::vector<std::pair<AnimationHandle, float>> IdleAnimations; // Idle animations and how long they take to play
+
+	static void FindIdleAnimations(CAnimationLibrary* library);
 
 	void SpawnHeart();
 };
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cmath>
+
+#include "catGrid.h"
+#include "helper.h"
+
+CCatGrid::CCatGrid(float cellSize)
+{
+	CellSize = cellSize;
+}
+
+/*
+	Moves a cat to the cells its bounds now cover, adding it if it isn't in the grid yet
+
+	@param cat The cat that moved
+	@param topLeft Top left of the cat's bounds
+	@param botRight Bottom right of the cat's bounds
+	@param drawOrder Order the cat is drawn in, the highest is on top
+*/
+void CCatGrid::Update(CCat* cat, glm::vec2 topLeft, glm::vec2 botRight, unsigned int drawOrder)
+{
+	SEntry updated = { topLeft, botRight, GetCell(topLeft), GetCell(botRight), drawOrder };
+	auto it = Entries.find(cat);
+
+	if (it == Entries.end())
+	{
+		AddToCells(cat, updated);
+		Entries.insert({ cat, updated });
+		return;
+	}
+
+	SEntry& entry = it->second;
+
+	if (entry.MinCell != updated.MinCell || entry.MaxCell != updated.MaxCell)
+	{
+		RemoveFromCells(cat, entry);
+		AddToCells(cat, updated);
+	}
+
+	entry = updated;
+}
+
+void CCatGrid::Remove(CCat* cat)
+{
+	auto it = Entries.find(cat);
+	IfThenReturn(it == Entries.end(), );
+
+	RemoveFromCells(cat, it->second);
+	Entries.erase(it);
+}
+
+/*
+	Finds the cat under a point, when cats overlap the one drawn last is the one that can be seen
+
+	@param location The point in cat window coordinates
+	@return The cat, nullptr if there's no cat at the point
+*/
+CCat* CCatGrid::GetCatAt(glm::vec2 location)
+{
+	glm::ivec2 cell = GetCell(location);
+	auto it = Cells.find(GetKey(cell.x, cell.y));
+	IfThenReturn(it == Cells.end(), nullptr);
+
+	CCat* top = nullptr;
+	unsigned int topOrder = 0;
+
+	for (CCat* cat : it->second)
+	{
+		const SEntry& entry = Entries[cat];
+
+		if (HELPER::InBounds(location, entry.TopLeft, entry.BotRight) && (top == nullptr || entry.DrawOrder > topOrder))
+		{
+			top = cat;
+			topOrder = entry.DrawOrder;
+		}
+	}
+
+	return top;
+}
+
+/*
+	Finds every cat whose bounds come within a distance of a point
+
+	@param centre The point in cat window coordinates
+	@param radius How far from the point to look
+	@param cats Filled with the cats found, each cat once
+*/
+void CCatGrid::GetCatsInRadius(glm::vec2 centre, float radius, FrameVector<CCat*>& cats)
+{
+	cats.clear();
+
+	glm::ivec2 minCell = GetCell(centre - glm::vec2(radius));
+	glm::ivec2 maxCell = GetCell(centre + glm::vec2(radius));
+
+	for (int y = minCell.y; y <= maxCell.y; ++y)
+	{
+		for (int x = minCell.x; x <= maxCell.x; ++x)
+		{
+			auto it = Cells.find(GetKey(x, y));
+			IfThenStatement(it == Cells.end(), continue);
+
+			for (CCat* cat : it->second)
+			{
+				const SEntry& entry = Entries[cat];
+
+				// Cats covering several cells are only taken from the first of them that is searched
+				glm::ivec2 first = glm::max(entry.MinCell, minCell);
+				IfThenStatement(first.x != x || first.y != y, continue);
+
+				glm::vec2 closest = glm::clamp(centre, entry.TopLeft, entry.BotRight);
+				IfThenStatement(glm::dot(closest - centre, closest - centre) <= radius * radius, cats.push_back(cat));
+			}
+		}
+	}
+}
+
+int CCatGrid::GetOccupiedCellCount()
+{
+	return (int)Cells.size();
+}
+
+glm::ivec2 CCatGrid::GetCell(glm::vec2 location)
+{
+	return glm::ivec2((int)std::floor(location.x / CellSize), (int)std::floor(location.y / CellSize));
+}
+
+// Both halves are unsigned, shifting a negative cell coordinate would be undefined
+unsigned long long CCatGrid::GetKey(int x, int y)
+{
+	return ((unsigned long long)(unsigned int)x << 32) | (unsigned int)y;
+}
+
+void CCatGrid::AddToCells(CCat* cat, const SEntry& entry)
+{
+	for (int y = entry.MinCell.y; y <= entry.MaxCell.y; ++y)
+	{
+		for (int x = entry.MinCell.x; x <= entry.MaxCell.x; ++x)
+		{
+			Cells[GetKey(x, y)].push_back(cat);
+		}
+	}
+}
+
+void CCatGrid::RemoveFromCells(CCat* cat, const SEntry& entry)
+{
+	for (int y = entry.MinCell.y; y <= entry.MaxCell.y; ++y)
+	{
+		for (int x = entry.MinCell.x; x <= entry.MaxCell.x; ++x)
+		{
+			auto it = Cells.find(GetKey(x, y));
+			IfThenStatement(it == Cells.end(), continue);
+
+			std::vector<CCat*>& cell = it->second;
+			cell.erase(std::remove(cell.begin(), cell.end(), cat), cell.end());
+			IfThenStatement(cell.empty(), Cells.erase(it));
+		}
+	}
+}
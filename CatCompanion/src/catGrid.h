@@ -0,0 +1,47 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <glm.hpp>
+
+#include "frameArena.h"
+
+class CCat;
+
+/*
+	Uniform grid over the cats' bounds so finding the cats at a point or near each other only looks at
+	the cells around it instead of every cat. Cats are only moved between cells when their bounds cover
+	different cells, which for most frames is none of them
+*/
+class CCatGrid
+{
+public:
+	CCatGrid(float cellSize);
+
+	void Update(CCat* cat, glm::vec2 topLeft, glm::vec2 botRight, unsigned int drawOrder);
+	void Remove(CCat* cat);
+
+	CCat* GetCatAt(glm::vec2 location); // The cat drawn on top at a point, nullptr if there isn't one
+	void GetCatsInRadius(glm::vec2 centre, float radius, FrameVector<CCat*>& cats);
+
+	int GetOccupiedCellCount();
+
+private:
+	struct SEntry
+	{
+		glm::vec2 TopLeft;
+		glm::vec2 BotRight;
+		glm::ivec2 MinCell;
+		glm::ivec2 MaxCell;
+		unsigned int DrawOrder; // Cats drawn later are on top
+	};
+
+	float CellSize;
+	std::unordered_map<unsigned long long, std::vector<CCat*>> Cells;
+	std::unordered_map<CCat*, SEntry> Entries;
+
+	glm::ivec2 GetCell(glm::vec2 location);
+	unsigned long long GetKey(int x, int y);
+
+	void AddToCells(CCat* cat, const SEntry& entry);
+	void RemoveFromCells(CCat* cat, const SEntry& entry);
+};
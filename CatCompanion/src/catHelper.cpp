@@ -1,4 +1,5 @@
 #include "catHelper.h"
+#include "hueHistogram.h"
 #include <algorithm>
 
 int HELPER::GetHue(int red, int green, int blue) 
@@ -32,57 +33,50 @@ int HELPER::GetHue(int red, int green, int blue)
     return std::round(hue);
 }
 
-BOOL HELPER::GetTopHues(HICON hIcon, std::vector<int>& hues)
+/*
+    Copies an icon's colour bitmap into a buffer with one GetDIBits call, everything that looks at the
+    icon's pixels works from the buffer
+
+    @return If the icon has a colour bitmap that could be read
+*/
+BOOL HELPER::GetIconPixels(HICON hIcon, SIconPixels& pixels)
 {
-    hues.resize(360);
+    ICONINFO iconData;
+    if (::GetIconInfo(hIcon, &iconData) == FALSE) return FALSE;
 
-    HDC hMainDC = NULL;
-    HDC hMemDC1 = NULL;
+    HDC mainDC = ::GetDC(NULL);
+    HDC memDC = ::CreateCompatibleDC(mainDC);
     BITMAP bmp;
-    HBITMAP hOldBmp1 = NULL;
-    ICONINFO csII;
-    BOOL bRetValue = FALSE;
-
-    bRetValue = ::GetIconInfo(hIcon, &csII);
-    if (bRetValue == FALSE) return NULL;
-
-    hMainDC = ::GetDC(NULL);
-    hMemDC1 = ::CreateCompatibleDC(hMainDC);
-    if (hMainDC == NULL || hMemDC1 == NULL) return NULL;
+    BOOL result = FALSE;
 
-    if (::GetObject(csII.hbmColor, sizeof(BITMAP), &bmp))
+    if (mainDC != NULL && memDC != NULL && iconData.hbmColor != NULL && ::GetObject(iconData.hbmColor, sizeof(BITMAP), &bmp))
     {
-        DWORD   dwWidth = csII.xHotspot * 2;
-        DWORD   dwHeight = csII.yHotspot * 2;
-
-        hOldBmp1 = (HBITMAP)::SelectObject(hMemDC1, csII.hbmColor);
-
-        DWORD    dwLoopY = 0, dwLoopX = 0;
-        COLORREF crPixel = 0;
-        BYTE     byNewPixel = 0;
-
-        for (dwLoopY = 0; dwLoopY < dwHeight; dwLoopY++)
-        {
-            for (dwLoopX = 0; dwLoopX < dwWidth; dwLoopX++)
-            {
-                crPixel = ::GetPixel(hMemDC1, dwLoopX, dwLoopY);
-
-                float r = GetRValue(crPixel);
-                float g = GetGValue(crPixel);
-                float b = GetBValue(crPixel);
-
-                int hue = GetHue(r, g, b);
-                hues[hue] += 1;
-            }
-        }
-
-        ::SelectObject(hMemDC1, hOldBmp1);
+        pixels.Width = bmp.bmWidth;
+        pixels.Height = bmp.bmHeight;
+        pixels.Bgra.resize((size_t)pixels.Width * pixels.Height * 4);
+
+        // A positive height gives the rows bottom first, which is what the texture upload has always used
+        BITMAPINFO info = {};
+        info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+        info.bmiHeader.biWidth = pixels.Width;
+        info.bmiHeader.biHeight = pixels.Height;
+        info.bmiHeader.biPlanes = 1;
+        info.bmiHeader.biBitCount = 32;
+        info.bmiHeader.biCompression = BI_RGB;
+
+        result = ::GetDIBits(memDC, iconData.hbmColor, 0, pixels.Height, pixels.Bgra.data(), &info, DIB_RGB_COLORS) == pixels.Height;
     }
 
-    ::DeleteObject(csII.hbmColor);
-    ::DeleteObject(csII.hbmMask);
-    ::DeleteDC(hMemDC1);
-    ::ReleaseDC(NULL, hMainDC);
+    IfThenStatement(iconData.hbmColor != NULL, ::DeleteObject(iconData.hbmColor));
+    ::DeleteObject(iconData.hbmMask);
+    IfThenStatement(memDC != NULL, ::DeleteDC(memDC));
+    IfThenStatement(mainDC != NULL, ::ReleaseDC(NULL, mainDC));
 
-    return TRUE;
+    return result;
+}
+
+void HELPER::GetTopHues(const SIconPixels& pixels, std::vector<int>& hues)
+{
+    hues.assign(HUE_COUNT, 0);
+    CountHues(pixels.Bgra.data(), pixels.Width * pixels.Height, hues.data());
 }
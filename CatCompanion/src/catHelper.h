@@ -3,8 +3,17 @@
 
 #include <vector>
 
+// An icon's colour bitmap read once, 32 bit BGRA with the bottom row first as GetDIBits gives it
+struct SIconPixels
+{
+    int Width = 0;
+    int Height = 0;
+    std::vector<unsigned char> Bgra;
+};
+
 namespace HELPER
 {
     int GetHue(int red, int green, int blue);
-    BOOL GetTopHues(HICON hIcon, std::vector<int>& hues);
-}
\ No newline at end of file
+    BOOL GetIconPixels(HICON hIcon, SIconPixels& pixels);
+    void GetTopHues(const SIconPixels& pixels, std::vector<int>& hues);
+}
@@ -7,15 +7,35 @@
 #include "helper.h"
 #include "configs.h"
 #include "monitorManager.h"
+#include "windowsManager.h"
 #include "input.h"
+#include "jobSystem.h"
+#include "renderStats.h"
+#include "timer.h"
+#include "profiler.h"
+#include "CatWindow.h"
+#include "scene.h"
+#include "iconPipeline.h"
 
 #define MOUSE_PRESS_TIME 0.25f
-#define CAT_FILE_LOCATION "Resources\\Cats\\"
+#define GRID_CELL_SIZE 128.0f // Pixels, a few cats wide
 
 
 CCatManager::CCatManager(CScene* parent)
+	: Grid(GRID_CELL_SIZE)
 {
 	Parent = parent;
+	ParallelPhase = true;
+	HoveredCat = nullptr;
+	CurrentlySelectedCat = nullptr;
+	IconPipeline = new CIconPipeline(this);
+	CatsStat = STATS::RegisterValue("Cats");
+	GridCellsStat = STATS::RegisterValue("Cat Grid Cells");
+	CulledCatsStat = STATS::RegisterValue("Culled Cats");
+
+	// Folder the cats are saved in, batch runs give every run its own
+	CatFolder = CGlobalVariables::ConfigSetting->GetStringVariable("cat-folder");
+	IfThenStatement(CatFolder != "" && CatFolder.back() != '\\', CatFolder += '\\');
 
 	GenerateCatConfigSettings();
 	CalculateHues();
@@ -25,23 +45,104 @@ CCatManager::CCatManager(CScene* parent)
 CCatManager::~CCatManager()
 {
 	for (CCat* cat : Cats) { delete cat; }
-	Cats.clear();
+	Cats.Clear();
+
+	// After the cats, they hand their icons back as they go
+	delete IconPipeline;
+	IconPipeline = nullptr;
 
 	delete CatConfigSettings;
 	CatConfigSettings = nullptr;
 }
 
+void CCatManager::UpdateParallel()
+{
+	CCat** cats = Cats.Data();
+
+	JOBS::ParallelFor(Cats.Size(), 0, [cats](int start, int end)
+	{
+		for (int i = start; i < end; ++i) { cats[i]->UpdateParallel(); }
+	});
+}
+
 void CCatManager::Update()
 {
-	//for (CCat* cat : Cats) { cat->Update(); }
-	int count = Cats.size();
-	for (CCat* cat : Cats) { cat->Update(); }
+	UpdateGrid();
+
+	// Indexed as cats can be added while updating
+	for (int i = 0; i < Cats.Size(); ++i) { Cats[i]->Update(); }
+
+	// Every cat's actions have set its velocity for this step, no cats are added until the next part
+	CCat** cats = Cats.Data();
+
+	JOBS::ParallelFor(Cats.Size(), 0, [cats](int start, int end)
+	{
+		for (int i = start; i < end; ++i) { PROFILE_SCOPE("CCat::UpdatePhysics"); cats[i]->UpdatePhysics(); }
+	});
+
+	for (int i = 0; i < Cats.Size(); ++i) { Cats[i]->UpdateLate(); }
 	UpdateMouseInput();
+
+	STATS::SetValue(CatsStat, Cats.Size());
+	STATS::SetValue(GridCellsStat, Grid.GetOccupiedCellCount());
 }
 
+/*
+	Brings the grid up to date with where the cats have moved to and finds the cat under the mouse
+*/
+void CCatManager::UpdateGrid()
+{
+	PROFILE_SCOPE("CCatManager::UpdateGrid");
+
+	unsigned int drawOrder = 0;
+
+	for (CCat* cat : Cats)
+	{
+		glm::vec2 topLeft;
+		glm::vec2 botRight;
+		cat->GetBounds(topLeft, botRight);
+		Grid.Update(cat, topLeft, botRight, drawOrder++);
+	}
+
+	HoveredCat = Grid.GetCatAt(GINPUT::GetMouseLocation());
+}
+
+/*
+	Draws the cats that can be seen, cats sat on a window are hidden by the windows in front of it.
+	Finished icons are uploaded here first so the upload budget is spent once a frame, not once a step
+*/
 void CCatManager::Render()
 {
-	for (CCat* cat : Cats) { cat->Draw(); }
+	IconPipeline->Update();
+
+	CWindowCoverage& coverage = CWindowsManager::GetInstance().GetCoverage();
+	int screenHeight = CCamera::GetScreenSizeI().y;
+	int culled = 0;
+
+	for (CCat* cat : Cats)
+	{
+		RECT bounds;
+		RECT visible;
+		ECoverage result = cat->GetDrawBounds(bounds) ? coverage.Test(cat->GetCurrentWindow(), bounds, visible) : ECoverage::Visible;
+
+		if (result == ECoverage::Hidden)
+		{
+			culled++;
+			continue;
+		}
+
+		if (result == ECoverage::Partial)
+		{
+			// Only draw the part that can be seen past the windows in front
+			glEnable(GL_SCISSOR_TEST);
+			glScissor(visible.left, screenHeight - visible.bottom, visible.right - visible.left, visible.bottom - visible.top);
+		}
+
+		cat->Draw();
+		IfThenStatement(result == ECoverage::Partial, glDisable(GL_SCISSOR_TEST));
+	}
+
+	STATS::SetValue(CulledCatsStat, culled);
 }
 
 void CCatManager::UpdateMouseInput()
@@ -52,19 +153,19 @@ void CCatManager::UpdateMouseInput()
 		{
 			if (GINPUT::GetLMButtonState() == InputState::INPUT_DOWN_FIRST)
 			{
-				if (GetHoveredCat(CurrentlySelectedCat))
+				if ((CurrentlySelectedCat = HoveredCat) != nullptr)
 				{
 					CurrentMouseState = MouseState::LMB;
-					(*CurrentlySelectedCat)->OnLMBDown();
+					CurrentlySelectedCat->OnLMBDown();
 				}
 			}
 			else if (GINPUT::GetRMButtonState() == InputState::INPUT_DOWN_FIRST)
 			{
-				if (GetHoveredCat(CurrentlySelectedCat))
+				if ((CurrentlySelectedCat = HoveredCat) != nullptr)
 				{
 					CurrentMouseState = MouseState::RMB;
-					RClickTimePoint = std::chrono::steady_clock::now();
-					(*CurrentlySelectedCat)->OnRMBDown();
+					RClickTime = TIMER::GetTotalSeconds();
+					CurrentlySelectedCat->OnRMBDown();
 					RMBHeld = false;
 				}
 			}
@@ -77,7 +178,7 @@ void CCatManager::UpdateMouseInput()
 			if (GINPUT::GetLMButtonState() == InputState::INPUT_UP_FIRST)
 			{
 				CurrentMouseState = MouseState::Nothing;
-				(*CurrentlySelectedCat)->OnLMBUp();
+				CurrentlySelectedCat->OnLMBUp();
 			}
 
 			break;
@@ -88,17 +189,17 @@ void CCatManager::UpdateMouseInput()
 			if (GINPUT::GetRMButtonState() == InputState::INPUT_UP_FIRST)
 			{
 				CurrentMouseState = MouseState::Nothing;
-				(*CurrentlySelectedCat)->OnRMBUp();
+				CurrentlySelectedCat->OnRMBUp();
 
-				if (!RMBHeld) { (*CurrentlySelectedCat)->OnRMBPressed(); }
+				if (!RMBHeld) { CurrentlySelectedCat->OnRMBPressed(); }
 			}
 			else if (!RMBHeld)
 			{
-				float duration = std::chrono::duration<float>(std::chrono::steady_clock::now() - RClickTimePoint).count();
+				float duration = (float)(TIMER::GetTotalSeconds() - RClickTime);
 
 				if (duration >= MOUSE_PRESS_TIME)
 				{
-					(*CurrentlySelectedCat)->OnRMBHeld();
+					CurrentlySelectedCat->OnRMBHeld();
 					RMBHeld = true;
 				}
 			}
@@ -111,12 +212,12 @@ void CCatManager::UpdateMouseInput()
 void CCatManager::LoadCats()
 {
 	CMonitorManager& mm = CMonitorManager::GetInstance();
-	std::vector<HMONITOR>& monitors = mm.GetMonitors();
+	const std::vector<HMONITOR>& monitors = mm.GetMonitors();
 	MonitorInfo info = mm.GetMonitorDetail((int)monitors[0]);
 
 	std::vector<std::string> filenames;
 
-	for (const auto& entry : std::filesystem::directory_iterator(CAT_FILE_LOCATION))
+	for (const auto& entry : std::filesystem::directory_iterator(CatFolder))
 	{
 		filenames.push_back(entry.path().stem().u8string());
 	}
@@ -125,9 +226,7 @@ void CCatManager::LoadCats()
 
 	if (count == 0)
 	{
-		CCat* cat = new CCat(this, new CConfigs(*CatConfigSettings), glm::vec2(info.Width * 0.5f, info.Height - info.TaskBarHeight));
-		Cats.push_back(cat);
-		cat->SetListIterator(--Cats.end());
+		InsertCat(new CCat(this, new CConfigs(*CatConfigSettings), glm::vec2(info.Width * 0.5f, info.Height - info.TaskBarHeight)));
 	}
 	else
 	{
@@ -137,70 +236,108 @@ void CCatManager::LoadCats()
 
 			std::string filename = filenames[i];
 			CConfigs* configs = new CConfigs(*CatConfigSettings, filename);
-			CCat* cat = new CCat(this, configs, glm::vec2(info.Width * percentage, info.Height - info.TaskBarHeight));
-			Cats.push_back(cat);
-			cat->SetListIterator(--Cats.end());
+			InsertCat(new CCat(this, configs, glm::vec2(info.Width * percentage, info.Height - info.TaskBarHeight)));
 		}
 	}
 }
 
 CCat* CCatManager::AddCat(glm::vec2 location, CConfigs* config)
 {
-	CCat* cat = new CCat(this, new CConfigs(config), location);
-	Cats.push_back(cat);
-	cat->SetListIterator(--Cats.end());
-	return cat;
+	return InsertCat(new CCat(this, new CConfigs(config), location));
 }
 
 CCat* CCatManager::AddCat(glm::vec2 location)
 {
-	CCat* cat = new CCat(this, new CConfigs(*CatConfigSettings), location);
-	Cats.push_back(cat);
-	cat->SetListIterator(--Cats.end());
+	return InsertCat(new CCat(this, new CConfigs(*CatConfigSettings), location));
+}
+
+CCat* CCatManager::InsertCat(CCat* cat)
+{
+	cat->SetHandle(Cats.Insert(cat));
 	return cat;
 }
 
+int CCatManager::GetCatCount()
+{
+	return Cats.Size();
+}
+
+/*
+	Adds up what every cat has done, including cats that have since been removed
+
+	@return The metrics of all the cats together
+*/
+SCatMetrics CCatManager::GetMetricsTotal()
+{
+	SCatMetrics total = RemovedCatMetrics;
+	for (CCat* cat : Cats) { total.Add(cat->GetMetrics()); }
+	return total;
+}
+
 CCat* CCatManager::GetFirstCat()
 {
-	return *Cats.begin();
+	return !Cats.Empty() ? Cats[0] : nullptr;
+}
+
+CCat* CCatManager::GetCat(CatHandle handle)
+{
+	CCat** cat = Cats.Get(handle);
+	return cat != nullptr ? *cat : nullptr;
 }
 
-void CCatManager::DeleteCat(std::list<CCat*>::iterator it)
+/*
+	Removes a cat and deletes its save file, once the last cat has gone the program closes
+
+	@param handle The cat to remove, nothing happens if it has already gone
+*/
+void CCatManager::DeleteCat(CatHandle handle)
 {
-	(*it)->GetConfigs()->Delete();
-	delete (*it);
-	Cats.erase(it);
+	CCat* cat = GetCat(handle);
+	IfThenReturn(cat == nullptr, );
+
+	Grid.Remove(cat);
+	IfThenStatement(HoveredCat == cat, HoveredCat = nullptr);
 
-	if (Cats.empty())
+	if (CurrentlySelectedCat == cat)
 	{
-		exit(0);
+		CurrentlySelectedCat = nullptr;
+		CurrentMouseState = MouseState::Nothing;
 	}
+
+	RemovedCatMetrics.Add(cat->GetMetrics());
+	cat->GetConfigs()->Delete();
+	Cats.Remove(handle);
+	delete cat;
+
+	// Close the same way the exit button does so the run still finishes cleanly
+	IfThenStatement(Cats.Empty(), CScene::IsOpen = false);
 }
 
-bool CCatManager::GetHoveredCat(std::list<CCat*>::iterator& it)
+CIconPipeline& CCatManager::GetIconPipeline()
 {
-	glm::vec2 mouseLoc = GINPUT::GetMouseLocation();
-
-	it = Cats.begin();
+	return *IconPipeline;
+}
 
-	while (it != Cats.end())
-	{
-		if ((*it)->IsInBounds(mouseLoc))
-		{
-			return true;
-		}
+CCat* CCatManager::GetHoveredCat()
+{
+	return HoveredCat;
+}
 
-		it++;
-	}
+CCat* CCatManager::GetCatAt(glm::vec2 location)
+{
+	return Grid.GetCatAt(location);
+}
 
-	return false;
+void CCatManager::GetCatsInRadius(glm::vec2 centre, float radius, FrameVector<CCat*>& cats)
+{
+	Grid.GetCatsInRadius(centre, radius, cats);
 }
 
 void CCatManager::GenerateCatConfigSettings()
 {
 	CatConfigSettings = new CConfigSettings();
 	CatConfigSettings->SetDefaultFilename("");
-	CatConfigSettings->SetFileLocation(CAT_FILE_LOCATION);
+	CatConfigSettings->SetFileLocation(CatFolder);
 
 	// Floats
 	CatConfigSettings->AddDefaultFloatVariable("max-jump-height", 400.0f);
@@ -359,6 +496,7 @@ void CCatManager::CalculateHues()
 
 		glGenTextures(1, &id);
 		glBindTexture(GL_TEXTURE_2D, id);
+		STATS::Count(STATS::ECounter::TextureBinds);
 
 		// Nearest pixel will be chosen (good for pixel art)
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
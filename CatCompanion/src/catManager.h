@@ -1,12 +1,13 @@
 #pragma once
-#include <list>
+#include <vector>
 #include <glm.hpp>
-#include <chrono>
 
 #include "layer.h"
+#include "cat.h"
+#include "catGrid.h"
 
-class CCat;
 class CScene;
+class CIconPipeline;
 class CConfigs;
 class CConfigSettings;
 
@@ -17,6 +18,7 @@ public:
 	CCatManager(CScene* parent);
 	~CCatManager();
 
+	void UpdateParallel() override;
 	void Update() override;
 	void Render() override;
 
@@ -25,7 +27,14 @@ public:
 	void LoadCats();
 
 	CCat* GetFirstCat();
-	void DeleteCat(std::list<CCat*>::iterator it);
+	CCat* GetCat(CatHandle handle); // nullptr if the cat has been removed
+	CCat* GetHoveredCat(); // The cat under the mouse this frame
+	CCat* GetCatAt(glm::vec2 location);
+	void GetCatsInRadius(glm::vec2 centre, float radius, FrameVector<CCat*>& cats);
+	int GetCatCount();
+	SCatMetrics GetMetricsTotal();
+	void DeleteCat(CatHandle handle);
+	CIconPipeline& GetIconPipeline();
 
 	CCat* AddCat(glm::vec2 location, CConfigs* config);
 	CCat* AddCat(glm::vec2 location);
@@ -35,7 +44,15 @@ public:
 
 private:
 	CConfigSettings* CatConfigSettings;
-	std::list<CCat*> Cats;
+	std::string CatFolder;
+	SCatMetrics RemovedCatMetrics;
+	CSlotMap<CCat*> Cats; // Packed in drawing order, removing a cat moves the last cat into its place
+	CCatGrid Grid;
+	CCat* HoveredCat;
+	CIconPipeline* IconPipeline;
+	int CatsStat;
+	int GridCellsStat;
+	int CulledCatsStat;
 
 	// Input variables
 	enum class MouseState
@@ -47,12 +64,13 @@ private:
 
 	bool RMBHeld;
 	MouseState CurrentMouseState;
-	std::chrono::steady_clock::time_point RClickTimePoint;
-	std::list<CCat*>::iterator CurrentlySelectedCat;
+	double RClickTime; // Simulation seconds the right mouse button went down at
+	CCat* CurrentlySelectedCat;
 
 
 	void CalculateHues();
-	bool GetHoveredCat(std::list<CCat*>::iterator& it);
+	void UpdateGrid();
+	CCat* InsertCat(CCat* cat);
 	void GenerateCatConfigSettings();
 };
 
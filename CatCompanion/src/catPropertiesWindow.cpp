@@ -28,6 +28,7 @@ CCatPropertiesWindow::CCatPropertiesWindow(CCatManager* catManager) :
 	CTexture* mainTex = CTexture::GetTexture("PropertiesWindow");
 	UpdateUniformTexture("tex", mainTex->GetID());
 
+	CatManager = catManager;
 	ColourBoxTexture = CTexture::GetTexture("ColourBox");
 	NumberOfColours = catManager->NumberOfColours;
 	State = WindowState::Waiting;
@@ -84,7 +85,7 @@ CCatPropertiesWindow::CCatPropertiesWindow(CCatManager* catManager) :
 	duplicateButton->SetOnEnter([duplicateButton]() { duplicateButton->SetTexture(1); });
 	duplicateButton->SetOnLeave([duplicateButton]() { duplicateButton->SetTexture(0); });
 	duplicateButton->SetOnHover([duplicateButton, this]() { FM.SetFocused(); });
-	duplicateButton->SetOnPress([this]() { ParentCat->Duplicate(); });
+	duplicateButton->SetOnPress([this]() { CCat* cat = CatManager->GetCat(ParentCat); IfThenStatement(cat != nullptr, cat->Duplicate()); });
 	duplicateButton->Scale *= 2.0f;
 	duplicateButton->UpdateBounds();
 	Children.push_back(duplicateButton);
@@ -94,7 +95,7 @@ CCatPropertiesWindow::CCatPropertiesWindow(CCatManager* catManager) :
 	binButton->SetOnEnter([binButton]() { binButton->SetTexture(1); });
 	binButton->SetOnLeave([binButton]() { binButton->SetTexture(0); });
 	binButton->SetOnHover([binButton, this]() { FM.SetFocused(); });
-	binButton->SetOnPress([this]() { IsVisible = false; ParentCat->Delete(); });
+	binButton->SetOnPress([this]() { IsVisible = false; CatManager->DeleteCat(ParentCat); });
 	binButton->Scale *= 2.0f;
 	binButton->UpdateBounds();
 	Children.push_back(binButton);
@@ -104,6 +105,13 @@ void CCatPropertiesWindow::Update()
 {
 	IfThenReturn(!IsVisible, );
 
+	// The cat and its configs have gone, there's nothing left to edit
+	if (CatManager->GetCat(ParentCat) == nullptr)
+	{
+		IsVisible = false;
+		return;
+	}
+
 	UpdateFocus();
 	UpdateMoveWindow();
 	UpdateColours();
@@ -140,8 +148,9 @@ void CCatPropertiesWindow::SetVisible(CCat* cat)
 {
 	Location = cat->Location - glm::vec3(0.0f, 200.0f, 0.0f) - Scale * 0.5f;
 	Location = glm::clamp(Location, glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(CCamera::GetScreenSize() - glm::vec2(Scale.x, Scale.y), 0.0f));
+	ResetInterpolation(); // Opens next to the cat rather than sliding over from where it was last shown
 
-	ParentCat = cat;
+	ParentCat = cat->GetHandle();
 	CurrentConfig = cat->GetConfigs();
 
 	NumberOfColours = cat->GetNumberOfColours();
@@ -151,8 +160,8 @@ void CCatPropertiesWindow::SetVisible(CCat* cat)
 		Colours[i] = cat->GetColour(i);
 	}
 
-	ScaleSlider->SetValue(ParentCat->Scale.x);
-	NameBox->SetText(ParentCat->GetName());
+	ScaleSlider->SetValue(cat->Scale.x);
+	NameBox->SetText(cat->GetName());
 
 	IsVisible = true;
 }
@@ -161,12 +170,15 @@ void CCatPropertiesWindow::UpdateFocus()
 {
 	glm::ivec2 mouseLoc = GINPUT::GetMouseLocation() - glm::vec2(Location);
 
-	if (HELPER::InBounds(mouseLoc, DragArea * WindowScale) ||
-		HELPER::InBounds(mouseLoc, WindowArea * WindowScale))
-	{
-		FM.SetFocused();
-	}
-	else if (ColourPicker->GetIsVisible())
+	// The focus manager checks the cursor against these
+	glm::ivec4 offset = glm::ivec4(Location.x, Location.y, Location.x, Location.y);
+	glm::ivec4 drag = DragArea * WindowScale + offset;
+	glm::ivec4 window = WindowArea * WindowScale + offset;
+
+	FM.AddInteractiveRect(RECT{ drag.x, drag.y, drag.z, drag.w });
+	FM.AddInteractiveRect(RECT{ window.x, window.y, window.z, window.w });
+
+	if (ColourPicker->GetIsVisible())
 	{
 		glm::vec2 delta = mouseLoc - glm::ivec2(ColourPicker->Location);
 		float length = glm::length(delta);
@@ -297,14 +309,18 @@ void CCatPropertiesWindow::DrawColours()
 
 void CCatPropertiesWindow::Apply()
 {
+	IsVisible = false;
+
+	CCat* cat = CatManager->GetCat(ParentCat);
+	IfThenReturn(cat == nullptr, );
+
 	for (int i = 1; i <= NumberOfColours; ++i)
 	{
-		ParentCat->SetColour(i, Colours[i]);
+		cat->SetColour(i, Colours[i]);
 	}
 
-	ParentCat->SetName(NameBox->GetText());
-	ParentCat->Scale = glm::vec3(CatScale, CatScale, 1.0f);
-	IsVisible = false;
+	cat->SetName(NameBox->GetText());
+	cat->Scale = glm::vec3(CatScale, CatScale, 1.0f);
 
 	Save();
 }
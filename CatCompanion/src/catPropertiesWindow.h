@@ -1,7 +1,7 @@
 #pragma once
 #include "object.h"
+#include "cat.h"
 
-class CCat;
 class CFocusManager;
 class CMonitorManager;
 class CTexture;
@@ -54,7 +54,8 @@ private:
     CSlider* ScaleSlider;
 
     std::vector<CObject*> Children;
-    CCat* ParentCat;
+    CCatManager* CatManager;
+    CatHandle ParentCat; // The cat can be removed while the window is open
 
     CFocusManager& FM;
     CMonitorManager& MM;
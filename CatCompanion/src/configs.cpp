@@ -124,7 +124,10 @@ void CConfigs::LoadVariables()
 
 		if (strs.size() == 2)
 		{
-			if (HELPER::IsFloat(strs[1]))
+			// Settings with a string default stay strings even when the value is a number
+			bool isStringSetting = Settings.DefaultStringVariables.find(strs[0]) != Settings.DefaultStringVariables.end();
+
+			if (!isStringSetting && HELPER::IsFloat(strs[1]))
 			{
 				FloatVariables.insert_or_assign(strs[0], std::stof(strs[1]));
 			}
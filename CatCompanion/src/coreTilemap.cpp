@@ -11,6 +11,7 @@
 #include "coreTilemap.h"
 #include "configs.h"
 #include "scene.h"
+#include "renderStats.h"
 
 #define TILEMAP_SCALE 2.0f
 
@@ -125,6 +126,7 @@ void CCoreTilemap::Render()
 	// Set Texture
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, TileTexture->GetID());
+	STATS::Count(STATS::ECounter::TextureBinds);
 	glUniform1i(TileShader->GetUniform("tex"), 0);
 
 	// Set Boundry
@@ -158,6 +160,7 @@ void CCoreTilemap::Render()
 			glUniform4i(rectID, rect.x, rect.y, rect.z, rect.w);
 
 			glDrawElements(GL_TRIANGLES, tempIndicieCount, GL_UNSIGNED_INT, 0);
+			STATS::Count(STATS::ECounter::DrawCalls);
 		}
 	}
 
@@ -174,6 +177,10 @@ void CCoreTilemap::Render()
 
 void CCoreTilemap::Update()
 {
+	// The taskbar height can only change with the monitor layout
+	IfThenReturn(MM.GetTopologyVersion() == TopologyVersion, );
+	TopologyVersion = MM.GetTopologyVersion();
+
 	int newOffset = BaseOffset - MM.GetMonitorDetail(ParentMonitor).TaskBarHeight;
 
 	if (Offset.y != newOffset)
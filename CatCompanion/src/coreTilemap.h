@@ -106,6 +106,7 @@ private:
 
 	glm::ivec2 Offset; // The offset of the entire grid
 	int BaseOffset;
+	unsigned int TopologyVersion = 0; // Monitor layout the offset was last worked out for
 	
 	CProgram* TileShader;
 	CMesh* TileMesh;
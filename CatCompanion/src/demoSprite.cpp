@@ -8,16 +8,14 @@ CDemoSprite::CDemoSprite(CSprite* parentSprite, glm::vec2 location)
 	Location = glm::vec3(location, 0.0f);
 	Scale = parentSprite->Scale;
 
-	Animations = parentSprite->GetAnimations();
-	CurrentAnimation = Animations.begin();
-	PlayAnimation(CurrentAnimation->first);
+	SetAnimationLibrary(parentSprite->GetAnimationLibrary());
+	DemoAnimation = 0;
+	PlayAnimation(DemoAnimation);
 }
 
 void CDemoSprite::Update()
 {
-	std::string index = GetAnimationIndex();
-
-	if (index == "")
+	if (GetAnimationHandle() == NO_ANIMATION)
 	{
 		IncrementAnimation();
 	}
@@ -29,15 +27,14 @@ void CDemoSprite::Update()
 void CDemoSprite::IncrementAnimation()
 {
 	// Increment and loop
-	CurrentAnimation++;
-	IfThenStatement(CurrentAnimation == Animations.end(), CurrentAnimation = Animations.begin());
-	PlayAnimation(CurrentAnimation->first);
+	DemoAnimation = (DemoAnimation + 1) % Library->GetAnimationCount();
+	PlayAnimation(DemoAnimation);
 }
 
-void CDemoSprite::PlayAnimation(std::string name)
+void CDemoSprite::PlayAnimation(AnimationHandle animationHandle)
 {
-	SetAnimationIndex(name);
-	SSpriteAnimation animation = GetAnimation(name); 
+	SetAnimation(animationHandle);
+	const SSpriteAnimation& animation = Library->GetAnimation(animationHandle);
 
 	Pivot = glm::vec3(glm::vec2(GetImageWidth(), GetImageHeight()) * glm::vec2(0.5f, 0.5f), 0.0f);
 	UpdateModelMatrix();
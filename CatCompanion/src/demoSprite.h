@@ -12,9 +12,9 @@ public:
 private:
     void OnAnimationEnd() override;
 
-    void PlayAnimation(std::string name);
+    void PlayAnimation(AnimationHandle animationHandle);
     void IncrementAnimation();
 
-    std::map<std::string, SSpriteAnimation>::iterator CurrentAnimation;
+    AnimationHandle DemoAnimation; // The animation being shown, cycles through the whole library
 };
 
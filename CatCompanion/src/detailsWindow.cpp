@@ -246,10 +246,13 @@ void CDetailsWindow::Update()
 
 	Location = glm::clamp(glm::vec2(Location), glm::zero< glm::vec2>(), glm::vec2(CCamera::GetScreenWidth(), CCamera::GetScreenHeight()) - glm::vec2(BaseTexture->GetDimensions()) * WINDOW_SCALE);
 
-	// Set the windows focus
+	// Set the windows focus, the window itself is part of the interactive region
+	glm::ivec2 botRight = glm::vec2(Location) + glm::vec2(BaseTexture->GetDimensions()) * WINDOW_SCALE;
+	FM.AddInteractiveRect(RECT{ (LONG)Location.x, (LONG)Location.y, botRight.x, botRight.y });
+
 	bool mouseOnObject = (selectedObject != nullptr);
 
-	if (mouseOnWindow || mouseOnObject)
+	if (mouseOnObject)
 	{
 		FM.SetFocused();
 	}
@@ -0,0 +1,153 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "entityBenchmark.h"
+#include "entityStore.h"
+#include "object.h"
+#include "helper.h"
+
+#define BENCHMARK_ENTITIES 100000
+#define BENCHMARK_FRAMES 200
+#define BENCHMARK_DELTA_SECONDS (1.0f / 60.0f)
+#define CHECK_ENTITIES 10000 // Enough to fill several chunks
+
+/*
+	An object moved the way the object model moves cats, by its own virtual Update
+*/
+class CBenchmarkObject : public CObject
+{
+public:
+	glm::vec2 Velocity = glm::vec2(10.0f, 0.0f);
+	glm::vec2 Acceleration = glm::vec2(0.0f, 5000.0f);
+
+	void Update() override
+	{
+		Velocity += Acceleration * BENCHMARK_DELTA_SECONDS;
+		Location += glm::vec3(Velocity * BENCHMARK_DELTA_SECONDS, 0.0f);
+	}
+};
+
+int CEntityBenchmark::Run()
+{
+	Failures = 0;
+
+	bool passed = CheckRowMoves();
+	std::cout << "Entities: row move check " << (passed ? "passed" : "FAILED") << std::endl;
+	IfThenReturn(!passed, 1);
+
+	CompareUpdates(BENCHMARK_ENTITIES, BENCHMARK_FRAMES);
+	return 0;
+}
+
+void CEntityBenchmark::Expect(bool condition, const std::string& description)
+{
+	IfThenReturn(condition, );
+
+	std::cout << "FAILED: " << description << std::endl;
+	Failures++;
+}
+
+/*
+	Moves entities between rows, chunks and archetypes, checking each one still has its own data after
+
+	@return If every check passed
+*/
+bool CEntityBenchmark::CheckRowMoves()
+{
+	CEntityStore store;
+
+	// Each entity's x location is its index, so a row that moved to the wrong place shows up
+	std::vector<EntityHandle> entities;
+
+	for (int i = 0; i < CHECK_ENTITIES; ++i)
+	{
+		EntityHandle entity = store.Create(GetComponentMask<STransform>());
+		store.Get<STransform>(entity)->Location.x = (float)i;
+		entities.push_back(entity);
+	}
+
+	Expect(store.GetEntityCount() == CHECK_ENTITIES, "every entity created");
+	Expect(store.GetArchetypeCount() == 1 && store.GetChunkCount() > 1, "entities share one archetype over several chunks");
+
+	// Destroying fills each gap with the archetype's last row
+	for (int i = 0; i < CHECK_ENTITIES; i += 2)
+	{
+		Expect(store.Destroy(entities[i]), "destroying a live entity");
+		Expect(!store.Destroy(entities[i]), "destroying an entity twice fails");
+		Expect(store.Get<STransform>(entities[i]) == nullptr && !store.IsAlive(entities[i]), "a destroyed entity's handle is stale");
+	}
+
+	// Adding a component moves the entity to another archetype, removing it moves the entity back
+	for (int i = 1; i < CHECK_ENTITIES; i += 4)
+	{
+		SVelocity* velocity = store.Add<SVelocity>(entities[i]);
+		Expect(velocity != nullptr && velocity->Velocity == glm::vec2(), "an added component starts with its defaults");
+		IfThenStatement(velocity != nullptr, velocity->Velocity.x = (float)i);
+	}
+
+	Expect(store.GetArchetypeCount() == 2, "adding a component makes a new archetype");
+
+	for (int i = 1; i < CHECK_ENTITIES; i += 8)
+	{
+		Expect(store.Remove<SVelocity>(entities[i]), "removing a component");
+		Expect(store.Get<SVelocity>(entities[i]) == nullptr, "a removed component is gone");
+	}
+
+	for (int i = 1; i < CHECK_ENTITIES; i += 2)
+	{
+		STransform* transform = store.Get<STransform>(entities[i]);
+		Expect(transform != nullptr && transform->Location.x == (float)i, "entity " + std::to_string(i) + " kept its transform");
+
+		SVelocity* velocity = store.Get<SVelocity>(entities[i]);
+		bool hasVelocity = (i % 4 == 1) && (i % 8 != 1);
+		Expect((velocity != nullptr) == hasVelocity, "entity " + std::to_string(i) + " has the right components");
+		IfThenStatement(velocity != nullptr, Expect(velocity->Velocity.x == (float)i, "entity " + std::to_string(i) + " kept its velocity"));
+	}
+
+	// Systems see every entity with the components they ask for exactly once
+	int transforms = 0;
+	store.ForEach<STransform>([&transforms](int count, STransform*) { transforms += count; });
+	Expect(transforms == CHECK_ENTITIES / 2 && store.GetEntityCount() == CHECK_ENTITIES / 2, "every live entity is visited once");
+
+	return Failures == 0;
+}
+
+/*
+	Times moving the same number of entities through the entity store and through heap objects. The objects
+	are updated in a shuffled order, objects made over a long run end up spread around the heap
+
+	@param entityCount Entities in each model
+	@param frames Updates to average over
+*/
+void CEntityBenchmark::CompareUpdates(int entityCount, int frames)
+{
+	CEntityStore store;
+	ComponentMask components = GetComponentMask<STransform, SVelocity>();
+
+	for (int i = 0; i < entityCount; ++i)
+	{
+		EntityHandle entity = store.Create(components);
+		store.Get<SVelocity>(entity)->Velocity = glm::vec2(10.0f, 0.0f);
+		store.Get<SVelocity>(entity)->Acceleration = glm::vec2(0.0f, 5000.0f);
+	}
+
+	std::vector<CObject*> objects;
+	for (int i = 0; i < entityCount; ++i) { objects.push_back(new CBenchmarkObject()); }
+	std::shuffle(objects.begin(), objects.end(), std::mt19937(1));
+
+	auto start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < frames; ++frame) { ENTITIES::IntegrateVelocity(store, BENCHMARK_DELTA_SECONDS); }
+	double storeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+
+	start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < frames; ++frame) { std::for_each(objects.begin(), objects.end(), [](CObject* obj) { obj->Update(); }); }
+	double objectMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+
+	std::cout << "Entities: " << entityCount << " entities over " << frames << " frames" << std::endl;
+	std::cout << "Entities: entity store " << storeMilliseconds << " ms a frame, objects " << objectMilliseconds << " ms a frame" << std::endl;
+
+	for (CObject* obj : objects) { delete obj; }
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <string>
+
+class CEntityStore;
+
+/*
+	Checks the entity store and compares it against the object model, run with "--entity-benchmark".
+	The check moves rows through creating, destroying, adding and removing components and makes sure
+	every entity keeps its data. The benchmark then moves 100k entities through the entity store's
+	systems and through the same number of objects updated by virtual call, like an instance layer does
+*/
+class CEntityBenchmark
+{
+public:
+	int Run(); // Returns the exit code for the program, 1 if the check failed
+
+private:
+	int Failures = 0;
+
+	bool CheckRowMoves();
+	void CompareUpdates(int entityCount, int frames);
+
+	void Expect(bool condition, const std::string& description);
+};
@@ -1,4 +1,13 @@
+#include <algorithm>
+
 #include "focusManager.h"
+#include "CatWindow.h"
+#include "configs.h"
+#include "helper.h"
+#include "input.h"
+#include "renderStats.h"
+
+#define FOCUS_RELEASE_FRAMES 3
 
 CFocusManager* CFocusManager::Instance;
 
@@ -21,11 +30,45 @@ void CFocusManager::DestroyInstance()
 
 CFocusManager::~CFocusManager()
 {
+	delete Backend;
+	Backend = nullptr;
+}
+
+static bool IsSameRegion(const std::vector<RECT>& a, const std::vector<RECT>& b)
+{
+	IfThenReturn(a.size() != b.size(), false);
+
+	for (int i = 0; i < (int)a.size(); ++i)
+	{
+		IfThenReturn(!EqualRect(&a[i], &b[i]), false);
+	}
+
+	return true;
 }
 
 void CFocusManager::Update()
 {
-	SetWindowState(NewFocus);
+	glm::ivec2 mouse = GINPUT::GetMouseLocation();
+	bool regionChanged = !IsSameRegion(Region, LastRegion);
+
+	// The cursor only needs testing again if it or the region moved
+	if (regionChanged || mouse != LastMouse)
+	{
+		MouseInRegion = std::any_of(Region.begin(), Region.end(), [mouse](const RECT& rect) { return HELPER::InBounds(mouse, rect); });
+	}
+
+	if (regionChanged)
+	{
+		Backend->SetRegion(Region);
+		STATS::SetValue(RegionRectsStat, (int)Region.size());
+	}
+
+	ReleaseFrames = NewFocus || MouseInRegion ? FOCUS_RELEASE_FRAMES : std::max(ReleaseFrames - 1, 0);
+	SetWindowState(ReleaseFrames > 0);
+
+	LastMouse = mouse;
+	std::swap(Region, LastRegion);
+	Region.clear();
 	NewFocus = false;
 }
 
@@ -39,38 +82,82 @@ void CFocusManager::SetFocused()
 	NewFocus = true;
 }
 
+void CFocusManager::AddInteractiveRect(const RECT& rect)
+{
+	Region.push_back(rect);
+}
+
+void CFocusManager::SetBackend(IInputBackend* backend)
+{
+	delete Backend;
+	Backend = backend;
+
+	// The new backend starts from nothing, so give it the current state
+	Backend->SetRegion(LastRegion);
+	Backend->SetClickThrough(!CurrentFocus);
+}
+
 void CFocusManager::SetWindowState(bool isFocused)
 {
 	if (CurrentFocus != isFocused)
 	{
 		CurrentFocus = isFocused;
-		//SetWindowLong(WindowHwnd, GWL_EXSTYLE, isFocused ? CurStyleFocused : CurStyleUnfocused);
-
-		if (isFocused)
-		{
-			LONG cur_style = GetWindowLong(WindowHwnd, GWL_EXSTYLE);
-			SetWindowLong(WindowHwnd, GWL_EXSTYLE, cur_style ^ WS_EX_TRANSPARENT ^ WS_EX_LAYERED);
-		}
-		else
-		{
-			LONG cur_style = GetWindowLong(WindowHwnd, GWL_EXSTYLE);
-			SetWindowLong(WindowHwnd, GWL_EXSTYLE, cur_style | WS_EX_TRANSPARENT | WS_EX_LAYERED);
-		}
+		Backend->SetClickThrough(!isFocused);
 	}
 }
 
-CFocusManager::CFocusManager() :
-	WindowHwnd(CScene::hWnd)
+CFocusManager::CFocusManager()
 {
-	LONG curStyle = GetWindowLong(CScene::hWnd, GWL_EXSTYLE);
-	CurStyleFocused = curStyle ^ WS_EX_TRANSPARENT ^ WS_EX_LAYERED;
-	CurStyleUnfocused = curStyle | WS_EX_TRANSPARENT | WS_EX_LAYERED;
+	// A hidden window is never clicked, so it is left alone
+	bool isHidden = CGlobalVariables::ConfigSetting->GetStringVariable("window") == "hidden";
+	Backend = isHidden ? (IInputBackend*)new CHeadlessInputBackend() : new CWin32InputBackend(CScene::hWnd);
+
+	RegionRectsStat = STATS::RegisterValue("Input Region Rects");
 }
 
 CFocusManager::CFocusManager(CFocusManager const&) :
-	WindowHwnd(CScene::hWnd)
+	Backend(new CWin32InputBackend(CScene::hWnd)), RegionRectsStat(0)
+{
+}
+
+/*
+	Works out both styles once, switching is then a single SetWindowLong
+*/
+CWin32InputBackend::CWin32InputBackend(HWND hWnd) :
+	WindowHwnd(hWnd)
+{
+	LONG curStyle = GetWindowLong(hWnd, GWL_EXSTYLE);
+	StyleFocused = curStyle & ~(WS_EX_TRANSPARENT | WS_EX_LAYERED);
+	StyleUnfocused = curStyle | WS_EX_TRANSPARENT | WS_EX_LAYERED;
+}
+
+void CWin32InputBackend::SetClickThrough(bool clickThrough)
+{
+	SetWindowLong(WindowHwnd, GWL_EXSTYLE, clickThrough ? StyleUnfocused : StyleFocused);
+}
+
+void CHeadlessInputBackend::SetClickThrough(bool clickThrough)
 {
-	LONG curStyle = GetWindowLong(CScene::hWnd, GWL_EXSTYLE);
-	CurStyleFocused = curStyle ^ WS_EX_TRANSPARENT ^ WS_EX_LAYERED;
-	CurStyleUnfocused = curStyle | WS_EX_TRANSPARENT | WS_EX_LAYERED;
-}
\ No newline at end of file
+	ChangeCount += ClickThrough != clickThrough ? 1 : 0;
+	ClickThrough = clickThrough;
+}
+
+void CHeadlessInputBackend::SetRegion(const std::vector<RECT>& region)
+{
+	Region = region;
+}
+
+bool CHeadlessInputBackend::GetClickThrough()
+{
+	return ClickThrough;
+}
+
+const std::vector<RECT>& CHeadlessInputBackend::GetRegion()
+{
+	return Region;
+}
+
+int CHeadlessInputBackend::GetChangeCount()
+{
+	return ChangeCount;
+}
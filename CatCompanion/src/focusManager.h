@@ -1,8 +1,65 @@
 #pragma once
+#include <vector>
+#include <glm.hpp>
 #include <Windows.h>
 
 #include "scene.h"
 
+/*
+	Whatever actually lets clicks through the cat window. The focus manager only calls it with changes:
+	click through is set when the cursor enters or leaves the interactive region, and the region when its
+	rectangles change
+*/
+class IInputBackend
+{
+public:
+	virtual ~IInputBackend() {}
+
+	virtual void SetClickThrough(bool clickThrough) = 0;
+	virtual void SetRegion(const std::vector<RECT>& region) = 0;
+};
+
+/*
+	Switches the cat window's transparent style. Windows can't take a per region hit test from another
+	process's window without clipping what it draws (SetWindowRgn), so the region is only used to decide
+	when to switch and isn't passed on
+*/
+class CWin32InputBackend : public IInputBackend
+{
+public:
+	CWin32InputBackend(HWND hWnd);
+
+	void SetClickThrough(bool clickThrough) override;
+	void SetRegion(const std::vector<RECT>& region) override {}
+
+private:
+	HWND WindowHwnd;
+	LONG StyleFocused;
+	LONG StyleUnfocused;
+};
+
+// Keeps what it was last given without touching a window, for hidden windows and for checking the focus logic
+class CHeadlessInputBackend : public IInputBackend
+{
+public:
+	void SetClickThrough(bool clickThrough) override;
+	void SetRegion(const std::vector<RECT>& region) override;
+
+	bool GetClickThrough();
+	const std::vector<RECT>& GetRegion();
+	int GetChangeCount(); // Click through switches so far
+
+private:
+	bool ClickThrough = true;
+	std::vector<RECT> Region;
+	int ChangeCount = 0;
+};
+
+/*
+	Decides each frame whether the cat window takes the mouse. Anything that can be clicked adds its rectangle
+	to the interactive region as it updates, the cursor being inside it gives the window focus. Focus is held for
+	a few frames after the cursor leaves so something moving out from under a still cursor doesn't flicker it
+*/
 class CFocusManager
 {
 public:
@@ -14,18 +71,26 @@ public:
 	void Update();
 
 	bool GetIsFocused();
-	void SetFocused();
-	
+	void SetFocused(); // Focus for this frame whatever the region, for things that aren't rectangles
+	void AddInteractiveRect(const RECT& rect); // Cat window coordinates, only for this frame
+
+	void SetBackend(IInputBackend* backend); // Takes ownership
+
 private:
 	static CFocusManager* Instance;
 
-	HWND& WindowHwnd;
+	IInputBackend* Backend;
 
-	LONG CurStyleFocused;
-	LONG CurStyleUnfocused;
+	std::vector<RECT> Region;
+	std::vector<RECT> LastRegion;
+	glm::ivec2 LastMouse = glm::ivec2(-1);
+	bool MouseInRegion = false;
 
 	bool CurrentFocus = false;
 	bool NewFocus = false;
+	int ReleaseFrames = 0; // Frames left before focus is let go
+
+	int RegionRectsStat;
 
 	CFocusManager();
 	CFocusManager(CFocusManager const&);
@@ -0,0 +1,138 @@
+#include <algorithm>
+
+#include "hueHistogram.h"
+
+// SSE2 is always there on x64, HUE_NO_SIMD builds the plain version to check it against
+#if !defined(HUE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define HUE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define HUE_BLOCK 256 // Pixels worked out at a time, small enough for the block to stay in the L1 cache
+
+#ifdef HUE_SSE2
+// Picks a where the mask is set and b everywhere else
+static __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/*
+	Works out the hues of four pixels at once, the same steps as the plain version in the same order so
+	the results match it exactly
+
+	@return The number of pixels worked out, the rest are left for the plain version
+*/
+static int CalculateHuesSSE2(const unsigned char* bgra, int count, int* out)
+{
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 four = _mm_set1_ps(4.0f);
+	const __m128 sixty = _mm_set1_ps(60.0f);
+	const __m128 full = _mm_set1_ps(360.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128i hueCount = _mm_set1_epi32(HUE_COUNT);
+
+	int i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i pixels = _mm_loadu_si128((const __m128i*)(bgra + i * 4));
+
+		__m128 b = _mm_cvtepi32_ps(_mm_and_si128(pixels, byteMask));
+		__m128 g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), byteMask));
+		__m128 r = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), byteMask));
+
+		__m128 max = _mm_max_ps(_mm_max_ps(r, g), b);
+		__m128 min = _mm_min_ps(_mm_min_ps(r, g), b);
+		__m128 delta = _mm_sub_ps(max, min);
+		__m128 hasHue = _mm_cmpgt_ps(delta, zero);
+		__m128 safeDelta = Select(hasHue, delta, one);
+
+		__m128 fromRed = _mm_div_ps(_mm_sub_ps(g, b), safeDelta);
+		__m128 fromGreen = _mm_add_ps(two, _mm_div_ps(_mm_sub_ps(b, r), safeDelta));
+		__m128 fromBlue = _mm_add_ps(four, _mm_div_ps(_mm_sub_ps(r, g), safeDelta));
+
+		__m128 hue = _mm_mul_ps(Select(_mm_cmpeq_ps(max, r), fromRed, Select(_mm_cmpeq_ps(max, g), fromGreen, fromBlue)), sixty);
+		hue = Select(_mm_cmplt_ps(hue, zero), _mm_add_ps(hue, full), hue);
+		hue = _mm_and_ps(hasHue, hue);
+
+		// Rounding up to 360 is the same hue as 0
+		__m128i rounded = _mm_cvttps_epi32(_mm_add_ps(hue, half));
+		rounded = _mm_sub_epi32(rounded, _mm_andnot_si128(_mm_cmplt_epi32(rounded, hueCount), hueCount));
+
+		_mm_storeu_si128((__m128i*)(out + i), rounded);
+	}
+
+	return i;
+}
+#endif
+
+/*
+	Works out the hues of a block of pixels. There are no branches, each case is worked out and the right
+	one picked, the SSE2 version does four pixels at a time this way and the plain loop does what's left
+*/
+static void CalculateHues(const unsigned char* bgra, int count, int* out)
+{
+	int start = 0;
+
+#ifdef HUE_SSE2
+	start = CalculateHuesSSE2(bgra, count, out);
+#endif
+
+	for (int i = start; i < count; ++i)
+	{
+		float b = bgra[i * 4 + 0];
+		float g = bgra[i * 4 + 1];
+		float r = bgra[i * 4 + 2];
+
+		float max = std::max(std::max(r, g), b);
+		float min = std::min(std::min(r, g), b);
+		float delta = max - min;
+		float safeDelta = delta > 0.0f ? delta : 1.0f;
+
+		float fromRed = (g - b) / safeDelta;
+		float fromGreen = 2.0f + (b - r) / safeDelta;
+		float fromBlue = 4.0f + (r - g) / safeDelta;
+
+		float hue = (max == r ? fromRed : (max == g ? fromGreen : fromBlue)) * 60.0f;
+		hue = hue < 0.0f ? hue + 360.0f : hue;
+		hue = delta > 0.0f ? hue : 0.0f;
+
+		// Rounding up to 360 is the same hue as 0
+		int rounded = (int)(hue + 0.5f);
+		out[i] = rounded < HUE_COUNT ? rounded : rounded - HUE_COUNT;
+	}
+}
+
+void HELPER::CountHues(const unsigned char* bgra, int pixelCount, int* hues)
+{
+	int block[HUE_BLOCK];
+
+	// Counting into several histograms stops each increment waiting on the last one when neighbouring pixels share a hue
+	int partial[4][HUE_COUNT] = {};
+
+	for (int start = 0; start < pixelCount; start += HUE_BLOCK)
+	{
+		int count = std::min(HUE_BLOCK, pixelCount - start);
+		CalculateHues(bgra + start * 4, count, block);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			partial[0][block[i + 0]]++;
+			partial[1][block[i + 1]]++;
+			partial[2][block[i + 2]]++;
+			partial[3][block[i + 3]]++;
+		}
+
+		for (; i < count; ++i) { partial[0][block[i]]++; }
+	}
+
+	for (int hue = 0; hue < HUE_COUNT; ++hue)
+	{
+		hues[hue] += partial[0][hue] + partial[1][hue] + partial[2][hue] + partial[3][hue];
+	}
+}
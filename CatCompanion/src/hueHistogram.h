@@ -0,0 +1,12 @@
+#pragma once
+
+#define HUE_COUNT 360
+
+namespace HELPER
+{
+	/*
+		Adds every pixel of a 32 bit BGRA buffer to a histogram of hues, the same hues GetHue gives.
+		Only plain arrays are used so it can be run on any buffer, without a window or an icon
+	*/
+	void CountHues(const unsigned char* bgra, int pixelCount, int* hues);
+}
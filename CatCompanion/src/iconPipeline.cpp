@@ -0,0 +1,229 @@
+#include <Windows.h>
+#include <shellapi.h>
+#include <objbase.h>
+
+#include "iconPipeline.h"
+#include "catManager.h"
+#include "helper.h"
+#include "profiler.h"
+#include "renderStats.h"
+
+#define ICON_CACHE_SIZE 32 // Icons kept once no cat is using them
+#define ICON_UPLOAD_BUDGET (256 * 1024) // Bytes of texture uploaded a frame, at least one icon always goes
+
+// FNV-1a over the size and pixels, two files with the same icon share a texture
+static unsigned long long HashPixels(const SIconPixels& pixels)
+{
+	unsigned long long hash = 14695981039346656037ull;
+	auto add = [&hash](unsigned char byte) { hash = (hash ^ byte) * 1099511628211ull; };
+
+	for (int i = 0; i < 4; ++i) { add((unsigned char)(pixels.Width >> (i * 8))); }
+	for (int i = 0; i < 4; ++i) { add((unsigned char)(pixels.Height >> (i * 8))); }
+	for (unsigned char byte : pixels.Bgra) { add(byte); }
+
+	return hash;
+}
+
+CIconPipeline::CIconPipeline(CCatManager* catManager) :
+	CatManager(catManager)
+{
+	CachedIconsStat = STATS::RegisterValue("Cached Icons");
+	IconUploadsStat = STATS::RegisterValue("Icon Uploads");
+
+	DecodeThread = std::thread(&CIconPipeline::DecodeLoop, this);
+}
+
+CIconPipeline::~CIconPipeline()
+{
+	// Icons still waiting are dropped, the one being read is finished first as the thread writes back into the pipeline
+	{
+		std::lock_guard<std::mutex> lock(RequestsLock);
+		Stopping = true;
+		Requests.clear();
+	}
+
+	RequestsCondition.notify_one();
+	IfThenStatement(DecodeThread.joinable(), DecodeThread.join());
+
+	for (SCachedIcon& icon : Cache) { glDeleteTextures(1, &icon.Texture); }
+}
+
+/*
+	Starts reading a file's icon for a cat, the cat is given it once it's ready
+
+	@param cat The cat the file was dropped on
+	@param path The dropped file
+*/
+void CIconPipeline::Request(CatHandle cat, const std::wstring& path)
+{
+	{
+		std::lock_guard<std::mutex> lock(RequestsLock);
+		Requests.push_back({ cat, path });
+	}
+
+	RequestsCondition.notify_one();
+}
+
+/*
+	Reads the requested icons one at a time until the pipeline is destroyed
+*/
+void CIconPipeline::DecodeLoop()
+{
+	// The shell reads some icons through COM
+	HRESULT com = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
+
+	while (true)
+	{
+		SRequest request;
+
+		{
+			std::unique_lock<std::mutex> lock(RequestsLock);
+			RequestsCondition.wait(lock, [this]() { return Stopping || !Requests.empty(); });
+			IfThenStatement(Stopping, break);
+
+			request = std::move(Requests.front());
+			Requests.pop_front();
+		}
+
+		Decode(request.Cat, request.Path);
+	}
+
+	IfThenStatement(SUCCEEDED(com), CoUninitialize());
+}
+
+void CIconPipeline::Decode(CatHandle cat, const std::wstring& path)
+{
+	PROFILE_SCOPE("CIconPipeline::Decode");
+
+	// The path buffer can be written to with the path of the file the icon came from
+	wchar_t buffer[MAX_PATH] = {};
+	path.copy(buffer, MAX_PATH - 1);
+
+	WORD index = 0;
+	HICON icon = ExtractAssociatedIcon(GetModuleHandle(NULL), buffer, &index);
+	IfThenReturn(icon == NULL, );
+
+	SDecodedIcon decoded;
+	decoded.Cat = cat;
+	BOOL read = HELPER::GetIconPixels(icon, decoded.Pixels);
+	DestroyIcon(icon);
+	IfThenReturn(!read, );
+
+	decoded.Hash = HashPixels(decoded.Pixels);
+
+	std::lock_guard<std::mutex> lock(DecodedLock);
+	Decoded.push_back(std::move(decoded));
+}
+
+/*
+	Hands finished icons to their cats, uploading the ones that aren't cached until the frame's budget is spent
+*/
+void CIconPipeline::Update()
+{
+	PROFILE_SCOPE("CIconPipeline::Update");
+
+	{
+		std::lock_guard<std::mutex> lock(DecodedLock);
+		for (SDecodedIcon& icon : Decoded) { Uploads.push_back(std::move(icon)); }
+		Decoded.clear();
+	}
+
+	size_t uploaded = 0;
+	int uploads = 0;
+
+	while (!Uploads.empty())
+	{
+		SDecodedIcon& icon = Uploads.front();
+		SCachedIcon* cached = Find(icon.Hash);
+
+		if (cached == nullptr)
+		{
+			size_t size = icon.Pixels.Bgra.size();
+			IfThenStatement(uploads > 0 && uploaded + size > ICON_UPLOAD_BUDGET, break);
+
+			cached = &Upload(icon);
+			uploaded += size;
+			uploads++;
+		}
+
+		Deliver(icon.Cat, *cached);
+		Uploads.pop_front();
+	}
+
+	Evict();
+
+	STATS::SetValue(CachedIconsStat, (int)Cache.size());
+	STATS::SetValue(IconUploadsStat, uploads);
+}
+
+void CIconPipeline::Release(unsigned long long hash)
+{
+	auto it = CacheLookup.find(hash);
+	IfThenStatement(it != CacheLookup.end() && it->second->Users > 0, it->second->Users--);
+}
+
+// Finds a cached icon and makes it the most recently used
+CIconPipeline::SCachedIcon* CIconPipeline::Find(unsigned long long hash)
+{
+	auto it = CacheLookup.find(hash);
+	IfThenReturn(it == CacheLookup.end(), nullptr);
+
+	Cache.splice(Cache.begin(), Cache, it->second);
+	return &Cache.front();
+}
+
+CIconPipeline::SCachedIcon& CIconPipeline::Upload(SDecodedIcon& icon)
+{
+	const SIconPixels& pixels = icon.Pixels;
+	GLuint textureID = 0;
+
+	// Generate a new texture
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	STATS::Count(STATS::ECounter::TextureBinds);
+
+	// Pixel alignment
+	glPixelStorei(GL_UNPACK_SWAP_BYTES, GL_FALSE);
+	glPixelStorei(GL_UNPACK_LSB_FIRST, GL_TRUE);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	// Generate the texture
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pixels.Width, pixels.Height, 0, GL_BGRA, GL_UNSIGNED_BYTE, pixels.Bgra.data());
+
+	// Specify the min mag filters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	Cache.push_front(SCachedIcon{ icon.Hash, textureID, 0 });
+	CacheLookup[icon.Hash] = Cache.begin();
+	return Cache.front();
+}
+
+/*
+	Gives a cat its icon, unless the cat has gone or got busy with something else while it was being read
+*/
+void CIconPipeline::Deliver(CatHandle handle, SCachedIcon& icon)
+{
+	CCat* cat = CatManager->GetCat(handle);
+	IfThenReturn(cat == nullptr || !cat->CanEatIcon(), );
+
+	icon.Users++;
+	cat->EatIcon(icon.Texture, icon.Hash);
+}
+
+// Drops the least recently used icons no cat is using until the cache is back to size
+void CIconPipeline::Evict()
+{
+	for (auto it = Cache.end(); Cache.size() > ICON_CACHE_SIZE && it != Cache.begin();)
+	{
+		--it;
+		IfThenStatement(it->Users > 0, continue);
+
+		glDeleteTextures(1, &it->Texture);
+		CacheLookup.erase(it->Hash);
+		it = Cache.erase(it);
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <glew.h>
+
+#include "catHelper.h"
+#include "cat.h"
+
+class CCatManager;
+
+/*
+	Turns files dropped on cats into icon textures without stalling the frame. A thread of its own reads the
+	file's icon into a pixel buffer and hashes it, then the main thread uploads a few finished icons a frame
+	and hands them to their cats. Reading an icon can block on the disk or the shell for a long time, so it's
+	kept off the job system where the main thread could pick it up while waiting.
+
+	Textures are kept in a least recently used cache keyed by the hash of the icon's pixels, so dropping
+	another file with the same icon costs no upload. A texture a cat is still eating is never evicted
+*/
+class CIconPipeline
+{
+public:
+	CIconPipeline(CCatManager* catManager);
+	~CIconPipeline();
+
+	void Request(CatHandle cat, const std::wstring& path);
+	void Update(); // Once a frame on the main thread, where the GL context is
+
+	void Release(unsigned long long hash); // The cat has finished with the icon's texture
+
+private:
+	struct SRequest
+	{
+		CatHandle Cat;
+		std::wstring Path;
+	};
+
+	struct SDecodedIcon
+	{
+		CatHandle Cat;
+		unsigned long long Hash;
+		SIconPixels Pixels;
+	};
+
+	struct SCachedIcon
+	{
+		unsigned long long Hash;
+		GLuint Texture;
+		int Users; // Cats using the texture right now
+	};
+
+	CCatManager* CatManager;
+
+	std::thread DecodeThread;
+	std::mutex RequestsLock;
+	std::condition_variable RequestsCondition;
+	std::deque<SRequest> Requests; // Waiting to be read by the decode thread
+	bool Stopping = false;
+
+	std::mutex DecodedLock;
+	std::vector<SDecodedIcon> Decoded; // Filled by the decode thread
+	std::deque<SDecodedIcon> Uploads; // Waiting for a frame with room in its upload budget
+
+	std::list<SCachedIcon> Cache; // Most recently used first
+	std::unordered_map<unsigned long long, std::list<SCachedIcon>::iterator> CacheLookup;
+
+	int CachedIconsStat;
+	int IconUploadsStat;
+
+	void DecodeLoop();
+	void Decode(CatHandle cat, const std::wstring& path);
+	SCachedIcon* Find(unsigned long long hash);
+	SCachedIcon& Upload(SDecodedIcon& icon);
+	void Deliver(CatHandle cat, SCachedIcon& icon);
+	void Evict();
+};
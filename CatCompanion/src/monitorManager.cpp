@@ -3,6 +3,8 @@
 #include "CatWindow.h"
 #include "configs.h"
 #include "helper.h"
+#include "profiler.h"
+#include "replay.h"
 
 CMonitorManager* CMonitorManager::Instance = nullptr;
 int CMonitorManager::CurrentMonitorID = 0;
@@ -35,17 +37,46 @@ CMonitorManager::~CMonitorManager()
 
 void CMonitorManager::Update()
 {
+	PROFILE_SCOPE("CMonitorManager::Update");
+
+	// The displays are only looked at again once Windows says they've changed
+	IfThenStatement(DisplaysChanged.exchange(false), RebuildTopology());
+	SyncReplay();
+
 	// Update Mouse Position:
 	glm::vec2 temp = GINPUT::GetMouseLocation();
 	GINPUT::MouseMove(MouseLoc.x, MouseLoc.y);
 	MouseLoc = DesktopToWindow(temp);
 	GINPUT::MouseMove(MouseLoc.x, MouseLoc.y);
+}
+
+void CMonitorManager::OnDisplayChange()
+{
+	DisplaysChanged = true;
+}
+
+void CMonitorManager::RebuildTopology()
+{
+	PROFILE_SCOPE("CMonitorManager::RebuildTopology");
 
-	SetRectEmpty(&Combined);
-	Monitors.clear();
+	Building = SMonitorTopology();
 	CurrentMonitorID = 0;
 
 	EnumDisplayMonitors(NULL, NULL, MonitorEnum, NULL);
+	PublishTopology(std::move(Building));
+}
+
+/*
+	Makes a new snapshot the current one, the one it replaces is freed at the next publish so a reader
+	that took it during the last frame is never left holding freed memory
+*/
+void CMonitorManager::PublishTopology(SMonitorTopology topology)
+{
+	topology.Version = CurrentTopology != nullptr ? CurrentTopology->Version + 1 : 1;
+
+	RetiredTopology = std::move(CurrentTopology);
+	CurrentTopology.reset(new SMonitorTopology(std::move(topology)));
+	Topology.store(CurrentTopology.get(), std::memory_order_release);
 }
 
 //glm::ivec2 CMonitorManager::DesktopToWindow(glm::ivec2 aVec)
@@ -55,7 +86,8 @@ void CMonitorManager::Update()
 
 glm::vec2 CMonitorManager::DesktopToWindow(glm::vec2 aVec)
 {
-	return aVec - glm::vec2(Combined.left, Combined.top);
+	const RECT& combined = GetCombinedRect();
+	return aVec - glm::vec2(combined.left, combined.top);
 }
 
 //glm::ivec2 CMonitorManager::WindowToDesktop(glm::ivec2 aVec)
@@ -65,25 +97,88 @@ glm::vec2 CMonitorManager::DesktopToWindow(glm::vec2 aVec)
 
 glm::vec2 CMonitorManager::WindowToDesktop(glm::vec2 aVec)
 {
-	return aVec + glm::vec2(Combined.left, Combined.top);
+	const RECT& combined = GetCombinedRect();
+	return aVec + glm::vec2(combined.left, combined.top);
+}
+
+const SMonitorTopology& CMonitorManager::GetTopology()
+{
+	return *Topology.load(std::memory_order_acquire);
+}
+
+unsigned int CMonitorManager::GetTopologyVersion()
+{
+	return GetTopology().Version;
+}
+
+const RECT& CMonitorManager::GetCombinedRect()
+{
+	return GetTopology().Combined;
 }
 
-RECT& CMonitorManager::GetCombinedRect()
+const MonitorInfo& CMonitorManager::GetMonitorDetail(int aMonitor)
 {
-	return Combined;
+	return GetTopology().GetDetail(aMonitor);
 }
 
-MonitorInfo& CMonitorManager::GetMonitorDetail(int aMonitor)
+const std::vector<HMONITOR>& CMonitorManager::GetMonitors()
 {
-	MonitorDetailsLock.lock();
-	MonitorInfo& info = MonitorDetails[aMonitor];
-	MonitorDetailsLock.unlock();
-	return info;
+	return GetTopology().Monitors;
+}
+
+const MonitorInfo& SMonitorTopology::GetDetail(int monitor) const
+{
+	static const MonitorInfo Empty = {};
+
+	auto it = Details.find(monitor);
+	return it != Details.end() ? it->second : Empty;
 }
 
-std::vector<HMONITOR>& CMonitorManager::GetMonitors()
+/*
+	Records the monitors in use this step, or swaps them for the recorded ones when a replay is playing.
+	A new snapshot is only published when the recorded monitors differ from the current ones
+*/
+void CMonitorManager::SyncReplay()
 {
-	return Monitors;
+	IfThenReturn(!REPLAY::IsRecording() && !REPLAY::IsPlaying(), );
+
+	struct SMonitorRecord
+	{
+		long long Handle;
+		RECT Monitor;
+		RECT Work;
+	};
+
+	const SMonitorTopology& current = GetTopology();
+	std::vector<char> live(current.Monitors.size() * sizeof(SMonitorRecord));
+	SMonitorRecord* records = (SMonitorRecord*)live.data();
+
+	for (int i = 0; i < (int)current.Monitors.size(); ++i)
+	{
+		const MonitorInfo& info = current.GetDetail((int)current.Monitors[i]);
+		records[i] = SMonitorRecord{ (long long)current.Monitors[i], info.BoundryNTB, info.BoundryTB };
+	}
+
+	std::vector<char> data = live;
+	REPLAY::Sync(REPLAY::EChannel::Monitors, data);
+	IfThenReturn(!REPLAY::IsPlaying() || data == live, );
+
+	SMonitorTopology recorded;
+	records = (SMonitorRecord*)data.data();
+	int count = (int)(data.size() / sizeof(SMonitorRecord));
+
+	for (int i = 0; i < count; ++i)
+	{
+		RECT& monitor = records[i].Monitor;
+		RECT& work = records[i].Work;
+		HMONITOR hMon = (HMONITOR)records[i].Handle;
+
+		recorded.Details.insert_or_assign((int)hMon, MonitorInfo{ monitor, work, monitor.bottom - work.bottom, monitor.right - monitor.left, monitor.bottom - monitor.top });
+		recorded.Monitors.push_back(hMon);
+		UnionRect(&recorded.Combined, &recorded.Combined, &monitor);
+	}
+
+	PublishTopology(std::move(recorded));
 }
 
 void CMonitorManager::InitialiseValidMonitors()
@@ -125,12 +220,9 @@ BOOL CMonitorManager::MonitorEnum(HMONITOR hMon, HDC hdc, LPRECT lprcMonitor, LP
 	GetMonitorInfo(hMon, &info);
 	int tempTaskBarHeight = info.rcMonitor.bottom - info.rcWork.bottom;
 
-	
-	pThis.MonitorDetailsLock.lock();
-	pThis.MonitorDetails.insert_or_assign((int)hMon,  MonitorInfo{ *lprcMonitor, info.rcWork, tempTaskBarHeight, lprcMonitor->right - lprcMonitor->left, lprcMonitor->bottom - lprcMonitor->top });
-	pThis.MonitorDetailsLock.unlock();
-	
-	pThis.Monitors.push_back(hMon);
-	UnionRect(&pThis.Combined, &pThis.Combined, lprcMonitor);
+	SMonitorTopology& building = pThis.Building;
+	building.Details.insert_or_assign((int)hMon, MonitorInfo{ *lprcMonitor, info.rcWork, tempTaskBarHeight, lprcMonitor->right - lprcMonitor->left, lprcMonitor->bottom - lprcMonitor->top });
+	building.Monitors.push_back(hMon);
+	UnionRect(&building.Combined, &building.Combined, lprcMonitor);
 	return TRUE;
 }
@@ -3,7 +3,8 @@
 #include <windows.h>
 #include <map>
 #include <vector>
-#include <mutex>
+#include <atomic>
+#include <memory>
 #include <set>
 
 struct MonitorInfo
@@ -17,6 +18,20 @@ struct MonitorInfo
 	int Height;
 };
 
+/*
+	One version of the monitor layout. A snapshot is never changed once published, a display change
+	publishes a new one with a higher version, so readers on any thread can use it without locking
+*/
+struct SMonitorTopology
+{
+	unsigned int Version = 0;
+	RECT Combined = {}; // Every monitor together, the cat window covers this
+	std::vector<HMONITOR> Monitors;
+	std::map<int, MonitorInfo> Details;
+
+	const MonitorInfo& GetDetail(int monitor) const; // An empty MonitorInfo if the monitor isn't in this version
+};
+
 class CMonitorManager
 {
 public:
@@ -26,6 +41,7 @@ public:
 	~CMonitorManager();
 
 	void Update();
+	void OnDisplayChange(); // Call from the window procedure when the displays or work areas change, safe from any thread
 	
 	//glm::ivec2 DesktopToWindow(glm::ivec2 aVec);
 	glm::vec2 DesktopToWindow(glm::vec2 aVec);
@@ -33,9 +49,16 @@ public:
 	//glm::ivec2 WindowToDesktop(glm::ivec2 aVec);
 	glm::vec2 WindowToDesktop(glm::vec2 aVec);
 
-	RECT& GetCombinedRect();
-	MonitorInfo& GetMonitorDetail(int aMonitor);
-	std::vector<HMONITOR>& GetMonitors();
+	/*
+		The latest snapshot stays valid until the update after the next display change, readers that
+		look at several parts of it should take it once rather than through the calls below
+	*/
+	const SMonitorTopology& GetTopology();
+	unsigned int GetTopologyVersion();
+
+	const RECT& GetCombinedRect();
+	const MonitorInfo& GetMonitorDetail(int aMonitor);
+	const std::vector<HMONITOR>& GetMonitors();
 
 
 private:
@@ -43,16 +66,20 @@ private:
 
 	glm::vec2 MouseLoc;
 
-	RECT Combined;
-	std::map<int, MonitorInfo> MonitorDetails;
-	std::vector<HMONITOR> Monitors;
-	std::mutex MonitorDetailsLock;
+	std::atomic<const SMonitorTopology*> Topology = nullptr;
+	std::unique_ptr<SMonitorTopology> CurrentTopology;
+	std::unique_ptr<SMonitorTopology> RetiredTopology; // Kept for one more display change in case a reader still has it
+	SMonitorTopology Building; // Filled by MonitorEnum
+	std::atomic<bool> DisplaysChanged = true;
 	std::set<int> ValidMonitors;
 
 	CMonitorManager() {};
 	CMonitorManager(CMonitorManager const&) {};
 
 	void InitialiseValidMonitors();
+	void RebuildTopology();
+	void PublishTopology(SMonitorTopology topology);
+	void SyncReplay();
 
 	static int CurrentMonitorID;
 	static BOOL CALLBACK MonitorEnum(HMONITOR hMon, HDC hdc, LPRECT lprcMonitor, LPARAM pData);
@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <set>
+#include <queue>
+#include <tuple>
+
+#include "platformGraph.h"
+#include "helper.h"
+#include "profiler.h"
+
+#define WALK_TOLERANCE 1.0f // Pixels between platforms that still count as touching
+#define JUMP_ROUTE_COST 200.0f // Extra cost of a jump over walking the same distance, routes prefer walking
+
+static bool IsLowerOnScreen(const Platform& a, const Platform& b)
+{
+	return a.Height != b.Height ? a.Height > b.Height : a.Left < b.Left;
+}
+
+static bool IsSamePlatform(const Platform& a, const Platform& b)
+{
+	return a.Left == b.Left && a.Right == b.Right && a.Height == b.Height && a.Hwnd == b.Hwnd;
+}
+
+static bool IsSameSegments(const std::vector<Platform>& a, const std::vector<Platform>& b)
+{
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), IsSamePlatform);
+}
+
+/*
+	Brings the graph up to date with the latest windows, only windows that moved, appeared, disappeared
+	or had their platforms covered differently are recalculated
+
+	@param windowPlatforms Platform segments of each window in cat window coordinates
+	@param windowBounds Bounds of every visible window in desktop coordinates
+	@param origin Desktop location of the cat window's top left
+*/
+void CPlatformGraph::Update(const std::map<HWND, std::vector<Platform>>& windowPlatforms, const std::map<HWND, RECT>& windowBounds, POINT origin)
+{
+	std::set<HWND> changed;
+
+	// Windows that have gone
+	for (auto it = Nodes.begin(); it != Nodes.end();)
+	{
+		if (windowBounds.find(it->first) == windowBounds.end())
+		{
+			changed.insert(it->first);
+			it = Nodes.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	// Windows that are new or have changed
+	for (auto& window : windowBounds)
+	{
+		RECT bounds = window.second;
+		OffsetRect(&bounds, -origin.x, -origin.y);
+
+		auto platforms = windowPlatforms.find(window.first);
+		const std::vector<Platform>& segments = platforms != windowPlatforms.end() ? platforms->second : Empty;
+
+		auto node = Nodes.find(window.first);
+
+		if (node == Nodes.end() || !EqualRect(&node->second.Bounds, &bounds) || !IsSameSegments(node->second.Segments, segments))
+		{
+			SWindowNode& updated = Nodes[window.first];
+			updated.Bounds = bounds;
+			updated.Segments = segments;
+			changed.insert(window.first);
+		}
+	}
+
+	ChangedCount = (int)changed.size();
+	IfThenReturn(changed.empty(), );
+
+	// Every cached route could go through a window that changed
+	Version++;
+	RouteCache.clear();
+	EdgeCount = 0;
+
+	for (auto& node : Nodes)
+	{
+		SWindowNode& source = node.second;
+
+		if (changed.find(node.first) != changed.end())
+		{
+			// Changed windows work out all of their edges again
+			source.JumpTargets.clear();
+			source.WalkTargets.clear();
+
+			for (auto& target : Nodes) { AddEdges(source, node.first, target.second, target.first); }
+		}
+		else
+		{
+			// Everything else only swaps out the edges to the windows that changed
+			for (HWND hwnd : changed) { RemoveEdges(source, hwnd); }
+			for (HWND hwnd : changed)
+			{
+				auto target = Nodes.find(hwnd);
+				IfThenStatement(target != Nodes.end(), AddEdges(source, node.first, target->second, hwnd));
+			}
+		}
+
+		SortEdges(source);
+		EdgeCount += (int)(source.JumpTargets.size() + source.WalkTargets.size());
+	}
+
+	PlatformsByHeight.clear();
+	for (auto& node : Nodes) { PlatformsByHeight.insert(PlatformsByHeight.end(), node.second.Segments.begin(), node.second.Segments.end()); }
+	std::sort(PlatformsByHeight.begin(), PlatformsByHeight.end(), IsLowerOnScreen);
+}
+
+void CPlatformGraph::AddEdges(SWindowNode& source, HWND sourceHwnd, const SWindowNode& target, HWND targetHwnd)
+{
+	IfThenReturn(sourceHwnd == targetHwnd, );
+
+	for (const Platform& segment : target.Segments)
+	{
+		// The cat needs somewhere on its window under the platform to jump up from
+		IfThenStatement(source.Bounds.left < segment.Right && source.Bounds.right > segment.Left, source.JumpTargets.push_back(segment));
+
+		for (const Platform& from : source.Segments)
+		{
+			bool sameHeight = std::abs(from.Height - segment.Height) <= WALK_TOLERANCE;
+			bool touching = std::abs(from.Right - segment.Left) <= WALK_TOLERANCE || std::abs(segment.Right - from.Left) <= WALK_TOLERANCE;
+
+			if (sameHeight && touching)
+			{
+				source.WalkTargets.push_back(segment);
+				break;
+			}
+		}
+	}
+}
+
+void CPlatformGraph::RemoveEdges(SWindowNode& source, HWND targetHwnd)
+{
+	auto isTarget = [targetHwnd](const Platform& p) { return p.Hwnd == targetHwnd; };
+
+	source.JumpTargets.erase(std::remove_if(source.JumpTargets.begin(), source.JumpTargets.end(), isTarget), source.JumpTargets.end());
+	source.WalkTargets.erase(std::remove_if(source.WalkTargets.begin(), source.WalkTargets.end(), isTarget), source.WalkTargets.end());
+}
+
+void CPlatformGraph::SortEdges(SWindowNode& node)
+{
+	std::sort(node.JumpTargets.begin(), node.JumpTargets.end(), IsLowerOnScreen);
+}
+
+/*
+	Finds the platforms a cat can jump up to, without checking whether the cat fits on them
+
+	@param from The window the cat is stood on, NULL for the floor
+	@param fromHeight Height the cat is stood at
+	@param jumpHeight How high the cat can jump
+	@param targets Filled with the reachable platforms
+*/
+void CPlatformGraph::GetJumpTargets(HWND from, float fromHeight, float jumpHeight, FrameVector<const Platform*>& targets)
+{
+	targets.clear();
+
+	// On the floor, or on a window that has just gone, anything in range can be jumped to
+	auto node = from != NULL ? Nodes.find(from) : Nodes.end();
+	const std::vector<Platform>& candidates = node != Nodes.end() ? node->second.JumpTargets : PlatformsByHeight;
+
+	// Skip everything at or below the cat, then take platforms until they are too high
+	auto it = std::partition_point(candidates.begin(), candidates.end(), [fromHeight](const Platform& p) { return p.Height >= fromHeight; });
+
+	for (; it != candidates.end() && it->Height >= fromHeight - jumpHeight; ++it)
+	{
+		IfThenStatement(it->Hwnd != from, targets.push_back(&*it));
+	}
+}
+
+const std::vector<Platform>& CPlatformGraph::GetWalkTargets(HWND from)
+{
+	auto node = Nodes.find(from);
+	return node != Nodes.end() ? node->second.WalkTargets : Empty;
+}
+
+const std::vector<Platform>& CPlatformGraph::GetSegments(HWND window)
+{
+	auto node = Nodes.find(window);
+	return node != Nodes.end() ? node->second.Segments : Empty;
+}
+
+bool CPlatformGraph::SRouteKey::operator<(const SRouteKey& other) const
+{
+	return std::tie(From, Target, JumpHeight, FromHeight) < std::tie(other.From, other.Target, other.JumpHeight, other.FromHeight);
+}
+
+/*
+	Finds the cheapest series of walks and jumps from where a cat is stood to a window, routes are cached until the windows change
+
+	@param from The window the cat is stood on, NULL for the floor
+	@param fromHeight Height the cat is stood at
+	@param jumpHeight How high the cat can jump
+	@param target The window to get to
+	@param route Filled with each step of the route in order
+	@return If the window can be reached
+*/
+bool CPlatformGraph::FindRoute(HWND from, float fromHeight, float jumpHeight, HWND target, std::vector<SRouteHop>& route)
+{
+	PROFILE_SCOPE("CPlatformGraph::FindRoute");
+
+	SRouteKey key = { from, target, (int)jumpHeight, from == NULL ? (int)fromHeight : 0 };
+	auto cached = RouteCache.find(key);
+
+	if (cached != RouteCache.end())
+	{
+		route = cached->second.second;
+		return cached->second.first;
+	}
+
+	bool found = SearchRoute(from, fromHeight, jumpHeight, target, route);
+	RouteCache.insert({ key, { found, route } });
+	return found;
+}
+
+bool CPlatformGraph::SearchRoute(HWND from, float fromHeight, float jumpHeight, HWND target, std::vector<SRouteHop>& route)
+{
+	route.clear();
+	IfThenReturn(from == target, true);
+	IfThenReturn(Nodes.find(target) == Nodes.end(), false);
+
+	struct SVisit
+	{
+		HWND Previous;
+		SRouteHop Hop;
+		float Cost;
+		bool Done;
+	};
+
+	std::map<HWND, SVisit> visits;
+	std::priority_queue<std::pair<float, HWND>, std::vector<std::pair<float, HWND>>, std::greater<std::pair<float, HWND>>> open;
+	FrameVector<const Platform*> jumps;
+
+	visits[from] = SVisit{ from, SRouteHop{ Platform{ 0.0f, 0.0f, fromHeight, from }, false }, 0.0f, false };
+	open.push({ 0.0f, from });
+
+	while (!open.empty())
+	{
+		HWND current = open.top().second;
+		open.pop();
+
+		SVisit& visit = visits[current];
+		IfThenStatement(visit.Done, continue);
+		visit.Done = true;
+
+		if (current == target)
+		{
+			// Follow the steps back to the start
+			for (HWND hwnd = target; hwnd != from; hwnd = visits[hwnd].Previous)
+			{
+				route.push_back(visits[hwnd].Hop);
+			}
+
+			std::reverse(route.begin(), route.end());
+			return true;
+		}
+
+		// Where on the window the cat arrived, the start has no width so only the height counts
+		const Platform& at = visit.Hop.Target;
+		float atCentre = (at.Left + at.Right) * 0.5f;
+		float cost = visit.Cost;
+
+		auto consider = [&](const Platform& next, bool isJump)
+		{
+			float centre = (next.Left + next.Right) * 0.5f;
+			float distance = current == from ? 0.0f : std::abs(centre - atCentre);
+			float nextCost = cost + distance + (isJump ? JUMP_ROUTE_COST + (at.Height - next.Height) : 0.0f);
+
+			auto existing = visits.find(next.Hwnd);
+
+			if (existing == visits.end() || (!existing->second.Done && nextCost < existing->second.Cost))
+			{
+				visits[next.Hwnd] = SVisit{ current, SRouteHop{ next, isJump }, nextCost, false };
+				open.push({ nextCost, next.Hwnd });
+			}
+		};
+
+		GetJumpTargets(current, at.Height, jumpHeight, jumps);
+		for (const Platform* next : jumps) { consider(*next, true); }
+
+		for (const Platform& next : GetWalkTargets(current)) { consider(next, false); }
+	}
+
+	return false;
+}
+
+/*
+	Finds the window a point is above, the one with the closest platform at or under it
+
+	@return The window, NULL if there are no platforms under the point
+*/
+HWND CPlatformGraph::FindWindowBelow(float x, float y)
+{
+	// Platforms at or under the point come first, the closest is the last of them
+	auto end = std::partition_point(PlatformsByHeight.begin(), PlatformsByHeight.end(), [y](const Platform& p) { return p.Height >= y; });
+
+	for (auto it = std::make_reverse_iterator(end); it != PlatformsByHeight.rend(); ++it)
+	{
+		IfThenReturn(x >= it->Left && x <= it->Right, it->Hwnd);
+	}
+
+	return NULL;
+}
+
+unsigned int CPlatformGraph::GetVersion()
+{
+	return Version;
+}
+
+int CPlatformGraph::GetEdgeCount()
+{
+	return EdgeCount;
+}
+
+int CPlatformGraph::GetChangedCount()
+{
+	return ChangedCount;
+}
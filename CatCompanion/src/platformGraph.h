@@ -0,0 +1,81 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <Windows.h>
+
+#include "frameArena.h"
+
+struct Platform
+{
+	float Left;
+	float Right;
+	float Height;
+	HWND Hwnd;
+};
+
+// One step of a route, either a jump up onto the platform or a walk across onto it
+struct SRouteHop
+{
+	Platform Target;
+	bool IsJump;
+};
+
+/*
+	Which platforms a cat can reach from where it is, shared by every cat. A cat stood anywhere on a window
+	can jump to any platform of another window that overlaps the window horizontally, so nodes are grouped by
+	window: each window keeps its platform segments, the platforms it can jump to sorted from lowest to highest
+	and the platforms it can walk onto. Only windows whose platforms changed are recalculated each update.
+
+	Routes of several walks and jumps are found with Dijkstra over the windows and cached until the graph changes
+*/
+class CPlatformGraph
+{
+public:
+	void Update(const std::map<HWND, std::vector<Platform>>& windowPlatforms, const std::map<HWND, RECT>& windowBounds, POINT origin);
+
+	void GetJumpTargets(HWND from, float fromHeight, float jumpHeight, FrameVector<const Platform*>& targets);
+	const std::vector<Platform>& GetWalkTargets(HWND from);
+	const std::vector<Platform>& GetSegments(HWND window);
+
+	bool FindRoute(HWND from, float fromHeight, float jumpHeight, HWND target, std::vector<SRouteHop>& route);
+	HWND FindWindowBelow(float x, float y); // The window with the closest platform at or under a point
+
+	unsigned int GetVersion(); // Changes whenever the platforms do
+	int GetEdgeCount();
+	int GetChangedCount(); // Windows recalculated by the last update
+
+private:
+	struct SWindowNode
+	{
+		RECT Bounds; // Cat window coordinates
+		std::vector<Platform> Segments;
+		std::vector<Platform> JumpTargets; // Sorted by height, lowest on screen first
+		std::vector<Platform> WalkTargets; // Platforms of other windows touching a segment at the same height
+	};
+
+	std::map<HWND, SWindowNode> Nodes;
+	std::vector<Platform> PlatformsByHeight; // Every platform sorted the same way as the jump targets, for cats on the floor
+	std::vector<Platform> Empty;
+
+	int EdgeCount = 0;
+	int ChangedCount = 0;
+	unsigned int Version = 0;
+
+	// Routes found since the graph last changed, a route that wasn't found is kept empty so it isn't searched for again
+	struct SRouteKey
+	{
+		HWND From;
+		HWND Target;
+		int JumpHeight;
+		int FromHeight; // Only used from the floor, a window is always stood on at its top
+
+		bool operator<(const SRouteKey& other) const;
+	};
+
+	std::map<SRouteKey, std::pair<bool, std::vector<SRouteHop>>> RouteCache;
+
+	void AddEdges(SWindowNode& source, HWND sourceHwnd, const SWindowNode& target, HWND targetHwnd);
+	void RemoveEdges(SWindowNode& source, HWND targetHwnd);
+	void SortEdges(SWindowNode& node);
+	bool SearchRoute(HWND from, float fromHeight, float jumpHeight, HWND target, std::vector<SRouteHop>& route);
+};
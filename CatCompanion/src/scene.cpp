@@ -2,6 +2,9 @@
 #include <strsafe.h>
 #include <dwmapi.h>
 #include <thread>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
 #pragma comment(lib, "dwmapi.lib")
 
 #include "scene.h"
@@ -27,10 +30,21 @@
 #include "configs.h"
 #include "catPropertiesWindow.h"
 #include "texturedParticleLayer.h"
+#include "memoryTracker.h"
+#include "frameArena.h"
 #include "catManager.h"
+#include "iconPipeline.h"
 #include "CatWindow.h"
+#include "profiler.h"
+#include "renderStats.h"
+#include "replay.h"
+#include "jobSystem.h"
 
 #define MAX_TITLE_LEN 100
+#define STEADY_STATE_SECONDS 30.0 // Simulated seconds for the cats to settle before frames should stop allocating
+
+// The work done every frame that shouldn't allocate once the cats have settled, deciding what to do next still can
+static const char* const SteadyStateScopes[] = { "CSprite::Update", "CSprite::SetAnimationIndex", "CCat::TryJumpToWindow", "CCat::ConfineToMonitors", "GFX::DrawString" };
 
 HWND CScene::hWnd;
 bool CScene::IsOpen;
@@ -47,24 +61,44 @@ CScene::CScene(HWND aHwnd, unsigned int scrWidth, unsigned int scrHeight) :
 
 void CScene::Update()
 {
-	TIMER::Update(); // Update Delta and Total times
-	GINPUT::UpdateGlobal(); // Update Keystates and Mouse Locations
+	PROFILER::BeginFrame();
+	PROFILE_SCOPE("CScene::Update");
+
+	TIMER::Update(); // Add the time since the last frame to the simulation
+
+	// Simulate in fixed steps so the cats behave the same however often frames are drawn
+	while (TIMER::StepSimulation())
+	{
+		REPLAY::BeginStep(); // Load the recorded input for this step when a replay is playing
+
+		// Update Keystates and Mouse Locations, hidden runs leave the live mouse and keyboard alone
+		IfThenStatement(ReadLiveInput || REPLAY::IsPlaying(), GINPUT::UpdateGlobal());
 
-	// Update the window handles
-	//std::thread wmThread(std::bind(&CWindowsManager::Update, &WM));
-	//std::thread mmThread(std::bind(&CMonitorManager::Update, &MM));
-	WM.Update();
-	MM.Update();
+		// Update the window handles, the monitor manager moves the mouse into window coordinates so it has to follow the input
+		//std::thread wmThread(std::bind(&CWindowsManager::Update, &WM));
+		//std::thread mmThread(std::bind(&CMonitorManager::Update, &MM));
+		WM.Update();
+		MM.Update();
 
+		// Update all the objects
+		CManager::Update();
+		//DetailsWindow->Update();
 
-	// Update all the objects
-	CManager::Update();
-	//DetailsWindow->Update();
+		FM.Update();
 
-	FM.Update();
+		// F3 has been pressed
+		if (F3DebugEnabled && GINPUT::GetKeyInputState(114) == InputState::INPUT_DOWN_FIRST) { DebugMode = !DebugMode; }
 
-	// F3 has been pressed
-	if (F3DebugEnabled && GINPUT::GetKeyInputState(114) == InputState::INPUT_DOWN_FIRST) { DebugMode = !DebugMode; }
+		// F4 has been pressed, save everything the profiler has recorded
+		if (PROFILER::IsEnabled() && GINPUT::GetKeyInputState(115) == InputState::INPUT_DOWN_FIRST) { PROFILER::SaveChromeTrace("Profile.json"); }
+
+		// The run has simulated as long as it was asked to
+		if (RunSeconds > 0.0 && TIMER::GetTotalSeconds() >= RunSeconds)
+		{
+			IsOpen = false;
+			break;
+		}
+	}
 
 	//wmThread.join();
 	//mmThread.join();
@@ -74,18 +108,84 @@ void CScene::Update()
 
 void CScene::Render()
 {
+	PROFILE_SCOPE("CScene::Render");
+
 	IfThenStatement(DebugMode, WM.Render());
 	CManager::Render();
+	IfThenStatement(DebugMode, RenderPerformanceHUD());
 	//DetailsWindow->Draw();
 
 	//glm::ivec2 aLoc = GINPUT::GetMouseLocation();
 	//GFX::DrawString(CCamera::GetProjViewMatrix(), CFont::GetFont("AcknowledgeTTSmall"), "  " + HELPER::ToStringVec2(GINPUT::GetMouseLocation()), aLoc, glm::ivec4(0.0f, 0.0f, 0.0f, 1.0f), 1.0f);
 
 	glFinish();
+	STATS::EndFrame();
+	MEMORY::EndFrame();
+	ARENA::Reset();
+
+	// Once the cats have settled every allocation in the per frame scopes is one they shouldn't have made
+	if (AllocationCheck && TIMER::GetTotalSeconds() >= STEADY_STATE_SECONDS)
+	{
+		for (const char* scope : SteadyStateScopes) { SteadyStateAllocations += MEMORY::GetScopeAllocations(scope); }
+		SteadyStateFrames++;
+	}
+}
+
+/*
+	Returns the processor time used by every thread of the program
+
+	@return Time in 100 nanosecond units
+*/
+static unsigned long long GetProcessCPUTime()
+{
+	FILETIME creation, exit, kernel, user;
+	IfThenReturn(!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user), 0);
+
+	ULARGE_INTEGER kernelTime = { kernel.dwLowDateTime, kernel.dwHighDateTime };
+	ULARGE_INTEGER userTime = { user.dwLowDateTime, user.dwHighDateTime };
+	return kernelTime.QuadPart + userTime.QuadPart;
+}
+
+/*
+	Writes what the cats did this run to the metrics file as a one row CSV, used by batch runs
+*/
+void CScene::WriteRunMetrics()
+{
+	IfThenReturn(CatManager == nullptr, );
+
+	std::ofstream file(MetricsFile, std::ofstream::trunc);
+
+	if (!file.is_open())
+	{
+		std::cout << "WARNING: Unable to write metrics to " << MetricsFile << std::endl;
+		return;
+	}
+
+	SCatMetrics metrics = CatManager->GetMetricsTotal();
+	double simulatedSeconds = TIMER::GetTotalSeconds();
+	long long steps = std::max(1LL, TIMER::GetStepCount());
+	double cpuSeconds = (GetProcessCPUTime() - StartCPUTime) / 10000000.0;
+
+	// Wall time shows how the steps scale with the job system's threads, CPU time adds up every thread
+	double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+
+	file << "simulated-seconds,steps,cats,threads,jumps-attempted,jumps-succeeded,seconds-asleep,cpu-microseconds-per-step,cpu-seconds-per-simulated-hour,wall-microseconds-per-step,steady-state-frames,steady-state-allocations\n";
+	file << simulatedSeconds << "," << TIMER::GetStepCount() << "," << CatManager->GetCatCount() << "," << JOBS::GetThreadCount() << ","
+		<< metrics.JumpsAttempted << "," << metrics.JumpsSucceeded << "," << metrics.SecondsAsleep << ","
+		<< cpuSeconds * 1000000.0 / steps << "," << (simulatedSeconds > 0.0 ? cpuSeconds * 3600.0 / simulatedSeconds : 0.0) << ","
+		<< wallSeconds * 1000000.0 / steps << "," << SteadyStateFrames << "," << SteadyStateAllocations << "\n";
 }
 
 void CScene::CleanUp()
 {
+	// Written before the cats are deleted, a run that quits early still reports how far it got
+	IfThenStatement(MetricsFile != "", WriteRunMetrics());
+
+	if (AllocationCheck && SteadyStateAllocations > 0)
+	{
+		std::cout << "FAILED: " << SteadyStateAllocations << " allocations in the per frame scopes over " << SteadyStateFrames << " steady state frames" << std::endl;
+	}
+
 	CManager::CleanUp();
 
 	IsRunning = false;
@@ -100,23 +200,25 @@ void CScene::CleanUp()
 	//CCoreTilemap::DestroyTileTemplates();
 }
 
-void CScene::OnFileDropped(HICON icon)
+/*
+	The program's exit code, non zero when the allocation check is enabled and a per frame scope allocated once the cats settled
+
+	@return Exit code for the program
+*/
+int CScene::GetExitCode()
 {
-	glm::ivec2 mouseLocation = GINPUT::GetMouseLocation();
-	CCat* targetCat = nullptr;
+	return (AllocationCheck && SteadyStateAllocations > 0) ? 1 : 0;
+}
 
-	for (CCat* cat : Cats)
-	{
-		if (cat->IsInBounds(mouseLocation))
-		{
-			targetCat = cat;
-			break;
-		}
-	}
+void CScene::OnFileDropped(const std::wstring& path)
+{
+	IfThenReturn(CatManager == nullptr, );
+	CCat* targetCat = CatManager->GetCatAt(GINPUT::GetMouseLocation());
 
-	if (targetCat != nullptr)
+	// The icon is read off the main thread, the cat gets it a frame or two later
+	if (targetCat != nullptr && targetCat->CanEatIcon())
 	{
-		targetCat->OnFileDropped(icon);
+		CatManager->GetIconPipeline().Request(targetCat->GetHandle(), path);
 	}
 }
 
@@ -125,6 +227,61 @@ void CScene::OpenCatPropertiesWindow(CCat* cat)
 	PropertyWindow->SetVisible(cat);
 }
 
+/*
+	Draws the render counters, object counts and frame time percentiles in the top left of the main monitor
+*/
+void CScene::RenderPerformanceHUD()
+{
+	if (HUDFont == nullptr) { HUDFont = CFont::GetFont("arialSmall"); }
+
+	const float scale = 0.5f;
+	const int lineHeight = (int)(HUDFont->Size * scale) + 4;
+
+	std::vector<std::string> lines;
+	char buffer[128];
+
+	snprintf(buffer, sizeof(buffer), "Frame ms  p50 %.2f  p95 %.2f  p99 %.2f", STATS::GetFrameTimePercentile(50.0f), STATS::GetFrameTimePercentile(95.0f), STATS::GetFrameTimePercentile(99.0f));
+	lines.push_back(buffer);
+
+	for (int i = 0; i < (int)STATS::ECounter::Count; ++i)
+	{
+		STATS::ECounter counter = (STATS::ECounter)i;
+		lines.push_back(STATS::GetCounterName(counter) + ": " + std::to_string(STATS::GetCounter(counter)));
+	}
+
+	for (int i = 0; i < STATS::GetValueCount(); ++i)
+	{
+		lines.push_back(STATS::GetValueName(i) + ": " + std::to_string(STATS::GetValue(i)));
+	}
+
+	// Includes the allocations made by the HUD itself
+	snprintf(buffer, sizeof(buffer), "Allocations: %d (%lld bytes)  Frees: %d", MEMORY::GetFrameAllocations(), MEMORY::GetFrameBytes(), MEMORY::GetFrameFrees());
+	lines.push_back(buffer);
+
+	snprintf(buffer, sizeof(buffer), "Frame Arena: %zu / %zu  Peak %zu  Overflows %d", ARENA::GetUsed(), ARENA::GetCapacity(), ARENA::GetPeak(), ARENA::GetOverflowCount());
+	lines.push_back(buffer);
+
+	MEMORY::SScopeAllocations scopes[3];
+	int scopeCount = MEMORY::GetScopeAllocations(scopes, 3);
+
+	for (int i = 0; i < scopeCount; ++i)
+	{
+		snprintf(buffer, sizeof(buffer), "  %s: %d (%lld bytes)", scopes[i].Name, scopes[i].Count, scopes[i].Bytes);
+		lines.push_back(buffer);
+	}
+
+	const MonitorInfo& info = MM.GetMonitorDetail((int)MM.GetMonitors()[0]);
+	glm::vec2 topLeft = MM.DesktopToWindow(glm::vec2(info.BoundryNTB.left, info.BoundryNTB.top)) + glm::vec2(10.0f, 10.0f);
+	glm::mat4 pv = CCamera::GetProjViewMatrix();
+
+	GFX::DrawRectangle(pv, glm::vec4(0.0f, 0.0f, 0.0f, 0.6f), topLeft, glm::vec2(320.0f, lineHeight * lines.size() + 10.0f));
+
+	for (int i = 0; i < (int)lines.size(); ++i)
+	{
+		GFX::DrawString(pv, HUDFont, lines[i], glm::ivec2(topLeft) + glm::ivec2(5, 5 + i * lineHeight), glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), scale);
+	}
+}
+
 void CScene::WindowsProcessor()
 {
 	float sleepTime = 1000 / 60;
@@ -143,9 +300,67 @@ void CScene::Initialise()
 
 	SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_SYSTEM_AWARE);
 
+	// Number of threads for the job system, anything other than a number will pick based on the hardware
+	std::string workerThreads = CGlobalVariables::ConfigSetting->GetStringVariable("worker-threads");
+	WorkerThreads = (workerThreads != "" && std::all_of(workerThreads.begin(), workerThreads.end(), ::isdigit)) ? std::stoi(workerThreads) : -1;
+
 	CManager::Initialise();
 
 	F3DebugEnabled = CGlobalVariables::ConfigSetting->GetStringVariable("f3-debug") == "enabled";
+	PROFILER::SetEnabled(CGlobalVariables::ConfigSetting->GetStringVariable("profiler") == "enabled");
+
+	// Simulation steps per second, this changes how smooth the cats are not how they behave
+	std::string simulationRate = CGlobalVariables::ConfigSetting->GetStringVariable("simulation-rate");
+	IfThenStatement(simulationRate != "" && std::all_of(simulationRate.begin(), simulationRate.end(), ::isdigit), TIMER::SetStepRate(std::stoi(simulationRate)));
+
+	// Simulated seconds per real second, fast forwards the cats for long runs
+	std::string timeScale = CGlobalVariables::ConfigSetting->GetStringVariable("time-scale");
+	char* timeScaleEnd = nullptr;
+	double scale = std::strtod(timeScale.c_str(), &timeScaleEnd);
+	IfThenStatement(timeScale != "" && *timeScaleEnd == '\0', TIMER::SetTimeScale(scale));
+
+	// Simulated seconds to run for before closing, 0 runs until the cats are closed
+	std::string runSeconds = CGlobalVariables::ConfigSetting->GetStringVariable("run-seconds");
+	char* runSecondsEnd = nullptr;
+	double seconds = std::strtod(runSeconds.c_str(), &runSecondsEnd);
+	IfThenStatement(runSeconds != "" && *runSecondsEnd == '\0', RunSeconds = std::max(0.0, seconds));
+
+	// Where to write what the cats did when closing, and whether the cats can be seen and touched
+	std::string metricsFile = CGlobalVariables::ConfigSetting->GetStringVariable("metrics-file");
+	MetricsFile = metricsFile == "disabled" ? "" : metricsFile;
+	ReadLiveInput = CGlobalVariables::ConfigSetting->GetStringVariable("window") != "hidden";
+
+	// Fails the run if the per frame scopes still allocate once the cats have settled, "CatCompanion.exe AllocationCheck" runs the check hidden
+	// Allocations are only attributed to scopes while the profiler records them so the check turns it on
+	AllocationCheck = CGlobalVariables::ConfigSetting->GetStringVariable("allocation-check") == "enabled";
+	IfThenStatement(AllocationCheck, PROFILER::SetEnabled(true));
+
+	// Seed for everything random, anything other than a number picks one from the time
+	std::string randomSeed = CGlobalVariables::ConfigSetting->GetStringVariable("random-seed");
+	unsigned long long seed = HELPER::GetRandomSeed();
+	IfThenStatement(randomSeed != "" && std::all_of(randomSeed.begin(), randomSeed.end(), ::isdigit), seed = std::stoull(randomSeed));
+
+	// Replays take the seed and step rate they were recorded with so the run plays out the same
+	std::string replay = CGlobalVariables::ConfigSetting->GetStringVariable("replay");
+
+	if (replay._Starts_with("play "))
+	{
+		int stepRate = TIMER::GetStepRate();
+		IfThenStatement(REPLAY::StartPlayback(replay.substr(5), seed, stepRate), TIMER::SetStepRate(stepRate));
+	}
+	else if (replay._Starts_with("record "))
+	{
+		REPLAY::StartRecording(replay.substr(7), seed, TIMER::GetStepRate());
+	}
+
+	HELPER::SeedRandom(seed);
+
+	// The desktop the cats start on has to come from the replay as well
+	if (REPLAY::IsRecording() || REPLAY::IsPlaying())
+	{
+		MM.Update();
+		WM.Update();
+	}
 
 	std::shared_ptr<CCamera2D> mainCamera = std::shared_ptr<CCamera2D>(new CCamera2D(glm::vec2()));
 
@@ -155,7 +370,7 @@ void CScene::Initialise()
 	Rooms.push_back(room);
 
 	CMonitorManager& MM = CMonitorManager::GetInstance();
-	std::vector<HMONITOR>& Monitors = MM.GetMonitors();
+	const std::vector<HMONITOR>& Monitors = MM.GetMonitors();
 
 	//std::vector<CCoreTilemap*> tilemaps;
 	//std::for_each(Monitors.begin(), Monitors.end(), [&tilemaps, &MM](HMONITOR mon) { tilemaps.push_back(new CCoreTilemap((int)mon)); });
@@ -170,6 +385,7 @@ void CScene::Initialise()
 	CInstanceLayer* instanceLayer = new CInstanceLayer();
 	ParticlesLayer = new CTexturedParticleLayer();
 	CCatManager* catManager = new CCatManager(this);
+	CatManager = catManager;
 
 	room->Layers.push_back(catManager);
 	room->Layers.push_back(instanceLayer);
@@ -183,4 +399,6 @@ void CScene::Initialise()
 
 
 	SetRoom(0);
+	StartCPUTime = GetProcessCPUTime();
+	StartTime = std::chrono::steady_clock::now();
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include  <Windows.h>
+#include <chrono>
+#include <string>
 #include <thread>
 
 #include "manager.h"
@@ -10,6 +12,8 @@ class CWindowsManager;
 class CMonitorManager;
 class CFocusManager;
 class CCat;
+class CCatManager;
+class CFont;
 
 class CScene :
 	public CManager
@@ -24,8 +28,9 @@ public:
 	void Update();
 	void Render();
 	void CleanUp();
+	int GetExitCode();
 
-	void OnFileDropped(HICON icon);
+	void OnFileDropped(const std::wstring& path);
 	void OpenCatPropertiesWindow(CCat* cat);
 
 	CTexturedParticleLayer* ParticlesLayer;
@@ -35,15 +40,30 @@ private:
 	CMonitorManager& MM;
 	CFocusManager& FM;
 
-	std::vector<CCat*> Cats;
 	CCatPropertiesWindow* PropertyWindow;
+	CCatManager* CatManager = nullptr;
 
 	bool DebugMode = false;
 	bool F3DebugEnabled = false;
+	CFont* HUDFont = nullptr;
 
 	bool IsRunning = true;
 	std::thread WindowsProcessorThread;
 
+	// Batch runs stop after a set amount of simulation and write what the cats did
+	double RunSeconds = 0.0;
+	std::string MetricsFile;
+	bool ReadLiveInput = true;
+	unsigned long long StartCPUTime = 0;
+	std::chrono::steady_clock::time_point StartTime;
+
+	// Allocations made by frames after the cats have settled, used to check the steady state doesn't allocate
+	bool AllocationCheck = false;
+	long long SteadyStateAllocations = 0;
+	int SteadyStateFrames = 0;
+
 	void WindowsProcessor();
+	void RenderPerformanceHUD();
+	void WriteRunMetrics();
 };
 
@@ -0,0 +1,211 @@
+#include <dwmapi.h>
+
+#include "windowCache.h"
+#include "frameArena.h"
+#include "helper.h"
+
+CWindowCache* CWindowCache::Instance = nullptr;
+
+const std::string* CStringPool::Intern(const std::string& value)
+{
+	auto it = Strings.insert({ value, 0 }).first;
+	it->second++;
+	return &it->first;
+}
+
+void CStringPool::Release(const std::string* value)
+{
+	IfThenReturn(value == nullptr, );
+
+	auto it = Strings.find(*value);
+	IfThenReturn(it == Strings.end(), );
+	IfThenStatement(--it->second <= 0, Strings.erase(it));
+}
+
+int CStringPool::GetCount()
+{
+	return (int)Strings.size();
+}
+
+CWindowCache::CWindowCache()
+{
+	Instance = this;
+
+	// Only the events that change something the cache holds, each range is hooked separately to keep the rest out
+	const DWORD ranges[][2] =
+	{
+		{ EVENT_SYSTEM_MINIMIZESTART, EVENT_SYSTEM_MINIMIZEEND },
+		{ EVENT_OBJECT_DESTROY, EVENT_OBJECT_HIDE },
+		{ EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_NAMECHANGE },
+		{ EVENT_OBJECT_CLOAKED, EVENT_OBJECT_UNCLOAKED },
+	};
+
+	HasHooks = true;
+
+	for (auto& range : ranges)
+	{
+		HWINEVENTHOOK hook = SetWinEventHook(range[0], range[1], NULL, WinEventCallback, 0, 0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+		IfThenStatement(hook != NULL, Hooks.push_back(hook));
+		HasHooks &= hook != NULL;
+	}
+
+	IfThenStatement(!HasHooks, HELPER::PrintToOutput("WARNING: Window events could not be hooked, window attributes will be queried every frame"));
+}
+
+CWindowCache::~CWindowCache()
+{
+	for (HWINEVENTHOOK hook : Hooks) { UnhookWinEvent(hook); }
+	IfThenStatement(Instance == this, Instance = nullptr);
+}
+
+void CWindowCache::BeginFrame()
+{
+	Frame++;
+	QueryCount = 0;
+
+	// Without the events nothing can be trusted from the last frame
+	if (!HasHooks)
+	{
+		for (auto& entry : Entries) { entry.second.Dirty = EDirty::All; }
+	}
+}
+
+void CWindowCache::EndFrame()
+{
+	for (auto it = Entries.begin(); it != Entries.end();)
+	{
+		if (it->second.LastSeen != Frame)
+		{
+			Titles.Release(it->second.Attributes.Title);
+			it = Entries.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+const SWindowAttributes& CWindowCache::Get(HWND hWnd)
+{
+	SEntry& entry = Entries[hWnd];
+	entry.LastSeen = Frame;
+
+	IfThenStatement(entry.Dirty != 0, Refresh(hWnd, entry));
+	return entry.Attributes;
+}
+
+/*
+	Queries only the attributes that have changed since the window was last looked at
+*/
+void CWindowCache::Refresh(HWND hWnd, SEntry& entry)
+{
+	SWindowAttributes& attributes = entry.Attributes;
+
+	if (entry.Dirty & EDirty::Style)
+	{
+		attributes.Style = GetWindowLongPtrW(hWnd, GWL_STYLE);
+		attributes.Iconic = IsIconic(hWnd);
+		QueryCount++;
+	}
+
+	if (entry.Dirty & EDirty::Cloak)
+	{
+		INT cloaked = 0;
+		DwmGetWindowAttribute(hWnd, DWMWA_CLOAKED, &cloaked, sizeof(INT));
+		attributes.Cloaked = cloaked != 0;
+		QueryCount++;
+	}
+
+	if (entry.Dirty & EDirty::Bounds)
+	{
+		DwmGetWindowAttribute(hWnd, DWMWA_EXTENDED_FRAME_BOUNDS, &attributes.FrameBounds, sizeof(RECT));
+		QueryCount++;
+	}
+
+	if (entry.Dirty & EDirty::Title)
+	{
+		int length = GetWindowTextLength(hWnd);
+		FrameVector<wchar_t> buffer(length + 1);
+		length = length > 0 ? GetWindowText(hWnd, buffer.data(), length + 1) : 0;
+
+		// Intern the new title before letting go of the old one, so an unchanged title keeps its string
+		const std::string* title = Titles.Intern(std::string(buffer.begin(), buffer.begin() + length));
+		Titles.Release(attributes.Title);
+		attributes.Title = title;
+		QueryCount++;
+	}
+
+	entry.Dirty = 0;
+}
+
+void CWindowCache::Forget(HWND hWnd)
+{
+	auto it = Entries.find(hWnd);
+	IfThenReturn(it == Entries.end(), );
+
+	Titles.Release(it->second.Attributes.Title);
+	Entries.erase(it);
+}
+
+void CWindowCache::MarkDirty(HWND hWnd, unsigned int dirty)
+{
+	auto it = Entries.find(hWnd);
+	IfThenStatement(it != Entries.end(), it->second.Dirty |= dirty);
+}
+
+void CALLBACK CWindowCache::WinEventCallback(HWINEVENTHOOK hook, DWORD event, HWND hWnd, LONG idObject, LONG idChild, DWORD eventThread, DWORD eventTime)
+{
+	// Only events about top level windows themselves, not their carets, scroll bars or children
+	IfThenReturn(Instance == nullptr || hWnd == NULL || idObject != OBJID_WINDOW || idChild != CHILDID_SELF, );
+
+	switch (event)
+	{
+		case EVENT_OBJECT_DESTROY:
+		{
+			// The handle can be given to a new window straight away
+			Instance->Forget(hWnd);
+			break;
+		}
+		case EVENT_OBJECT_SHOW:
+		case EVENT_OBJECT_HIDE:
+		{
+			Instance->MarkDirty(hWnd, EDirty::Style);
+			break;
+		}
+		case EVENT_SYSTEM_MINIMIZESTART:
+		case EVENT_SYSTEM_MINIMIZEEND:
+		case EVENT_OBJECT_LOCATIONCHANGE:
+		{
+			// Maximising and restoring come through as location changes
+			Instance->MarkDirty(hWnd, EDirty::Style | EDirty::Bounds);
+			break;
+		}
+		case EVENT_OBJECT_NAMECHANGE:
+		{
+			Instance->MarkDirty(hWnd, EDirty::Title);
+			break;
+		}
+		case EVENT_OBJECT_CLOAKED:
+		case EVENT_OBJECT_UNCLOAKED:
+		{
+			Instance->MarkDirty(hWnd, EDirty::Cloak);
+			break;
+		}
+	}
+}
+
+int CWindowCache::GetCount()
+{
+	return (int)Entries.size();
+}
+
+int CWindowCache::GetQueryCount()
+{
+	return QueryCount;
+}
+
+int CWindowCache::GetTitleCount()
+{
+	return Titles.GetCount();
+}
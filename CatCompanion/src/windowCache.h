@@ -0,0 +1,89 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <Windows.h>
+
+/*
+	Keeps one copy of each string, handing out pointers that stay valid while anything still uses the string.
+	Windows that share a title share the string, and comparing interned strings is comparing pointers
+*/
+class CStringPool
+{
+public:
+	const std::string* Intern(const std::string& value);
+	void Release(const std::string* value);
+
+	int GetCount();
+
+private:
+	std::unordered_map<std::string, int> Strings; // Each string and how many uses it has, nodes never move
+};
+
+// What the windows manager needs to know about a window, in desktop coordinates
+struct SWindowAttributes
+{
+	LONG_PTR Style = 0;
+	bool Iconic = false;
+	bool Cloaked = false;
+	RECT FrameBounds = {}; // DWM frame bounds, without the invisible resize borders
+	const std::string* Title = nullptr; // Interned, never null once the window has been looked at
+};
+
+/*
+	Window attributes keyed by handle. Windows only tells us a window's title, position, visibility or cloak
+	changed through win events, so each window is queried once and after that only the attributes an event
+	said had changed are queried again. Events are delivered through the message loop of the thread the
+	cache was made on.
+
+	Windows not seen between BeginFrame and EndFrame are dropped, which also covers any destroy event that was missed
+*/
+class CWindowCache
+{
+public:
+	CWindowCache();
+	~CWindowCache();
+
+	void BeginFrame();
+	void EndFrame();
+
+	const SWindowAttributes& Get(HWND hWnd); // Marks the window as seen this frame
+
+	int GetCount();
+	int GetQueryCount(); // Attributes queried from Windows this frame
+	int GetTitleCount();
+
+private:
+	enum EDirty : unsigned int
+	{
+		Style = 1 << 0,
+		Cloak = 1 << 1,
+		Bounds = 1 << 2,
+		Title = 1 << 3,
+
+		All = Style | Cloak | Bounds | Title,
+	};
+
+	struct SEntry
+	{
+		SWindowAttributes Attributes;
+		unsigned int Dirty = EDirty::All;
+		unsigned int LastSeen = 0;
+	};
+
+	static CWindowCache* Instance; // Win event callbacks have no user data, so they go to the one cache
+
+	std::unordered_map<HWND, SEntry> Entries;
+	std::vector<HWINEVENTHOOK> Hooks;
+	CStringPool Titles;
+
+	unsigned int Frame = 0;
+	int QueryCount = 0;
+	bool HasHooks = false;
+
+	void Refresh(HWND hWnd, SEntry& entry);
+	void Forget(HWND hWnd);
+	void MarkDirty(HWND hWnd, unsigned int dirty);
+
+	static void CALLBACK WinEventCallback(HWINEVENTHOOK hook, DWORD event, HWND hWnd, LONG idObject, LONG idChild, DWORD eventThread, DWORD eventTime);
+};
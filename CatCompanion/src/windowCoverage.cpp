@@ -0,0 +1,81 @@
+#include "windowCoverage.h"
+#include "frameArena.h"
+#include "helper.h"
+
+/*
+	Takes the windows for this frame
+
+	@param windowsTopFirst The visible windows in z-order, the top window first
+	@param windowBounds Bounds of each window in desktop coordinates
+	@param origin Desktop location of the cat window's top left
+*/
+void CWindowCoverage::Update(const std::vector<HWND>& windowsTopFirst, const std::map<HWND, RECT>& windowBounds, POINT origin)
+{
+	Rects.clear();
+	Depths.clear();
+
+	for (HWND hwnd : windowsTopFirst)
+	{
+		auto bounds = windowBounds.find(hwnd);
+		IfThenStatement(bounds == windowBounds.end(), continue);
+
+		RECT rect = bounds->second;
+		OffsetRect(&rect, -origin.x, -origin.y);
+
+		Depths[hwnd] = (int)Rects.size();
+		Rects.push_back(rect);
+	}
+}
+
+/*
+	Works out how much of an area drawn on a window can be seen past the windows in front of it
+
+	@param window The window the area is drawn on, NULL for something in front of every window
+	@param bounds The area in cat window coordinates
+	@param visible Set to a rectangle holding every visible part of the area when it's partially covered
+	@return Whether the area is visible, partially covered or hidden
+*/
+ECoverage CWindowCoverage::Test(HWND window, const RECT& bounds, RECT& visible)
+{
+	auto depth = window != NULL ? Depths.find(window) : Depths.end();
+	IfThenReturn(depth == Depths.end(), ECoverage::Visible);
+
+	// The parts of the area that are still uncovered, each window in front cuts them into smaller pieces
+	FrameVector<RECT> pieces(1, bounds);
+	FrameVector<RECT> cut;
+	bool covered = false;
+
+	for (int i = 0; i < depth->second && !pieces.empty(); ++i)
+	{
+		const RECT& cover = Rects[i];
+		cut.clear();
+
+		for (const RECT& piece : pieces)
+		{
+			RECT overlap;
+
+			if (!IntersectRect(&overlap, &piece, &cover))
+			{
+				cut.push_back(piece);
+				continue;
+			}
+
+			// Keep the strips above, below, left and right of the overlap
+			covered = true;
+			IfThenStatement(piece.top < overlap.top, cut.push_back(RECT{ piece.left, piece.top, piece.right, overlap.top }));
+			IfThenStatement(overlap.bottom < piece.bottom, cut.push_back(RECT{ piece.left, overlap.bottom, piece.right, piece.bottom }));
+			IfThenStatement(piece.left < overlap.left, cut.push_back(RECT{ piece.left, overlap.top, overlap.left, overlap.bottom }));
+			IfThenStatement(overlap.right < piece.right, cut.push_back(RECT{ overlap.right, overlap.top, piece.right, overlap.bottom }));
+		}
+
+		pieces.swap(cut);
+	}
+
+	IfThenReturn(!covered, ECoverage::Visible);
+	IfThenReturn(pieces.empty(), ECoverage::Hidden);
+
+	visible = pieces[0];
+	for (const RECT& piece : pieces) { UnionRect(&visible, &visible, &piece); }
+
+	return ECoverage::Partial;
+}
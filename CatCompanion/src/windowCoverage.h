@@ -0,0 +1,27 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <Windows.h>
+
+enum class ECoverage
+{
+	Visible,
+	Partial,
+	Hidden,
+};
+
+/*
+	Which parts of the desktop each window has other windows in front of it, built from the window snapshot
+	in z-order. Something drawn on a window, like a cat sat on it, is hidden wherever a window higher up covers it
+*/
+class CWindowCoverage
+{
+public:
+	void Update(const std::vector<HWND>& windowsTopFirst, const std::map<HWND, RECT>& windowBounds, POINT origin);
+
+	ECoverage Test(HWND window, const RECT& bounds, RECT& visible);
+
+private:
+	std::vector<RECT> Rects; // Every window's bounds, top window first
+	std::map<HWND, int> Depths; // Where each window is in Rects
+};
@@ -10,6 +10,10 @@
 #include "helper.h"
 #include "font.h"
 #include "input.h"
+#include "profiler.h"
+#include "renderStats.h"
+#include "frameArena.h"
+#include "replay.h"
 
 CWindowsManager* CWindowsManager::Instance = nullptr;
 
@@ -36,10 +40,26 @@ CWindowsManager::~CWindowsManager()
 
 void CWindowsManager::Update()
 {
+	PROFILE_SCOPE("CWindowsManager::Update");
+
 	VisibleWindows.clear();
 	VisibleWindowsBounds.clear();
+
+	WindowCache.BeginFrame();
 	EnumWindows(EnumWindowCallback, NULL);
+	WindowCache.EndFrame();
+
+	SyncReplay();
 	CalculatePlatforms();
+
+	const RECT& combined = MM.GetCombinedRect();
+	PlatformGraph.Update(WindowPlatforms, VisibleWindowsBounds, POINT{ combined.left, combined.top });
+	Coverage.Update(VisibleWindows, VisibleWindowsBounds, POINT{ combined.left, combined.top });
+
+	STATS::SetValue(PlatformsStat, (int)Platforms.size());
+	STATS::SetValue(VisibleWindowsStat, (int)VisibleWindows.size());
+	STATS::SetValue(PlatformEdgesStat, PlatformGraph.GetEdgeCount());
+	STATS::SetValue(WindowQueriesStat, WindowCache.GetQueryCount());
 }
 
 void CWindowsManager::Render()
@@ -78,7 +98,7 @@ void CWindowsManager::Render()
 		//GFX::DrawRectangle(pv, windowCol, topLeft2, botRight2 - topLeft2);
 		GFX::DrawRectangle(pv, windowCol, topLeft1, botRight1 - topLeft1);
 
-		std::string name = GetWindowName(hWnd);
+		const std::string& name = GetWindowName(hWnd);
 		glm::ivec2 location = topLeft1 + 0.5f * (botRight1 - topLeft1) - glm::vec2(Font->TextBounds(name, 1.0f) / 2);
 		GFX::DrawString(pv, Font, name, location, textCol);
 	}
@@ -90,11 +110,60 @@ std::vector<HWND>& CWindowsManager::GetCollisionWindows()
 	return CollisionWindows;
 }*/
 
+/*
+	Records the visible windows found this step, or swaps them for the recorded ones when a replay is playing.
+	Only the handles and bounds are replayed, anything else asked of a recorded handle comes from the live desktop
+*/
+void CWindowsManager::SyncReplay()
+{
+	IfThenReturn(!REPLAY::IsRecording() && !REPLAY::IsPlaying(), );
+
+	struct SWindowRecord
+	{
+		long long Handle;
+		RECT Bounds;
+	};
+
+	std::vector<char> data(VisibleWindows.size() * sizeof(SWindowRecord));
+	SWindowRecord* records = (SWindowRecord*)data.data();
+
+	for (int i = 0; i < (int)VisibleWindows.size(); ++i)
+	{
+		records[i] = SWindowRecord{ (long long)VisibleWindows[i], VisibleWindowsBounds[VisibleWindows[i]] };
+	}
+
+	REPLAY::Sync(REPLAY::EChannel::Windows, data);
+	IfThenReturn(!REPLAY::IsPlaying(), );
+
+	VisibleWindows.clear();
+	VisibleWindowsBounds.clear();
+
+	records = (SWindowRecord*)data.data();
+	int count = (int)(data.size() / sizeof(SWindowRecord));
+
+	for (int i = 0; i < count; ++i)
+	{
+		HWND hWnd = (HWND)records[i].Handle;
+		VisibleWindows.push_back(hWnd);
+		VisibleWindowsBounds.insert({ hWnd, records[i].Bounds });
+	}
+}
+
 std::vector<Platform>& CWindowsManager::GetPlatforms()
 {
 	return Platforms;
 }
 
+CPlatformGraph& CWindowsManager::GetPlatformGraph()
+{
+	return PlatformGraph;
+}
+
+CWindowCoverage& CWindowsManager::GetCoverage()
+{
+	return Coverage;
+}
+
 bool CWindowsManager::GetPlatformsFromWindow(HWND hwnd, std::vector<Platform>& platforms)
 {
 	auto it = WindowPlatforms.find(hwnd);
@@ -150,21 +219,20 @@ bool CWindowsManager::GetWindowBoundry(HWND hWnd, RECT& bounds)
 	}
 }
 
-std::string CWindowsManager::GetWindowName(HWND hWnd)
+const std::string& CWindowsManager::GetWindowName(HWND hWnd)
+{
+	return *WindowCache.Get(hWnd).Title;
+}
+
+CWindowsManager::CWindowsManager() : MM(CMonitorManager::GetInstance()), Font(nullptr)
 {
-	// Get the windows title
-	int length = GetWindowTextLength(hWnd);
-	wchar_t* buffer = new wchar_t[length + 1];
-	GetWindowText(hWnd, buffer, length + 1);
-	std::wstring text = buffer;
-	std::string windowTitle(text.begin(), text.end());
-	delete[] buffer;
-
-	return windowTitle;
+	PlatformsStat = STATS::RegisterValue("Platforms");
+	VisibleWindowsStat = STATS::RegisterValue("Visible Windows");
+	PlatformEdgesStat = STATS::RegisterValue("Platform Edges");
+	WindowQueriesStat = STATS::RegisterValue("Window Queries");
 }
 
-CWindowsManager::CWindowsManager() : MM(CMonitorManager::GetInstance()) {}
-CWindowsManager::CWindowsManager(CWindowsManager const&) : MM(CMonitorManager::GetInstance()) {}
+CWindowsManager::CWindowsManager(CWindowsManager const&) : MM(CMonitorManager::GetInstance()), Font(nullptr), PlatformsStat(0), VisibleWindowsStat(0), PlatformEdgesStat(0), WindowQueriesStat(0) {}
 
 void CWindowsManager::CalculatePlatforms()
 {
@@ -172,7 +240,8 @@ void CWindowsManager::CalculatePlatforms()
 	Platforms.clear();
 	WindowPlatforms.clear();
 
-	std::vector<RECT> bounds;
+	FrameVector<RECT> bounds;
+	bounds.reserve(VisibleWindows.size());
 
 	// Loop through each window backwards
 	//for (int i = VisibleWindows.size() - 1; i >= 0; i--)
@@ -191,7 +260,7 @@ void CWindowsManager::CalculatePlatforms()
 	}
 }
 
-void CWindowsManager::CalculatePlatform(Platform p, std::vector<RECT>& bounds, int startIndex)
+void CWindowsManager::CalculatePlatform(Platform p, FrameVector<RECT>& bounds, int startIndex)
 {
 	for (int i = startIndex; i < bounds.size(); ++i)
 	{
@@ -253,33 +322,27 @@ BOOL CWindowsManager::EnumWindowCallback(HWND hWnd, LPARAM lparam)
 	//	HELPER::PrintToOutput(CWindowsManager::GetInstance().GetWindowName(hWnd));
 	//}
 
-	LONG lStyle = GetWindowLongPtrW(hWnd, GWL_STYLE);
+	IfThenReturn(hWnd == CScene::hWnd, TRUE);
 
-	if (lStyle & WS_VISIBLE && lStyle & WS_EX_APPWINDOW && !IsIconic(hWnd) && hWnd != CScene::hWnd)
+	// Everything asked about the window comes from the cache, which only asks Windows again once it has changed
+	const SWindowAttributes& attributes = Instance->WindowCache.Get(hWnd);
+	LONG_PTR lStyle = attributes.Style;
+
+	if (lStyle & WS_VISIBLE && lStyle & WS_EX_APPWINDOW && !attributes.Iconic)
 	{
 		// If the window is cloaked it is not visible
-		INT nCloaked;
-		DwmGetWindowAttribute(hWnd, DWMWA_CLOAKED, &nCloaked, sizeof(INT));
-		IfThenStatement(nCloaked, return TRUE);
+		IfThenStatement(attributes.Cloaked, return TRUE);
 
 		// Remove any windows without a title
-		int length = GetWindowTextLength(hWnd);
-		IfThenStatement(length <= 0, return TRUE);
+		const std::string& windowTitle = *attributes.Title;
+		IfThenStatement(windowTitle.empty(), return TRUE);
 
 		// Remove all windows without a width or height 
-		RECT r;
-		DwmGetWindowAttribute(hWnd, DWMWA_EXTENDED_FRAME_BOUNDS, &r, sizeof(RECT));
+		RECT r = attributes.FrameBounds;
 		int w = r.right - r.left;
 		int h = r.bottom - r.top;
 		IfThenStatement(w <= 1 && h <= 1, return TRUE);
 
-		// Get the windows title
-		wchar_t* buffer = new wchar_t[length + 1];
-		GetWindowText(hWnd, buffer, length + 1);
-		std::wstring text = buffer;
-		std::string windowTitle(text.begin(), text.end());
-		delete[] buffer;
-
 		// Special cases:
 		if (windowTitle == "Program Manager" || windowTitle == "Cat")
 		{
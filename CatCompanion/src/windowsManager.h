@@ -4,17 +4,13 @@
 #include <Windows.h>
 
 #include "monitorManager.h"
+#include "frameArena.h"
+#include "platformGraph.h"
+#include "windowCoverage.h"
+#include "windowCache.h"
 
 class CFont;
 
-struct Platform
-{
-	float Left;
-	float Right;
-	float Height;
-	HWND Hwnd;
-};
-
 class CWindowsManager
 {
 public:
@@ -27,11 +23,13 @@ public:
 	void Render();
 
 	std::vector<Platform>& GetPlatforms();
+	CPlatformGraph& GetPlatformGraph();
+	CWindowCoverage& GetCoverage();
 	bool GetPlatformsFromWindow(HWND hwnd, std::vector<Platform>& platforms);
 
 	bool GetWindowBoundryLocalCoords(HWND hWnd, RECT& bounds);
 	bool GetWindowBoundry(HWND hWnd, RECT& bounds);
-	std::string GetWindowName(HWND hWnd);
+	const std::string& GetWindowName(HWND hWnd);
 
 private:
 	static CWindowsManager* Instance;
@@ -41,15 +39,24 @@ private:
 
 	std::map<HWND, RECT> VisibleWindowsBounds;
 	std::vector<HWND> VisibleWindows;
+	CWindowCache WindowCache;
 
 	std::vector<Platform> Platforms;
 	std::map<HWND, std::vector<Platform>> WindowPlatforms;
+	CPlatformGraph PlatformGraph;
+	CWindowCoverage Coverage;
+
+	int PlatformsStat;
+	int VisibleWindowsStat;
+	int PlatformEdgesStat;
+	int WindowQueriesStat;
 
 	CWindowsManager();
 	CWindowsManager(CWindowsManager const&);
 
+	void SyncReplay();
 	void CalculatePlatforms();
-	void CalculatePlatform(Platform platform, std::vector<RECT>& bounds, int startIndex = 0);
+	void CalculatePlatform(Platform platform, FrameVector<RECT>& bounds, int startIndex = 0);
 	static BOOL CALLBACK EnumWindowCallback(HWND hWnd, LPARAM lparam);
 };
 
@@ -0,0 +1,74 @@
+#include <cmath>
+
+#include "affine2D.h"
+
+/*
+	Initialises an identity transform
+*/
+SAffine2D::SAffine2D() : ColumnX(1.0f, 0.0f), ColumnY(0.0f, 1.0f), Translation(0.0f, 0.0f)
+{
+}
+
+SAffine2D::SAffine2D(glm::vec2 columnX, glm::vec2 columnY, glm::vec2 translation) : ColumnX(columnX), ColumnY(columnY), Translation(translation)
+{
+}
+
+/*
+	Builds the transform for a flat object, the same result as multiplying the translate, rotate, scale
+	and pivot matrices together
+
+	@param translation Location of the object
+	@param scale Scale of the object, negative to flip
+	@param rotationZ Rotation around the z axis in degrees
+	@param pivot Point in local space that sits at the location
+	@return The combined transform
+*/
+SAffine2D SAffine2D::Compose(glm::vec2 translation, glm::vec2 scale, float rotationZ, glm::vec2 pivot)
+{
+	float cosine = 1.0f;
+	float sine = 0.0f;
+
+	// Most objects are never rotated so skip the trigonometry
+	if (rotationZ != 0.0f)
+	{
+		float radians = glm::radians(rotationZ);
+		cosine = std::cos(radians);
+		sine = std::sin(radians);
+	}
+
+	glm::vec2 columnX = glm::vec2(cosine, sine) * scale.x;
+	glm::vec2 columnY = glm::vec2(-sine, cosine) * scale.y;
+
+	return SAffine2D(columnX, columnY, translation - columnX * pivot.x - columnY * pivot.y);
+}
+
+/*
+	Combines two transforms, other is applied first
+*/
+SAffine2D SAffine2D::operator*(const SAffine2D& other) const
+{
+	return SAffine2D(ColumnX * other.ColumnX.x + ColumnY * other.ColumnX.y,
+		ColumnX * other.ColumnY.x + ColumnY * other.ColumnY.y,
+		TransformPoint(other.Translation));
+}
+
+glm::vec2 SAffine2D::TransformPoint(glm::vec2 point) const
+{
+	return ColumnX * point.x + ColumnY * point.y + Translation;
+}
+
+/*
+	Expands the transform into a model matrix for uploading
+
+	@param depth The z translation
+	@param depthScale The z scale
+	@return The model matrix
+*/
+glm::mat4 SAffine2D::ToMat4(float depth, float depthScale) const
+{
+	return glm::mat4(
+		ColumnX.x, ColumnX.y, 0.0f, 0.0f,
+		ColumnY.x, ColumnY.y, 0.0f, 0.0f,
+		0.0f, 0.0f, depthScale, 0.0f,
+		Translation.x, Translation.y, depth, 1.0f);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <glm.hpp>
+
+/*
+	A 2D affine transform stored as a 2x3 matrix, the two linear columns and a translation.
+	Sprites and other flat objects build their transform in this form and only expand it to
+	a mat4 when it is uploaded to a shader
+*/
+struct SAffine2D
+{
+	glm::vec2 ColumnX; // Where the x axis ends up
+	glm::vec2 ColumnY; // Where the y axis ends up
+	glm::vec2 Translation;
+
+	SAffine2D();
+	SAffine2D(glm::vec2 columnX, glm::vec2 columnY, glm::vec2 translation);
+
+	// Builds translation * rotation * scale * translate(-pivot) without any matrix multiplication
+	static SAffine2D Compose(glm::vec2 translation, glm::vec2 scale, float rotationZ = 0.0f, glm::vec2 pivot = glm::vec2());
+
+	SAffine2D operator*(const SAffine2D& other) const;
+	glm::vec2 TransformPoint(glm::vec2 point) const;
+
+	glm::mat4 ToMat4(float depth = 0.0f, float depthScale = 1.0f) const;
+};
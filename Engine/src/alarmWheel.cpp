@@ -0,0 +1,349 @@
+#include <vector>
+#include <unordered_map>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+
+#include "alarmWheel.h"
+#include "helper.h"
+#include "profiler.h"
+#include "timer.h"
+
+#define ALARM_TICKS_PER_SECOND 1000 // One tick per millisecond
+#define WHEEL_BITS 8
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 4 // Covers 2^32 ticks, alarms further out than that are clamped to it
+#define MAX_ALARM_TICKS ((((uint64_t)1) << (WHEEL_BITS * WHEEL_LEVELS)) - 1)
+
+#define LIST_EXPIRING (WHEEL_LEVELS * WHEEL_SLOTS) // Alarms waiting to run this tick
+#define LIST_COUNT (LIST_EXPIRING + 1)
+#define LIST_FREE -1
+#define NO_NODE -1
+
+/*
+	Each level of the wheel has 256 slots, a slot on level n holds the alarms due within one
+	256^n tick window. Level 0 slots are run as the clock reaches them, higher level slots are
+	cascaded down a level whenever the level below wraps around
+*/
+struct SAlarm
+{
+	std::function<void()> Function;
+	const void* Owner;
+	uint64_t Expiry; // Tick the alarm runs on
+	uint32_t Generation; // Increased whenever the node is freed so old handles stop matching
+	int List; // Slot the node is linked into, LIST_FREE if it isn't in use
+	int Previous;
+	int Next;
+	int OwnerPrevious; // The other alarms with the same owner
+	int OwnerNext;
+};
+
+static std::vector<SAlarm> Alarms;
+static int ListHeads[LIST_COUNT];
+static bool ListsInitialised = false;
+static int FreeHead = NO_NODE;
+static std::unordered_map<const void*, int> OwnerHeads; // First alarm of each owner with alarms pending
+static int PendingCount = 0;
+
+static uint64_t CurrentTick = 0;
+
+static void InitialiseLists()
+{
+	IfThenReturn(ListsInitialised, );
+
+	for (int& head : ListHeads) { head = NO_NODE; }
+	ListsInitialised = true;
+}
+
+static void Link(int index, int list)
+{
+	SAlarm& alarm = Alarms[index];
+	alarm.List = list;
+	alarm.Previous = NO_NODE;
+	alarm.Next = ListHeads[list];
+
+	IfThenStatement(alarm.Next != NO_NODE, Alarms[alarm.Next].Previous = index);
+	ListHeads[list] = index;
+}
+
+static void Unlink(int index)
+{
+	SAlarm& alarm = Alarms[index];
+
+	if (alarm.Previous != NO_NODE) { Alarms[alarm.Previous].Next = alarm.Next; }
+	else { ListHeads[alarm.List] = alarm.Next; }
+
+	IfThenStatement(alarm.Next != NO_NODE, Alarms[alarm.Next].Previous = alarm.Previous);
+	alarm.List = LIST_FREE;
+}
+
+static void LinkOwner(int index)
+{
+	SAlarm& alarm = Alarms[index];
+	IfThenReturn(alarm.Owner == nullptr, );
+
+	int& head = OwnerHeads.insert({ alarm.Owner, NO_NODE }).first->second;
+	alarm.OwnerPrevious = NO_NODE;
+	alarm.OwnerNext = head;
+
+	IfThenStatement(alarm.OwnerNext != NO_NODE, Alarms[alarm.OwnerNext].OwnerPrevious = index);
+	head = index;
+}
+
+static void UnlinkOwner(int index)
+{
+	SAlarm& alarm = Alarms[index];
+	IfThenReturn(alarm.Owner == nullptr, );
+
+	IfThenStatement(alarm.OwnerNext != NO_NODE, Alarms[alarm.OwnerNext].OwnerPrevious = alarm.OwnerPrevious);
+
+	if (alarm.OwnerPrevious != NO_NODE)
+	{
+		Alarms[alarm.OwnerPrevious].OwnerNext = alarm.OwnerNext;
+	}
+	else if (alarm.OwnerNext != NO_NODE)
+	{
+		OwnerHeads[alarm.Owner] = alarm.OwnerNext;
+	}
+	else
+	{
+		OwnerHeads.erase(alarm.Owner);
+	}
+}
+
+/*
+	Links an alarm into the slot for its expiry, the level is picked by how far away the expiry is
+*/
+static void Schedule(int index)
+{
+	uint64_t expiry = Alarms[index].Expiry;
+	uint64_t delta = expiry - CurrentTick;
+
+	for (int level = 0; level < WHEEL_LEVELS; ++level)
+	{
+		if (delta < ((uint64_t)1 << (WHEEL_BITS * (level + 1))) || level == WHEEL_LEVELS - 1)
+		{
+			Link(index, level * WHEEL_SLOTS + (int)((expiry >> (WHEEL_BITS * level)) & WHEEL_MASK));
+			return;
+		}
+	}
+}
+
+static void Free(int index)
+{
+	SAlarm& alarm = Alarms[index];
+	IfThenStatement(alarm.List != LIST_FREE, Unlink(index));
+	UnlinkOwner(index);
+
+	alarm.Function = nullptr;
+	alarm.Owner = nullptr;
+	alarm.Generation++;
+	alarm.Next = FreeHead;
+	FreeHead = index;
+	PendingCount--;
+}
+
+/*
+	Moves every alarm in the current slot of a level down to the levels below it
+
+	@param level The level to cascade, 1 or higher
+*/
+static void Cascade(int level)
+{
+	int slot = (int)((CurrentTick >> (WHEEL_BITS * level)) & WHEEL_MASK);
+
+	// The level above has to be brought down first when this level wraps around
+	IfThenStatement(slot == 0 && level + 1 < WHEEL_LEVELS, Cascade(level + 1));
+
+	int list = level * WHEEL_SLOTS + slot;
+
+	while (ListHeads[list] != NO_NODE)
+	{
+		int index = ListHeads[list];
+		Unlink(index);
+		Schedule(index);
+	}
+}
+
+/*
+	Advances the clock one tick and runs the alarms in the slot it reaches
+*/
+static void Tick()
+{
+	CurrentTick++;
+	IfThenStatement((CurrentTick & WHEEL_MASK) == 0, Cascade(1));
+
+	int list = (int)(CurrentTick & WHEEL_MASK);
+	IfThenReturn(ListHeads[list] == NO_NODE, );
+
+	// Move the due alarms to their own list so alarms set or cancelled while running don't disturb the slot
+	while (ListHeads[list] != NO_NODE)
+	{
+		int index = ListHeads[list];
+		Unlink(index);
+		Link(index, LIST_EXPIRING);
+	}
+
+	while (ListHeads[LIST_EXPIRING] != NO_NODE)
+	{
+		int index = ListHeads[LIST_EXPIRING];
+		std::function<void()> function = std::move(Alarms[index].Function);
+		Free(index);
+
+		function();
+	}
+}
+
+/*
+	Advances the alarm clock to the simulation time and runs every alarm that is due, alarms run in the order
+	they come due. The clock follows the step count so it can't drift from TIMER and keeps up with SetStepRate
+*/
+void ALARM::Update()
+{
+	PROFILE_SCOPE("ALARM::Update");
+
+	long long targetTick = std::llround(TIMER::GetTotalSeconds() * ALARM_TICKS_PER_SECOND);
+	IfThenReturn(targetTick <= (long long)CurrentTick, );
+
+	while (CurrentTick < (uint64_t)targetTick)
+	{
+		// Nothing can come due, skip straight to the end
+		if (PendingCount == 0)
+		{
+			CurrentTick = (uint64_t)targetTick;
+			break;
+		}
+
+		Tick();
+	}
+}
+
+/*
+	Cancels every alarm without running it
+*/
+void ALARM::CleanUp()
+{
+	Alarms.clear();
+	Alarms.shrink_to_fit();
+	OwnerHeads.clear();
+	ListsInitialised = false;
+	InitialiseLists();
+
+	FreeHead = NO_NODE;
+	PendingCount = 0;
+}
+
+/*
+	Sets a function to run once after x seconds of alarm time
+
+	@param seconds Seconds before the function is run, 0 runs it on the next update
+	@param function The function to run
+	@param owner Optional owner so all of its alarms can be cancelled together
+	@return A handle for cancelling the alarm
+*/
+AlarmHandle ALARM::Set(float seconds, std::function<void()> function, const void* owner)
+{
+	InitialiseLists();
+
+	int index = FreeHead;
+
+	if (index != NO_NODE)
+	{
+		FreeHead = Alarms[index].Next;
+	}
+	else
+	{
+		index = (int)Alarms.size();
+		Alarms.push_back(SAlarm{ nullptr, nullptr, 0, 1, LIST_FREE, NO_NODE, NO_NODE, NO_NODE, NO_NODE });
+	}
+
+	// Alarms always wait at least one tick so an alarm can't run inside the tick that set it
+	double ticks = std::ceil((double)std::max(0.0f, seconds) * ALARM_TICKS_PER_SECOND);
+	uint64_t delay = (uint64_t)std::min(std::max(1.0, ticks), (double)MAX_ALARM_TICKS);
+
+	SAlarm& alarm = Alarms[index];
+	alarm.Function = std::move(function);
+	alarm.Owner = owner;
+	alarm.Expiry = CurrentTick + delay;
+
+	Schedule(index);
+	LinkOwner(index);
+	PendingCount++;
+
+	return ((AlarmHandle)alarm.Generation << 32) | (AlarmHandle)index;
+}
+
+/*
+	Finds the alarm a handle refers to
+
+	@return The alarm index, NO_NODE if it has already run or been cancelled
+*/
+static int FindAlarm(AlarmHandle handle)
+{
+	IfThenReturn(handle == NO_ALARM, NO_NODE);
+
+	int index = (int)(handle & 0xFFFFFFFF);
+	uint32_t generation = (uint32_t)(handle >> 32);
+
+	IfThenReturn(index >= (int)Alarms.size(), NO_NODE);
+	IfThenReturn(Alarms[index].Generation != generation || Alarms[index].List == LIST_FREE, NO_NODE);
+
+	return index;
+}
+
+/*
+	Stops an alarm from running
+
+	@param handle The alarm to stop, this is set to NO_ALARM
+	@return If the alarm was still waiting to run
+*/
+bool ALARM::Cancel(AlarmHandle& handle)
+{
+	int index = FindAlarm(handle);
+	handle = NO_ALARM;
+
+	IfThenReturn(index == NO_NODE, false);
+
+	Free(index);
+	return true;
+}
+
+/*
+	Cancels every alarm set with this owner, objects call this when they're destroyed. Only the owner's
+	own alarms are looked at, an owner without any costs one lookup
+
+	@param owner The owner passed to Set
+*/
+void ALARM::CancelAll(const void* owner)
+{
+	IfThenReturn(PendingCount == 0 || owner == nullptr, );
+
+	auto it = OwnerHeads.find(owner);
+	IfThenReturn(it == OwnerHeads.end(), );
+
+	// Freeing the last alarm erases the owner's entry
+	int index = it->second;
+
+	while (index != NO_NODE)
+	{
+		int next = Alarms[index].OwnerNext;
+		Free(index);
+		index = next;
+	}
+}
+
+bool ALARM::IsPending(AlarmHandle handle)
+{
+	return FindAlarm(handle) != NO_NODE;
+}
+
+int ALARM::GetPendingCount()
+{
+	return PendingCount;
+}
+
+double ALARM::GetTime()
+{
+	return (double)CurrentTick / ALARM_TICKS_PER_SECOND;
+}
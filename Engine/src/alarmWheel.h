@@ -0,0 +1,24 @@
+#pragma once
+#include <functional>
+
+typedef unsigned long long AlarmHandle;
+#define NO_ALARM 0
+
+/*
+	A hierarchical timer wheel that runs every alarm in the program. Setting, cancelling and expiring
+	an alarm are all constant time and only the alarms that are due are ever looked at, objects without
+	alarms cost nothing. Alarms run on the main thread from ALARM::Update
+*/
+namespace ALARM
+{
+	void Update(); // Advances the alarm clock to the simulation time and runs every alarm that is due
+	void CleanUp(); // Cancels every alarm without running it
+
+	AlarmHandle Set(float seconds, std::function<void()> function, const void* owner = nullptr); // Runs the function once in x seconds
+	bool Cancel(AlarmHandle& handle); // Stops the alarm and clears the handle, returns false if it had already run
+	void CancelAll(const void* owner); // Cancels every alarm set with this owner
+	bool IsPending(AlarmHandle handle);
+
+	int GetPendingCount();
+	double GetTime(); // Seconds the alarm clock has advanced since the program started
+}
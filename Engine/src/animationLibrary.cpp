@@ -0,0 +1,553 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+
+#include "animationLibrary.h"
+#include "texture.h"
+#include "helper.h"
+
+#define ANIMATION_FILE_VERSION 1
+
+std::map<std::string, CAnimationLibrary*> CAnimationLibrary::Libraries; // All shared libraries
+
+/*
+	Layout of a compiled animation file:
+	SAnimationFileHeader, then for each animation the name and sheet name (uint16 length followed by
+	the characters), an SAnimationRecord and FrameCount pairs of uint8 frame coordinates
+*/
+struct SAnimationFileHeader
+{
+	char Magic[4];
+	uint32_t Version;
+	uint32_t AnimationCount;
+};
+
+struct SAnimationRecord
+{
+	int32_t SplitX;
+	int32_t SplitY;
+	float PivotX; // Fraction of one frame
+	float PivotY;
+	float FPS;
+	uint8_t AnimationType;
+	uint8_t Flipped;
+	uint16_t FrameCount;
+};
+
+struct SAnimationSource
+{
+	std::string Name;
+	int Line = 0;
+
+	std::string Sheet;
+	SAnimationRecord Record = {};
+	bool HasType = false;
+	bool AllFrames = false;
+	std::vector<glm::ivec2> Frames;
+};
+
+SSpriteAnimation::SSpriteAnimation()
+{
+}
+
+SSpriteAnimation::SSpriteAnimation(CTexture* spriteSheet, int splitX, int splitY, glm::vec2 pivot, std::vector<glm::ivec2> frames, EAnimationType animationType, float fps, bool flipped)
+{
+	SpriteSheet = spriteSheet;
+	SplitX = splitX;
+	SplitY = splitY;
+	Pivot = pivot;
+	Frames = frames;
+	AnimationType = animationType;
+	FPS = fps;
+	Flipped = flipped;
+}
+
+SSpriteAnimation::SSpriteAnimation(CTexture* spriteSheet, int splitX, int splitY, glm::vec2 pivot, EAnimationType animationType, float fps, bool flipped)
+{
+	SpriteSheet = spriteSheet;
+	SplitX = splitX;
+	SplitY = splitY;
+	Pivot = pivot;
+	AnimationType = animationType;
+	FPS = fps;
+	Flipped = flipped;
+
+	for (int y = 0; y < splitY; ++y)
+	{
+		for (int x = 0; x < splitX; ++x)
+		{
+			Frames.push_back({ x, y });
+		}
+	}
+}
+
+/*
+	Adds an animation and works out everything that can be calculated ahead of time
+
+	@param name The name the animation can be looked up by
+	@param animation The animation to add
+	@return The handle of the animation, if the name already exists that animation is replaced
+*/
+AnimationHandle CAnimationLibrary::AddAnimation(const std::string& name, SSpriteAnimation animation)
+{
+	// Resolve each frame into a rectangle on the sprite sheet
+	glm::vec2 uvSize = glm::vec2(1.0f / std::max(animation.SplitX, 1), 1.0f / std::max(animation.SplitY, 1));
+	animation.UVRects.clear();
+
+	for (const glm::ivec2& frame : animation.Frames)
+	{
+		animation.UVRects.push_back(glm::vec4(glm::vec2(frame) * uvSize, uvSize));
+	}
+
+	if (animation.SpriteSheet != nullptr)
+	{
+		animation.FrameSize = glm::vec2(animation.SpriteSheet->GetDimensions()) * uvSize;
+	}
+	else
+	{
+		std::cout << "WARNING: Animation " << name << " has no sprite sheet" << std::endl;
+	}
+
+	animation.Length = (animation.FPS > 0.0f) ? (animation.Frames.size() / animation.FPS) * (animation.AnimationType == EAnimationType::PingPong ? 2.0f : 1.0f) : 0.0f;
+
+	std::map<std::string, AnimationHandle>::iterator it = Handles.find(name);
+
+	if (it != Handles.end())
+	{
+		Animations[it->second] = animation;
+		return it->second;
+	}
+
+	AnimationHandle handle = (AnimationHandle)Animations.size();
+	Animations.push_back(animation);
+	Names.push_back(name);
+	Handles.insert({ name, handle });
+
+	return handle;
+}
+
+AnimationHandle CAnimationLibrary::GetHandle(const std::string& name)
+{
+	std::map<std::string, AnimationHandle>::iterator it = Handles.find(name);
+	return (it != Handles.end()) ? it->second : NO_ANIMATION;
+}
+
+const SSpriteAnimation& CAnimationLibrary::GetAnimation(AnimationHandle handle)
+{
+	return Animations[handle];
+}
+
+const std::string& CAnimationLibrary::GetName(AnimationHandle handle)
+{
+	return Names[handle];
+}
+
+int CAnimationLibrary::GetAnimationCount()
+{
+	return (int)Animations.size();
+}
+
+void CAnimationLibrary::CleanUp()
+{
+	std::for_each(Libraries.begin(), Libraries.end(), [](std::pair<const std::string, CAnimationLibrary*>& it) { delete it.second; });
+	Libraries.clear();
+}
+
+CAnimationLibrary* CAnimationLibrary::GetLibrary(std::string libraryName)
+{
+	std::map<std::string, CAnimationLibrary*>::iterator it = Libraries.find(libraryName);
+	return (it != Libraries.end()) ? it->second : nullptr;
+}
+
+/*
+	Stores a library so it can be shared, the library will be deleted on clean up
+
+	@param libraryName The name to store the library under
+	@param library The library to store
+*/
+void CAnimationLibrary::SetLibrary(std::string libraryName, CAnimationLibrary* library)
+{
+	CAnimationLibrary*& existing = Libraries[libraryName];
+	IfThenStatement(existing != nullptr && existing != library, delete existing);
+	existing = library;
+}
+
+/*
+	Loads every animation file into a library named after the file, the text source is compiled
+	to a binary file next to it whenever the binary is missing or older than the source
+*/
+void CAnimationLibrary::GenerateLibraries()
+{
+	std::string filepath = GetFilepath();
+
+	if (!std::filesystem::exists(filepath))
+	{
+		std::cout << "WARNING: Unable to find the animations folder " << filepath << std::endl;
+		return;
+	}
+
+	for (const auto& entry : std::filesystem::directory_iterator(filepath))
+	{
+		IfThenStatement(entry.path().extension().u8string() != ".anim", continue);
+
+		std::string name = entry.path().filename().replace_extension().u8string();
+		std::string sourcePath = entry.path().u8string();
+		std::string binaryPath = filepath + name + ".animbin";
+
+		bool isOutdated = IsOutdated(sourcePath, binaryPath);
+		bool isCompiled = isOutdated && CompileAnimationFile(sourcePath, binaryPath);
+
+		CAnimationLibrary* library = LoadCompiledAnimationFile(binaryPath);
+
+		// The binary may be from an older version of the format, or another process may have replaced it with one that
+		// is, try building it again unless the source has just failed to compile
+		if (library == nullptr && (!isOutdated || isCompiled) && CompileAnimationFile(sourcePath, binaryPath))
+		{
+			library = LoadCompiledAnimationFile(binaryPath);
+		}
+
+		IfThenStatement(library != nullptr, SetLibrary(name, library));
+	}
+}
+
+/*
+	Compiles every animation file with a missing or outdated binary without loading anything. Processes that share the
+	resources folder call this once before starting the others so they don't all compile the same files
+*/
+void CAnimationLibrary::CompileLibraries()
+{
+	std::string filepath = GetFilepath();
+	IfThenReturn(!std::filesystem::exists(filepath), );
+
+	for (const auto& entry : std::filesystem::directory_iterator(filepath))
+	{
+		IfThenStatement(entry.path().extension().u8string() != ".anim", continue);
+
+		std::string sourcePath = entry.path().u8string();
+		std::string binaryPath = filepath + entry.path().filename().replace_extension().u8string() + ".animbin";
+
+		IfThenStatement(IsOutdated(sourcePath, binaryPath), CompileAnimationFile(sourcePath, binaryPath));
+	}
+}
+
+// Animation files are shared resources, next to the shaders and fonts
+std::string CAnimationLibrary::GetFilepath()
+{
+	return (std::filesystem::current_path().parent_path()).string() + "\\Resources\\Animations\\";
+}
+
+bool CAnimationLibrary::IsOutdated(const std::string& sourcePath, const std::string& binaryPath)
+{
+	std::error_code error;
+	return !std::filesystem::exists(binaryPath) || std::filesystem::last_write_time(sourcePath, error) > std::filesystem::last_write_time(binaryPath, error);
+}
+
+static void WriteString(std::ofstream& file, const std::string& string)
+{
+	uint16_t length = (uint16_t)string.size();
+	file.write((const char*)&length, sizeof(length));
+	file.write(string.data(), length);
+}
+
+/*
+	Parses and validates a text animation file then writes the compact binary version, nothing is
+	written if there are any errors so the last good binary keeps being used. The binary is written to
+	a file of its own first and renamed over the old one, so a process loading it never reads half a file
+
+	@param sourcePath The text file to compile
+	@param binaryPath The file to write
+	@return If the file was compiled successfully
+*/
+bool CAnimationLibrary::CompileAnimationFile(const std::string& sourcePath, const std::string& binaryPath)
+{
+	std::ifstream infile(sourcePath);
+
+	if (!infile.is_open())
+	{
+		std::cout << "WARNING: Unable to open animation file " << sourcePath << std::endl;
+		return false;
+	}
+
+	std::vector<SAnimationSource> animations;
+	int errors = 0;
+	int lineNumber = 0;
+
+	auto reportError = [&](int line, const std::string& message)
+	{
+		std::cout << "WARNING: " << sourcePath << "(" << line << "): " << message << std::endl;
+		errors++;
+	};
+
+	std::string line;
+	while (std::getline(infile, line))
+	{
+		lineNumber++;
+		line = HELPER::Trim(line);
+		IfThenStatement(line == "" || line[0] == '#', continue);
+
+		// Start of a new animation
+		if (line.front() == '[' && line.back() == ']')
+		{
+			SAnimationSource animation;
+			animation.Name = HELPER::Trim(line.substr(1, line.size() - 2));
+			animation.Line = lineNumber;
+			animation.Record.SplitX = 1;
+			animation.Record.SplitY = 1;
+			animation.Record.FPS = -1.0f;
+
+			IfThenStatement(animation.Name == "", reportError(lineNumber, "Animation has no name"));
+			animations.push_back(animation);
+			continue;
+		}
+
+		size_t separator = line.find(':');
+
+		if (separator == std::string::npos || animations.empty())
+		{
+			reportError(lineNumber, "Expected [name] or property: value");
+			continue;
+		}
+
+		SAnimationSource& animation = animations.back();
+		SAnimationRecord& record = animation.Record;
+		std::string key = HELPER::Trim(line.substr(0, separator));
+		std::string value = HELPER::Trim(line.substr(separator + 1));
+		std::istringstream stream(value);
+
+		if (key == "sheet")
+		{
+			animation.Sheet = value;
+		}
+		else if (key == "split")
+		{
+			IfThenStatement(!(stream >> record.SplitX >> record.SplitY), reportError(lineNumber, "split needs two whole numbers"));
+		}
+		else if (key == "pivot")
+		{
+			IfThenStatement(!(stream >> record.PivotX >> record.PivotY), reportError(lineNumber, "pivot needs two numbers"));
+		}
+		else if (key == "fps")
+		{
+			IfThenStatement(!(stream >> record.FPS), reportError(lineNumber, "fps needs a number"));
+		}
+		else if (key == "type")
+		{
+			animation.HasType = true;
+
+			if (value == "toggle") { record.AnimationType = (uint8_t)EAnimationType::Toggle; }
+			else if (value == "loop") { record.AnimationType = (uint8_t)EAnimationType::Loop; }
+			else if (value == "pingpong") { record.AnimationType = (uint8_t)EAnimationType::PingPong; }
+			else { reportError(lineNumber, "Unknown type '" + value + "'"); }
+		}
+		else if (key == "flipped")
+		{
+			record.Flipped = (value == "true");
+			IfThenStatement(value != "true" && value != "false", reportError(lineNumber, "flipped must be true or false"));
+		}
+		else if (key == "frames")
+		{
+			animation.AllFrames = (value == "all");
+			animation.Frames.clear();
+
+			std::string frame;
+			while (!animation.AllFrames && stream >> frame)
+			{
+				glm::ivec2 coords;
+				char comma = 0;
+				std::istringstream frameStream(frame);
+
+				if (frameStream >> coords.x >> comma >> coords.y && comma == ',')
+				{
+					animation.Frames.push_back(coords);
+				}
+				else
+				{
+					reportError(lineNumber, "Frame '" + frame + "' should be x,y");
+				}
+			}
+		}
+		else
+		{
+			reportError(lineNumber, "Unknown property '" + key + "'");
+		}
+	}
+
+	// Validate each animation now that all of its properties are known
+	for (int i = 0; i < (int)animations.size(); ++i)
+	{
+		SAnimationSource& animation = animations[i];
+		SAnimationRecord& record = animation.Record;
+		int line = animation.Line;
+
+		for (int j = 0; j < i; ++j)
+		{
+			IfThenStatement(animations[j].Name == animation.Name, reportError(line, "Animation '" + animation.Name + "' is defined more than once"));
+		}
+
+		IfThenStatement(animation.Sheet == "", reportError(line, "'" + animation.Name + "' has no sheet"));
+		IfThenStatement(!animation.HasType, reportError(line, "'" + animation.Name + "' has no type"));
+		IfThenStatement(record.FPS < 0.0f, reportError(line, "'" + animation.Name + "' needs an fps of 0 or more"));
+
+		if (record.SplitX < 1 || record.SplitY < 1 || record.SplitX > 256 || record.SplitY > 256)
+		{
+			reportError(line, "'" + animation.Name + "' split must be between 1 and 256");
+			continue;
+		}
+
+		if (animation.AllFrames)
+		{
+			for (int y = 0; y < record.SplitY; ++y)
+			{
+				for (int x = 0; x < record.SplitX; ++x) { animation.Frames.push_back({ x, y }); }
+			}
+		}
+
+		IfThenStatement(animation.Frames.empty(), reportError(line, "'" + animation.Name + "' has no frames"));
+		IfThenStatement(animation.Frames.size() > UINT16_MAX, reportError(line, "'" + animation.Name + "' has too many frames"));
+		IfThenStatement(animation.HasType && record.AnimationType == (uint8_t)EAnimationType::PingPong && animation.Frames.size() < 2, reportError(line, "'" + animation.Name + "' needs at least two frames to ping pong"));
+
+		for (const glm::ivec2& frame : animation.Frames)
+		{
+			if (frame.x < 0 || frame.y < 0 || frame.x >= record.SplitX || frame.y >= record.SplitY)
+			{
+				reportError(line, "'" + animation.Name + "' has frame " + std::to_string(frame.x) + "," + std::to_string(frame.y) + " outside of its split");
+				break;
+			}
+		}
+
+		record.FrameCount = (uint16_t)animation.Frames.size();
+	}
+
+	if (errors > 0)
+	{
+		std::cout << "WARNING: " << sourcePath << " has " << errors << " error(s) and was not compiled" << std::endl;
+		return false;
+	}
+
+	// Named after the process so two processes compiling the same file don't write into each other's
+	std::string temporaryPath = binaryPath + "." + std::to_string(GetCurrentProcessId()) + ".tmp";
+	std::ofstream outfile(temporaryPath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+	if (!outfile.is_open())
+	{
+		std::cout << "WARNING: Unable to write compiled animation file " << temporaryPath << std::endl;
+		return false;
+	}
+
+	SAnimationFileHeader header = { { 'A', 'N', 'I', 'M' }, ANIMATION_FILE_VERSION, (uint32_t)animations.size() };
+	outfile.write((const char*)&header, sizeof(header));
+
+	for (const SAnimationSource& animation : animations)
+	{
+		WriteString(outfile, animation.Name);
+		WriteString(outfile, animation.Sheet);
+		outfile.write((const char*)&animation.Record, sizeof(animation.Record));
+
+		for (const glm::ivec2& frame : animation.Frames)
+		{
+			uint8_t coords[2] = { (uint8_t)frame.x, (uint8_t)frame.y };
+			outfile.write((const char*)coords, sizeof(coords));
+		}
+	}
+
+	outfile.close();
+
+	// Replaces the old binary in one step, a file that didn't write fully is never moved into place
+	std::error_code error;
+	IfThenStatement(!outfile.fail(), std::filesystem::rename(temporaryPath, binaryPath, error));
+
+	if (outfile.fail() || error)
+	{
+		std::cout << "WARNING: Unable to write compiled animation file " << binaryPath << std::endl;
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+
+	std::cout << "Animation file " << sourcePath << " has been compiled" << std::endl;
+	return true;
+}
+
+/*
+	Reads a compiled animation file straight into a new library
+
+	@param binaryPath The compiled file
+	@return The new library, or nullptr if the file is missing or not valid
+*/
+CAnimationLibrary* CAnimationLibrary::LoadCompiledAnimationFile(const std::string& binaryPath)
+{
+	std::ifstream infile(binaryPath, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+	IfThenReturn(!infile.is_open(), nullptr);
+
+	std::vector<char> buffer((size_t)infile.tellg());
+	infile.seekg(0);
+	infile.read(buffer.data(), buffer.size());
+
+	const char* read = buffer.data();
+	const char* end = read + buffer.size();
+
+	// Copies the next value out of the buffer, fails if the file is too short
+	auto readBytes = [&](void* destination, size_t size)
+	{
+		IfThenReturn(end - read < (ptrdiff_t)size, false);
+		std::memcpy(destination, read, size);
+		read += size;
+		return true;
+	};
+
+	auto readString = [&](std::string& string)
+	{
+		uint16_t length = 0;
+		IfThenReturn(!readBytes(&length, sizeof(length)) || end - read < length, false);
+		string.assign(read, length);
+		read += length;
+		return true;
+	};
+
+	SAnimationFileHeader header;
+	if (!readBytes(&header, sizeof(header)) || std::memcmp(header.Magic, "ANIM", 4) != 0 || header.Version != ANIMATION_FILE_VERSION)
+	{
+		std::cout << "WARNING: " << binaryPath << " is not a compiled animation file of the current version" << std::endl;
+		return nullptr;
+	}
+
+	CAnimationLibrary* library = new CAnimationLibrary();
+
+	for (uint32_t i = 0; i < header.AnimationCount; ++i)
+	{
+		std::string name;
+		std::string sheet;
+		SAnimationRecord record;
+
+		if (!readString(name) || !readString(sheet) || !readBytes(&record, sizeof(record)) || end - read < record.FrameCount * 2)
+		{
+			std::cout << "WARNING: " << binaryPath << " is truncated" << std::endl;
+			delete library;
+			return nullptr;
+		}
+
+		SSpriteAnimation animation;
+		animation.SpriteSheet = CTexture::GetTexture(sheet);
+		animation.SplitX = record.SplitX;
+		animation.SplitY = record.SplitY;
+		animation.AnimationType = (EAnimationType)record.AnimationType;
+		animation.FPS = record.FPS;
+		animation.Flipped = record.Flipped != 0;
+
+		for (int frame = 0; frame < record.FrameCount; ++frame, read += 2)
+		{
+			animation.Frames.push_back({ (uint8_t)read[0], (uint8_t)read[1] });
+		}
+
+		// Skip animations whose sprite sheet couldn't be found rather than drawing without a texture
+		IfThenStatement(animation.SpriteSheet == nullptr, continue);
+
+		animation.Pivot = glm::vec2(animation.SpriteSheet->GetDimensions()) / glm::vec2(animation.SplitX, animation.SplitY) * glm::vec2(record.PivotX, record.PivotY);
+		library->AddAnimation(name, animation);
+	}
+
+	return library;
+}
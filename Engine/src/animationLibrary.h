@@ -0,0 +1,71 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <glm.hpp>
+
+class CTexture;
+
+enum class EAnimationType
+{
+	Toggle,
+	Loop,
+	PingPong,
+};
+
+struct SSpriteAnimation
+{
+	CTexture* SpriteSheet = nullptr; // The ID of the sprite sheet for the animation
+	int SplitX = 0; // The number of sprites going horizontaly on the sprite sheet
+	int SplitY = 0; // The number of sprites going verticaly on the sprite sheet
+	glm::vec2 Pivot = glm::vec2(); // The pivot of one frame
+	std::vector<glm::ivec2> Frames; // A list of frames which map to sprite sheet coords
+	EAnimationType AnimationType; // The type of animation (What happens after it is done etc.)
+	float FPS = 0.0f; // The frames per second of the animation
+	bool Flipped = false; // Whether the sprite is flipped on the x-axis
+
+	// Resolved when the animation is added to a library
+	std::vector<glm::vec4> UVRects; // Each frame as a texture coordinate offset (xy) and size (zw)
+	glm::vec2 FrameSize = glm::vec2(); // The size of one frame in pixels
+	float Length = 0.0f; // Seconds to play through once, 0 if the animation doesn't move
+
+	SSpriteAnimation();
+	SSpriteAnimation(CTexture* spriteSheet, int splitX, int splitY, glm::vec2 pivot, std::vector<glm::ivec2> frames, EAnimationType animationType, float fps, bool flipped = false);
+	SSpriteAnimation(CTexture* spriteSheet, int splitX, int splitY, glm::vec2 pivot, EAnimationType animationType, float fps, bool flipped = false);
+};
+
+typedef int AnimationHandle;
+#define NO_ANIMATION -1
+
+/*
+	A read only set of animations shared between every sprite that uses them,
+	sprites refer to an animation by its handle rather than by name
+*/
+class CAnimationLibrary
+{
+public:
+	AnimationHandle AddAnimation(const std::string& name, SSpriteAnimation animation);
+
+	AnimationHandle GetHandle(const std::string& name); // Returns NO_ANIMATION if the name doesn't exist
+	const SSpriteAnimation& GetAnimation(AnimationHandle handle);
+	const std::string& GetName(AnimationHandle handle);
+	int GetAnimationCount();
+
+	static void CleanUp();
+	static void GenerateLibraries(); // Loads every animation file, textures must be generated first
+	static void CompileLibraries(); // Compiles the outdated animation files without loading them
+	static CAnimationLibrary* GetLibrary(std::string libraryName); // Returns nullptr if the library hasn't been created
+	static void SetLibrary(std::string libraryName, CAnimationLibrary* library);
+
+private:
+	std::vector<SSpriteAnimation> Animations;
+	std::vector<std::string> Names;
+	std::map<std::string, AnimationHandle> Handles;
+
+	static std::map<std::string, CAnimationLibrary*> Libraries; // All shared libraries
+
+	static std::string GetFilepath();
+	static bool IsOutdated(const std::string& sourcePath, const std::string& binaryPath);
+	static bool CompileAnimationFile(const std::string& sourcePath, const std::string& binaryPath);
+	static CAnimationLibrary* LoadCompiledAnimationFile(const std::string& binaryPath);
+};
@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "entityStore.h"
+#include "jobSystem.h"
+#include "helper.h"
+
+#define CHUNK_SIZE (16 * 1024) // Bytes per chunk, small enough to stay in the L1/L2 cache while a system runs over it
+#define CHUNK_ALIGNMENT 16
+
+static_assert(std::is_trivially_copyable<STransform>::value && std::is_trivially_copyable<SVelocity>::value && std::is_trivially_copyable<SSpriteAnim>::value &&
+	std::is_trivially_copyable<SPalette>::value && std::is_trivially_copyable<SBounds>::value, "Components are copied between chunks byte for byte");
+
+static const STransform DefaultTransform;
+static const SVelocity DefaultVelocity;
+static const SSpriteAnim DefaultSpriteAnim;
+static const SPalette DefaultPalette;
+static const SBounds DefaultBounds;
+
+const size_t CEntityStore::ComponentSizes[(int)EComponent::Count] = { sizeof(STransform), sizeof(SVelocity), sizeof(SSpriteAnim), sizeof(SPalette), sizeof(SBounds) };
+const void* CEntityStore::ComponentDefaults[(int)EComponent::Count] = { &DefaultTransform, &DefaultVelocity, &DefaultSpriteAnim, &DefaultPalette, &DefaultBounds };
+
+static size_t AlignUp(size_t value)
+{
+	return (value + CHUNK_ALIGNMENT - 1) & ~(size_t)(CHUNK_ALIGNMENT - 1);
+}
+
+static bool HasComponent(ComponentMask mask, int type)
+{
+	return (mask & (1u << type)) != 0;
+}
+
+/*
+	Creates an entity with a set of components, each starting with its default values
+
+	@param components The components the entity has, from GetComponentMask
+	@return The entity's handle
+*/
+EntityHandle CEntityStore::Create(ComponentMask components)
+{
+	EntityHandle entity = Entities.Insert(SLocation{ -1, -1, -1 });
+	*Entities.Get(entity) = AddRow(FindArchetype(components), entity);
+	return entity;
+}
+
+bool CEntityStore::Destroy(EntityHandle entity)
+{
+	SLocation* location = Entities.Get(entity);
+	IfThenReturn(location == nullptr, false);
+
+	RemoveRow(*location);
+	Entities.Remove(entity);
+	return true;
+}
+
+bool CEntityStore::IsAlive(EntityHandle entity)
+{
+	return Entities.IsValid(entity);
+}
+
+ComponentMask CEntityStore::GetComponents(EntityHandle entity)
+{
+	SLocation* location = Entities.Get(entity);
+	return location != nullptr ? Archetypes[location->Archetype].Mask : 0;
+}
+
+int CEntityStore::GetEntityCount()
+{
+	return Entities.Size();
+}
+
+int CEntityStore::GetArchetypeCount()
+{
+	return (int)Archetypes.size();
+}
+
+int CEntityStore::GetChunkCount()
+{
+	int count = 0;
+	for (SArchetype& archetype : Archetypes) { count += (int)archetype.Chunks.size(); }
+	return count;
+}
+
+/*
+	Finds the archetype with exactly these components, making it if there isn't one yet
+
+	@return The archetype's index
+*/
+int CEntityStore::FindArchetype(ComponentMask mask)
+{
+	for (int i = 0; i < (int)Archetypes.size(); ++i)
+	{
+		IfThenReturn(Archetypes[i].Mask == mask, i);
+	}
+
+	SArchetype archetype;
+	archetype.Mask = mask;
+
+	// Fit as many whole rows into a chunk as the alignment of each array allows
+	size_t rowSize = sizeof(EntityHandle);
+	for (int i = 0; i < (int)EComponent::Count; ++i) { rowSize += HasComponent(mask, i) ? ComponentSizes[i] : 0; }
+
+	int capacity = std::max(1, (int)(CHUNK_SIZE / rowSize));
+
+	while (true)
+	{
+		size_t offset = 0;
+
+		for (int i = 0; i < (int)EComponent::Count; ++i)
+		{
+			archetype.Offsets[i] = offset;
+			offset += HasComponent(mask, i) ? AlignUp(ComponentSizes[i] * capacity) : 0;
+		}
+
+		archetype.Offsets[(int)EComponent::Count] = offset;
+		offset += sizeof(EntityHandle) * capacity;
+
+		IfThenStatement(offset <= CHUNK_SIZE || capacity == 1, break);
+		capacity--;
+	}
+
+	archetype.Capacity = capacity;
+	Archetypes.push_back(std::move(archetype));
+	return (int)Archetypes.size() - 1;
+}
+
+EntityHandle* CEntityStore::GetHandles(SArchetype& archetype, SChunk& chunk)
+{
+	return reinterpret_cast<EntityHandle*>(chunk.Memory.get() + archetype.Offsets[(int)EComponent::Count]);
+}
+
+/*
+	Adds a row to the end of an archetype with every component set to its default
+*/
+CEntityStore::SLocation CEntityStore::AddRow(int archetypeIndex, EntityHandle entity)
+{
+	SArchetype& archetype = Archetypes[archetypeIndex];
+
+	if (archetype.Chunks.empty() || archetype.Chunks.back().Count == archetype.Capacity)
+	{
+		SChunk chunk;
+		chunk.Memory.reset(new unsigned char[CHUNK_SIZE]);
+		archetype.Chunks.push_back(std::move(chunk));
+	}
+
+	SChunk& chunk = archetype.Chunks.back();
+	int row = chunk.Count++;
+
+	for (int i = 0; i < (int)EComponent::Count; ++i)
+	{
+		IfThenStatement(!HasComponent(archetype.Mask, i), continue);
+		std::memcpy(chunk.Memory.get() + archetype.Offsets[i] + ComponentSizes[i] * row, ComponentDefaults[i], ComponentSizes[i]);
+	}
+
+	GetHandles(archetype, chunk)[row] = entity;
+	return SLocation{ archetypeIndex, (int)archetype.Chunks.size() - 1, row };
+}
+
+/*
+	Removes a row by moving the archetype's last row into it, the moved entity's location is updated
+*/
+void CEntityStore::RemoveRow(const SLocation& location)
+{
+	SArchetype& archetype = Archetypes[location.Archetype];
+	SChunk& chunk = archetype.Chunks[location.Chunk];
+	SChunk& last = archetype.Chunks.back();
+	int lastRow = last.Count - 1;
+
+	if (&chunk != &last || location.Row != lastRow)
+	{
+		for (int i = 0; i < (int)EComponent::Count; ++i)
+		{
+			IfThenStatement(!HasComponent(archetype.Mask, i), continue);
+
+			size_t size = ComponentSizes[i];
+			std::memcpy(chunk.Memory.get() + archetype.Offsets[i] + size * location.Row, last.Memory.get() + archetype.Offsets[i] + size * lastRow, size);
+		}
+
+		EntityHandle moved = GetHandles(archetype, last)[lastRow];
+		GetHandles(archetype, chunk)[location.Row] = moved;
+		*Entities.Get(moved) = location;
+	}
+
+	last.Count--;
+	IfThenStatement(last.Count == 0, archetype.Chunks.pop_back());
+}
+
+/*
+	Moves an entity to the archetype with a different set of components, the components it keeps are copied over
+
+	@return If the entity exists
+*/
+bool CEntityStore::SetComponents(EntityHandle entity, ComponentMask components)
+{
+	SLocation* location = Entities.Get(entity);
+	IfThenReturn(location == nullptr, false);
+	IfThenReturn(Archetypes[location->Archetype].Mask == components, true);
+
+	SLocation from = *location;
+	int toIndex = FindArchetype(components); // Can add an archetype, so references into Archetypes are taken after
+	SLocation to = AddRow(toIndex, entity);
+
+	SArchetype& source = Archetypes[from.Archetype];
+	SArchetype& destination = Archetypes[toIndex];
+	SChunk& sourceChunk = source.Chunks[from.Chunk];
+	SChunk& destinationChunk = destination.Chunks[to.Chunk];
+
+	for (int i = 0; i < (int)EComponent::Count; ++i)
+	{
+		IfThenStatement(!HasComponent(source.Mask, i) || !HasComponent(destination.Mask, i), continue);
+
+		size_t size = ComponentSizes[i];
+		std::memcpy(destinationChunk.Memory.get() + destination.Offsets[i] + size * to.Row, sourceChunk.Memory.get() + source.Offsets[i] + size * from.Row, size);
+	}
+
+	*location = to;
+	RemoveRow(from);
+	return true;
+}
+
+void* CEntityStore::GetComponent(EntityHandle entity, EComponent type)
+{
+	SLocation* location = Entities.Get(entity);
+	IfThenReturn(location == nullptr, nullptr);
+
+	SArchetype& archetype = Archetypes[location->Archetype];
+	IfThenReturn(!HasComponent(archetype.Mask, (int)type), nullptr);
+
+	SChunk& chunk = archetype.Chunks[location->Chunk];
+	return chunk.Memory.get() + archetype.Offsets[(int)type] + ComponentSizes[(int)type] * location->Row;
+}
+
+void CEntityStore::GatherChunks(ComponentMask mask)
+{
+	ParallelChunks.clear();
+
+	for (SArchetype& archetype : Archetypes)
+	{
+		IfThenStatement((archetype.Mask & mask) != mask, continue);
+		for (SChunk& chunk : archetype.Chunks) { ParallelChunks.push_back({ &archetype, &chunk }); }
+	}
+}
+
+void CEntityStore::RunParallel(const std::function<void(SArchetype&, SChunk&)>& function)
+{
+	JOBS::ParallelFor((int)ParallelChunks.size(), 1, [this, &function](int start, int end)
+	{
+		for (int i = start; i < end; ++i) { function(*ParallelChunks[i].first, *ParallelChunks[i].second); }
+	});
+}
+
+/*
+	Moves every entity by its velocity, the same integration the cats do
+*/
+void ENTITIES::IntegrateVelocity(CEntityStore& store, float deltaSeconds)
+{
+	store.ForEach<STransform, SVelocity>([deltaSeconds](int count, STransform* transforms, SVelocity* velocities)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			velocities[i].Velocity += velocities[i].Acceleration * deltaSeconds;
+			transforms[i].Location += glm::vec3(velocities[i].Velocity * deltaSeconds, 0.0f);
+		}
+	});
+}
+
+/*
+	Moves every animation on by its frames per second, toggle animations stop on their last frame
+*/
+void ENTITIES::AdvanceAnimations(CEntityStore& store, float deltaSeconds)
+{
+	store.ForEach<SSpriteAnim>([deltaSeconds](int count, SSpriteAnim* anims)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			SSpriteAnim& anim = anims[i];
+			IfThenStatement(anim.Animation == NO_ANIMATION || anim.Library == nullptr, continue);
+
+			const SSpriteAnimation& animation = anim.Library->GetAnimation(anim.Animation);
+			anim.Frame += animation.FPS * anim.Speed * deltaSeconds;
+
+			if (animation.AnimationType == EAnimationType::Toggle && anim.Frame >= animation.Frames.size())
+			{
+				anim.Frame = (float)animation.Frames.size() - 1.0f;
+				anim.Speed = 0.0f;
+				anim.Ended = true;
+			}
+		}
+	});
+}
+
+void ENTITIES::UpdateBounds(CEntityStore& store)
+{
+	store.ForEach<STransform, SBounds>([](int count, STransform* transforms, SBounds* bounds)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			glm::vec2 size = bounds[i].Size * glm::abs(glm::vec2(transforms[i].Scale));
+			bounds[i].TopLeft = glm::vec2(transforms[i].Location) - size * bounds[i].Pivot;
+			bounds[i].BotRight = bounds[i].TopLeft + size;
+		}
+	});
+}
+
+int ENTITIES::CalculateFrame(const SSpriteAnim& anim)
+{
+	IfThenReturn(anim.Animation == NO_ANIMATION || anim.Library == nullptr, -1);
+
+	const SSpriteAnimation& animation = anim.Library->GetAnimation(anim.Animation);
+	int frameSize = (int)animation.Frames.size();
+
+	switch (animation.AnimationType)
+	{
+		case (EAnimationType::Toggle):
+		case (EAnimationType::Loop):
+		{
+			return (int)std::floor(std::fmod(anim.Frame, (float)frameSize));
+		}
+		case (EAnimationType::PingPong):
+		{
+			float value = std::fmod(anim.Frame, (frameSize - 1) * 2.0f);
+			return (int)std::round(value - std::fmax(value - (frameSize - 1), 0.0f) * 2);
+		}
+	}
+
+	return -1;
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+#include <type_traits>
+#include <glm.hpp>
+
+#include "slotMap.h"
+#include "animationLibrary.h"
+
+typedef SSlotHandle EntityHandle;
+typedef unsigned int ComponentMask;
+
+enum class EComponent
+{
+	Transform,
+	Velocity,
+	SpriteAnim,
+	Palette,
+	Bounds,
+
+	Count,
+};
+
+// Components are plain data so rows can be copied between chunks byte for byte
+struct STransform
+{
+	glm::vec3 Location = glm::vec3();
+	glm::vec3 Scale = glm::vec3(1.0f);
+	float RotationZ = 0.0f;
+};
+
+struct SVelocity
+{
+	glm::vec2 Velocity = glm::vec2();
+	glm::vec2 Acceleration = glm::vec2();
+};
+
+struct SSpriteAnim
+{
+	CAnimationLibrary* Library = nullptr;
+	AnimationHandle Animation = NO_ANIMATION;
+	float Frame = 0.0f;
+	float Speed = 1.0f;
+	bool Ended = false; // Set when a toggle animation reaches its last frame, the object model calls OnAnimationEnd here
+};
+
+struct SPalette
+{
+	const glm::vec3* Colours = nullptr; // Lookup colours for the palette shader, owned elsewhere
+	int Count = 0;
+};
+
+struct SBounds
+{
+	glm::vec2 Size = glm::vec2(); // Before scaling
+	glm::vec2 Pivot = glm::vec2(0.5f, 1.0f); // Fraction of the size the location sits at
+	glm::vec2 TopLeft = glm::vec2();
+	glm::vec2 BotRight = glm::vec2();
+};
+
+// Maps each component struct to its place in a component mask
+template<typename T> struct SComponentType;
+template<> struct SComponentType<STransform> { static const EComponent Type = EComponent::Transform; };
+template<> struct SComponentType<SVelocity> { static const EComponent Type = EComponent::Velocity; };
+template<> struct SComponentType<SSpriteAnim> { static const EComponent Type = EComponent::SpriteAnim; };
+template<> struct SComponentType<SPalette> { static const EComponent Type = EComponent::Palette; };
+template<> struct SComponentType<SBounds> { static const EComponent Type = EComponent::Bounds; };
+
+template<typename... T> ComponentMask GetComponentMask() { return (0u | ... | (1u << (int)SComponentType<T>::Type)); }
+
+/*
+	Stores entities by archetype, the set of components they have. Each archetype keeps its entities in
+	fixed size chunks with every component in its own packed array, so a system reads only the components
+	it asks for, front to back. An archetype's chunks are kept full apart from the last one: removing an
+	entity moves the archetype's last entity into the gap, and adding or removing a component moves the
+	entity to the matching archetype.
+
+	Entities, components and archetypes must not be added or removed from inside ForEach
+*/
+class CEntityStore
+{
+public:
+	EntityHandle Create(ComponentMask components);
+	bool Destroy(EntityHandle entity);
+	bool IsAlive(EntityHandle entity);
+
+	template<typename T> T* Get(EntityHandle entity) // nullptr if the entity is gone or doesn't have the component
+	{
+		void* component = GetComponent(entity, SComponentType<T>::Type);
+		return static_cast<T*>(component);
+	}
+
+	template<typename T> T* Add(EntityHandle entity) // Returns the existing component if the entity already has it
+	{
+		if (!SetComponents(entity, GetComponents(entity) | GetComponentMask<T>())) { return nullptr; }
+		return Get<T>(entity);
+	}
+
+	template<typename T> bool Remove(EntityHandle entity)
+	{
+		return SetComponents(entity, GetComponents(entity) & ~GetComponentMask<T>());
+	}
+
+	ComponentMask GetComponents(EntityHandle entity);
+
+	/*
+		Calls the function once per chunk holding every component asked for, with the number of entities
+		in the chunk and a pointer to the start of each component's array
+	*/
+	template<typename... T, typename F> void ForEach(F function)
+	{
+		ComponentMask mask = GetComponentMask<T...>();
+
+		for (SArchetype& archetype : Archetypes)
+		{
+			if ((archetype.Mask & mask) != mask) { continue; }
+
+			for (SChunk& chunk : archetype.Chunks)
+			{
+				function(chunk.Count, GetArray<T>(archetype, chunk)...);
+			}
+		}
+	}
+
+	template<typename... T, typename F> void ParallelForEach(F function) // ForEach with the chunks shared across the job system
+	{
+		GatherChunks(GetComponentMask<T...>());
+		RunParallel([this, &function](SArchetype& archetype, SChunk& chunk) { function(chunk.Count, GetArray<T>(archetype, chunk)...); });
+	}
+
+	int GetEntityCount();
+	int GetArchetypeCount();
+	int GetChunkCount();
+
+private:
+	struct SChunk
+	{
+		std::unique_ptr<unsigned char[]> Memory;
+		int Count = 0;
+	};
+
+	struct SArchetype
+	{
+		ComponentMask Mask;
+		int Capacity; // Entities per chunk
+		size_t Offsets[(int)EComponent::Count + 1]; // Where each array starts in a chunk, the last is the entity handles
+		std::vector<SChunk> Chunks;
+	};
+
+	struct SLocation
+	{
+		int Archetype;
+		int Chunk;
+		int Row;
+	};
+
+	CSlotMap<SLocation> Entities;
+	std::vector<SArchetype> Archetypes;
+	std::vector<std::pair<SArchetype*, SChunk*>> ParallelChunks; // Reused each ParallelForEach
+
+	static const size_t ComponentSizes[(int)EComponent::Count];
+	static const void* ComponentDefaults[(int)EComponent::Count]; // New components start as a copy of these
+
+	template<typename T> T* GetArray(SArchetype& archetype, SChunk& chunk)
+	{
+		return reinterpret_cast<T*>(chunk.Memory.get() + archetype.Offsets[(int)SComponentType<T>::Type]);
+	}
+
+	int FindArchetype(ComponentMask mask);
+	SLocation AddRow(int archetype, EntityHandle entity);
+	void RemoveRow(const SLocation& location);
+	bool SetComponents(EntityHandle entity, ComponentMask components);
+	void* GetComponent(EntityHandle entity, EComponent type);
+	EntityHandle* GetHandles(SArchetype& archetype, SChunk& chunk);
+
+	void GatherChunks(ComponentMask mask);
+	void RunParallel(const std::function<void(SArchetype&, SChunk&)>& function);
+};
+
+// Systems that do what CObject and CSprite do per object, over every matching chunk at once
+namespace ENTITIES
+{
+	void IntegrateVelocity(CEntityStore& store, float deltaSeconds); // Velocity and Transform
+	void AdvanceAnimations(CEntityStore& store, float deltaSeconds); // SpriteAnim
+	void UpdateBounds(CEntityStore& store); // Transform and Bounds
+
+	int CalculateFrame(const SSpriteAnim& anim); // The frame index to draw, -1 if there is no animation
+}
@@ -5,6 +5,7 @@
 #include "camera.h"
 #include "mesh.h"
 #include "program.h"
+#include "renderStats.h"
 
 
 CFBOObject::CFBOObject(FBOType type)
@@ -50,6 +51,7 @@ CFBOObject::CFBOObject(FBOType type)
 	// Setup the texture
 	glGenTextures(1, &Texture);
 	glBindTexture(GL_TEXTURE_2D, Texture);
+	STATS::Count(STATS::ECounter::TextureBinds);
 	glTexImage2D(GL_TEXTURE_2D, 0, textureFormat, TextureWidth, TextureHeight, 0, textureFormat, textureType, NULL);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
@@ -143,6 +145,7 @@ void CFBOObject::Render()
 	// Assign texture uniform
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, Texture);
+	STATS::Count(STATS::ECounter::TextureBinds);
 	glUniform1i(FBOProg->GetUniform("tex"), 0);
 
 	// Draw the mesh
@@ -5,6 +5,7 @@
 
 #include "font.h"
 #include "helper.h"
+#include "renderStats.h"
 
 std::map<std::string, CFont*> CFont::Fonts;
 
@@ -54,7 +55,7 @@ CFont::~CFont()
 {
 }
 
-glm::ivec2 CFont::TextBounds(std::string text, float scale)
+glm::ivec2 CFont::TextBounds(const std::string& text, float scale)
 {
 	glm::ivec2 boundry;
 	int lines = 1;
@@ -116,6 +117,7 @@ GLuint CFont::GenerateTexture(FT_Face face)
 	GLuint texture;
 	glGenTextures(1, &texture);
 	glBindTexture(GL_TEXTURE_2D, texture);
+	STATS::Count(STATS::ECounter::TextureBinds);
 
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
 
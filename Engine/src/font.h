@@ -21,7 +21,7 @@ public:
 	CFont(std::string filename, int size);
 	~CFont();
 
-	glm::ivec2 TextBounds(std::string text, float scale);
+	glm::ivec2 TextBounds(const std::string& text, float scale);
 
 	static void CleanUp();
 	static void GenerateFonts();
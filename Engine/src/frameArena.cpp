@@ -0,0 +1,143 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <new>
+#include <algorithm>
+
+#include "frameArena.h"
+#include "helper.h"
+
+#define FRAME_ARENA_POISON 0xDD // Written over released memory in debug builds so stale reads stand out
+
+static char* Base = nullptr;
+static std::size_t Capacity = 0;
+static std::atomic<std::size_t> Offset = 0;
+static std::atomic<int> Overflows = 0;
+
+static std::size_t LastUsed = 0;
+static std::size_t Peak = 0;
+static int LastOverflows = 0;
+
+static bool IsInArena(void* memory)
+{
+	return memory >= Base && memory < Base + Capacity;
+}
+
+/*
+	Creates the arena, anything allocated before this or after the arena runs out of space
+	falls back to the heap
+
+	@param capacity Number of bytes available each frame
+*/
+void ARENA::Initialise(std::size_t capacity)
+{
+	CleanUp();
+
+	Base = static_cast<char*>(std::malloc(capacity));
+	Capacity = (Base != nullptr) ? capacity : 0;
+	Offset = 0;
+	LastUsed = 0;
+	Peak = 0;
+
+#ifdef _DEBUG
+	IfThenStatement(Base != nullptr, std::memset(Base, FRAME_ARENA_POISON, Capacity));
+#endif
+}
+
+void ARENA::CleanUp()
+{
+	std::free(Base);
+	Base = nullptr;
+	Capacity = 0;
+	Offset = 0;
+}
+
+/*
+	Moves the arena back to the start, nothing allocated during the frame can be used after this
+*/
+void ARENA::Reset()
+{
+	std::size_t used = Offset.exchange(0, std::memory_order_acq_rel);
+	LastUsed = used;
+	Peak = std::max(Peak, used);
+	LastOverflows = Overflows.exchange(0, std::memory_order_relaxed);
+
+#ifdef _DEBUG
+	std::memset(Base, FRAME_ARENA_POISON, used);
+#endif
+}
+
+/*
+	Bumps the arena forward, if there isn't enough space left the memory comes from the heap instead
+
+	@param size Number of bytes
+	@param alignment Must be a power of two
+	@return The allocated memory
+*/
+void* ARENA::Allocate(std::size_t size, std::size_t alignment)
+{
+	std::size_t current = Offset.load(std::memory_order_relaxed);
+
+	while (Base != nullptr)
+	{
+		std::uintptr_t address = ((std::uintptr_t)(Base + current) + alignment - 1) & ~(std::uintptr_t)(alignment - 1);
+		std::size_t end = (address - (std::uintptr_t)Base) + size;
+		IfThenStatement(end > Capacity, break);
+
+		if (Offset.compare_exchange_weak(current, end, std::memory_order_acq_rel))
+		{
+			return (void*)address;
+		}
+	}
+
+	Overflows.fetch_add(1, std::memory_order_relaxed);
+	return ::operator new(size);
+}
+
+/*
+	Arena memory is only released by Reset, apart from the most recent allocation which is
+	given back straight away so a growing container can reuse the space
+
+	@param memory Memory returned by Allocate
+	@param size Size that was requested
+*/
+void ARENA::Free(void* memory, std::size_t size)
+{
+	IfThenReturn(memory == nullptr, );
+
+	if (!IsInArena(memory))
+	{
+		::operator delete(memory);
+		return;
+	}
+
+	std::size_t start = (char*)memory - Base;
+	std::size_t end = start + size;
+
+#ifdef _DEBUG
+	std::memset(memory, FRAME_ARENA_POISON, size);
+#endif
+
+	Offset.compare_exchange_strong(end, start, std::memory_order_acq_rel);
+}
+
+std::size_t ARENA::GetUsed()
+{
+	return LastUsed;
+}
+
+std::size_t ARENA::GetPeak()
+{
+	return Peak;
+}
+
+std::size_t ARENA::GetCapacity()
+{
+	return Capacity;
+}
+
+int ARENA::GetOverflowCount()
+{
+	return LastOverflows;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#define FRAME_ARENA_DEFAULT_SIZE (1024 * 1024)
+
+namespace ARENA
+{
+	void Initialise(std::size_t capacity = FRAME_ARENA_DEFAULT_SIZE);
+	void CleanUp();
+
+	void Reset(); // Releases everything allocated this frame, call once all of the frames work has finished
+
+	void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)); // Safe to call from any thread
+	void Free(void* memory, std::size_t size);
+
+	std::size_t GetUsed(); // Bytes used by the last finished frame
+	std::size_t GetPeak(); // Most used in a single frame
+	std::size_t GetCapacity();
+	int GetOverflowCount(); // Allocations that didn't fit and went to the heap last frame
+}
+
+/*
+	STL allocator that takes its memory from the frame arena, containers using it must not
+	be kept past the end of the frame they were created in
+*/
+template<typename T>
+class CFrameAllocator
+{
+public:
+	typedef T value_type;
+
+	CFrameAllocator() = default;
+	template<typename U> CFrameAllocator(const CFrameAllocator<U>&) {}
+
+	T* allocate(std::size_t count) { return static_cast<T*>(ARENA::Allocate(count * sizeof(T), alignof(T))); }
+	void deallocate(T* memory, std::size_t count) { ARENA::Free(memory, count * sizeof(T)); }
+
+	template<typename U> bool operator==(const CFrameAllocator<U>&) const { return true; }
+	template<typename U> bool operator!=(const CFrameAllocator<U>&) const { return false; }
+};
+
+template<typename T> using FrameVector = std::vector<T, CFrameAllocator<T>>;
+typedef std::basic_string<char, std::char_traits<char>, CFrameAllocator<char>> FrameString;
@@ -8,6 +8,7 @@
 #include "helper.h"
 #include "texture.h"
 #include "camera.h"
+#include "renderStats.h"
 
 #define NUM_PARTICLES 128
 
@@ -87,6 +88,7 @@ void GPU2DParticleLayer::Render()
 
 	// Render
 	glDrawArrays(GL_POINTS, 0, NUM_PARTICLES);
+	STATS::Count(STATS::ECounter::DrawCalls);
 
 
 	// Reset back to normal blending
@@ -7,6 +7,9 @@
 #include "program.h"
 #include "font.h"
 #include "helper.h"
+#include "renderStats.h"
+#include "affine2D.h"
+#include "profiler.h"
 
 static CMesh* RectangleMesh;
 
@@ -60,6 +63,7 @@ void GFX::DrawImage(GLuint aTexture, glm::mat4& pvm)
 	// Bind the texture
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, aTexture);
+	STATS::Count(STATS::ECounter::TextureBinds);
 	glUniform1i(TextureProgram->GetUniform("tex"), 0);
 
 	// Set the PVM matrix
@@ -84,6 +88,7 @@ void GFX::DrawSubImage(GLuint aTexture, glm::mat4& pvm, glm::ivec4& locSize)
 	// Bind the texture
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, aTexture);
+	STATS::Count(STATS::ECounter::TextureBinds);
 	glUniform1i(SubTextureProgram->GetUniform("tex"), 0);
 
 	// Set the PVM matrix
@@ -111,6 +116,7 @@ void GFX::DrawSubImage(GLuint aTexture, glm::mat4& pvm, glm::ivec2& location, gl
 	// Bind the texture
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, aTexture);
+	STATS::Count(STATS::ECounter::TextureBinds);
 	glUniform1i(SubTextureProgram->GetUniform("tex"), 0);
 
 	// Set the PVM matrix
@@ -138,6 +144,7 @@ void GFX::DrawSubImage(GLuint aTexture, glm::mat4& pvm, int x, int y, int width,
 	// Bind the texture
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, aTexture);
+	STATS::Count(STATS::ECounter::TextureBinds);
 	glUniform1i(SubTextureProgram->GetUniform("tex"), 0);
 
 	// Set the PVM matrix
@@ -369,7 +376,7 @@ void GFX::DrawLine(glm::mat4& pv, glm::vec4 colour, glm::vec2 p1, glm::vec2 p2,
 	glUseProgram(0);
 }
 
-void GFX::DrawPoints(glm::mat4& pv, glm::vec4 colour, std::vector<glm::vec2> points, float width)
+void GFX::DrawPoints(glm::mat4& pv, glm::vec4 colour, const std::vector<glm::vec2>& points, float width)
 {
 	IfThenReturn(points.size() == 0, );
 	for (int i = 0; i < (int)points.size(); ++i)
@@ -378,7 +385,7 @@ void GFX::DrawPoints(glm::mat4& pv, glm::vec4 colour, std::vector<glm::vec2> poi
 	}
 }
 
-void GFX::DrawPolygon(glm::mat4& pv, glm::vec4 colour, std::vector<glm::vec2> points, float width)
+void GFX::DrawPolygon(glm::mat4& pv, glm::vec4 colour, const std::vector<glm::vec2>& points, float width)
 {
 	IfThenReturn(points.size() == 0, );
 	glm::vec2 previous = points[0];
@@ -392,8 +399,10 @@ void GFX::DrawPolygon(glm::mat4& pv, glm::vec4 colour, std::vector<glm::vec2> po
 	GFX::DrawLine(pv, colour, previous, points[0], width);
 }
 
-void GFX::DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 location, glm::vec3 colour, float scale)
+void GFX::DrawString(glm::mat4 pv, CFont* font, const std::string& text, glm::ivec2 location, glm::vec3 colour, float scale)
 {
+	PROFILE_SCOPE("GFX::DrawString");
+
 	glUseProgram(TextProgram->GetProgramID());
 	glUniform4f(TextProgram->GetUniform("textColor"), colour.x, colour.y, colour.z, 1.0f);
 	glUniformMatrix4fv(TextProgram->GetUniform("proj"), 1, GL_FALSE, glm::value_ptr(pv));
@@ -406,7 +415,7 @@ void GFX::DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 loc
 
 	for (std::string::const_iterator character = text.begin(); character != text.end(); character++)
 	{
-		FontChar fontChar = font->Characters[*character];
+		FontChar& fontChar = font->Characters[*character];
 
 		if (*character == '\n')
 		{
@@ -419,7 +428,7 @@ void GFX::DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 loc
 		GLfloat charWidth = fontChar.Size.x * scale;
 		GLfloat charHeight = fontChar.Size.y * scale;
 
-		std::vector<GLfloat> vertices = {
+		GLfloat vertices[16] = {
 			xpos				, ypos				, 0.0, 0.0,
 			xpos				, ypos + charHeight	, 0.0, 1.0,
 			xpos + charWidth	, ypos + charHeight	, 1.0, 1.0,
@@ -427,13 +436,15 @@ void GFX::DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 loc
 		};
 
 		glBindBuffer(GL_ARRAY_BUFFER, TextVBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GLfloat) * vertices.size(), vertices.data());
+		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
 
 		// Render the glyph texture over the quad
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, fontChar.TextureID);
+		STATS::Count(STATS::ECounter::TextureBinds);
 		glUniform1i(texID, 0);
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		STATS::Count(STATS::ECounter::DrawCalls);
 
 		// Advance cursors for the next glyph
 		xOffset += (fontChar.Advance >> 6)* scale;
@@ -445,8 +456,10 @@ void GFX::DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 loc
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
-void GFX::DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 location, glm::vec4 colour, float scale)
+void GFX::DrawString(glm::mat4 pv, CFont* font, const std::string& text, glm::ivec2 location, glm::vec4 colour, float scale)
 {
+	PROFILE_SCOPE("GFX::DrawString");
+
 	glUseProgram(TextProgram->GetProgramID());
 	glUniform4f(TextProgram->GetUniform("textColor"), colour.x, colour.y, colour.z, colour.w);
 	glUniformMatrix4fv(TextProgram->GetUniform("proj"), 1, GL_FALSE, glm::value_ptr(pv));
@@ -459,7 +472,7 @@ void GFX::DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 loc
 
 	for (std::string::const_iterator character = text.begin(); character != text.end(); character++)
 	{
-		FontChar fontChar = font->Characters[*character];
+		FontChar& fontChar = font->Characters[*character];
 
 		if (*character == '\n')
 		{
@@ -472,7 +485,7 @@ void GFX::DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 loc
 		GLfloat charWidth = fontChar.Size.x * scale;
 		GLfloat charHeight = fontChar.Size.y * scale;
 
-		std::vector<GLfloat> vertices = {
+		GLfloat vertices[16] = {
 			xpos				, ypos				, 0.0, 0.0,
 			xpos				, ypos + charHeight	, 0.0, 1.0,
 			xpos + charWidth	, ypos + charHeight	, 1.0, 1.0,
@@ -480,13 +493,15 @@ void GFX::DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 loc
 		};
 
 		glBindBuffer(GL_ARRAY_BUFFER, TextVBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GLfloat) * vertices.size(), vertices.data());
+		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
 
 		// Render the glyph texture over the quad
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, fontChar.TextureID);
+		STATS::Count(STATS::ECounter::TextureBinds);
 		glUniform1i(texID, 0);
 		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		STATS::Count(STATS::ECounter::DrawCalls);
 
 		// Advance cursors for the next glyph
 		xOffset += (fontChar.Advance >> 6) * scale;
@@ -499,30 +514,22 @@ void GFX::DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 loc
 }
 
 
+/*
+	The 2D versions build a 2D affine transform directly rather than multiplying full matrices
+*/
 glm::mat4 GFX::CalculateModelMatrix(glm::vec2 translation, glm::vec2 scale)
 {
-	glm::mat4 scaleMat = glm::scale(glm::mat4(), glm::vec3(scale, 1.0f));
-	glm::mat4 translationMat = glm::translate(glm::mat4(), glm::vec3(translation, 0.0f));
-
-	return translationMat * scaleMat;
+	return SAffine2D(glm::vec2(scale.x, 0.0f), glm::vec2(0.0f, scale.y), translation).ToMat4();
 }
 
 glm::mat4 GFX::CalculateModelMatrix(glm::vec2 translation, glm::vec2 scale, glm::vec2 pivot)
 {
-	glm::mat4 pivotMat = glm::translate(glm::mat4(), glm::vec3(pivot, 0.0f));
-	glm::mat4 scaleMat = glm::scale(glm::mat4(), glm::vec3(scale, 1.0f));
-	glm::mat4 translationMat = glm::translate(glm::mat4(), glm::vec3(translation, 0.0f));
-
-	return translationMat * scaleMat * pivotMat;
+	return SAffine2D::Compose(translation, scale, 0.0f, -pivot).ToMat4();
 }
 
 glm::mat4 GFX::CalculateModelMatrix(glm::vec2 translation, glm::vec2 scale, float rotationZ)
 {
-	glm::mat4 scaleMat = glm::scale(glm::mat4(), glm::vec3(scale, 1.0f));
-	glm::mat4 rotationMat = glm::rotate(glm::mat4(), glm::radians(rotationZ), glm::vec3(0.0f, 0.0f, 1.0f));
-	glm::mat4 translationMat = glm::translate(glm::mat4(), glm::vec3(translation, 0.0f));
-
-	return translationMat * rotationMat * scaleMat;
+	return SAffine2D::Compose(translation, scale, rotationZ).ToMat4();
 }
 
 glm::mat4 GFX::CalculateModelMatrix(glm::vec3 translation, glm::vec3 scale)
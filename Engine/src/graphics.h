@@ -27,11 +27,11 @@ namespace GFX
 	void DrawLine(glm::mat4& pv, glm::vec4 colour, glm::vec2 p1, glm::vec2 p2);
 	void DrawLine(glm::mat4& pv, glm::vec4 colour, glm::vec2 p1, glm::vec2 p2, float width);
 
-	void DrawPoints(glm::mat4& pv, glm::vec4 colour, std::vector<glm::vec2> points, float width);
-	void DrawPolygon(glm::mat4& pv, glm::vec4 colour, std::vector<glm::vec2> points, float width);
+	void DrawPoints(glm::mat4& pv, glm::vec4 colour, const std::vector<glm::vec2>& points, float width);
+	void DrawPolygon(glm::mat4& pv, glm::vec4 colour, const std::vector<glm::vec2>& points, float width);
 
-	void DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 location, glm::vec3 colour = glm::vec3(), float scale = 1.0f);
-	void DrawString(glm::mat4 pv, CFont* font, std::string text, glm::ivec2 location, glm::vec4 colour, float scale = 1.0f);
+	void DrawString(glm::mat4 pv, CFont* font, const std::string& text, glm::ivec2 location, glm::vec3 colour = glm::vec3(), float scale = 1.0f);
+	void DrawString(glm::mat4 pv, CFont* font, const std::string& text, glm::ivec2 location, glm::vec4 colour, float scale = 1.0f);
 
 	glm::mat4 CalculateModelMatrix(glm::vec2 translation, glm::vec2 scale);
 	glm::mat4 CalculateModelMatrix(glm::vec2 translation, glm::vec2 scale, glm::vec2 pivot);
@@ -8,6 +8,10 @@
 
 #include "helper.h"
 #include "timer.h"
+#include "random.h"
+
+static CRandom SharedRandom; // Used by HELPER::Random, main thread only
+static unsigned long long SharedRandomSeed = 0;
 
 /*
 	Splits a string by a character and puts it into the given container
@@ -372,6 +376,22 @@ void HELPER::PrintToOutput(std::string s)
 }
 
 
+/*
+	Seeds the generator behind HELPER::Random, the same seed gives the same numbers every run
+
+	@param seed The new seed
+*/
+void HELPER::SeedRandom(unsigned long long seed)
+{
+	SharedRandomSeed = seed;
+	SharedRandom.Seed(seed);
+}
+
+unsigned long long HELPER::GetRandomSeed()
+{
+	return SharedRandomSeed;
+}
+
 /*
 	Generates a random number inbetween 0 and a number exclusive
 
@@ -380,7 +400,7 @@ void HELPER::PrintToOutput(std::string s)
 */
 int HELPER::Random(int maxNum)
 {
-	return rand() % maxNum;
+	return SharedRandom.Range(maxNum);
 }
 
 /*
@@ -392,17 +412,17 @@ int HELPER::Random(int maxNum)
 */
 int HELPER::Random(int minNum, int maxNum)
 {
-	return (rand() % (maxNum - minNum)) + minNum;
+	return SharedRandom.Range(minNum, maxNum);
 }
 
 float HELPER::Random(float minNum, float maxNum)
 {
-	return HELPER::Random() * (maxNum - minNum) + minNum;
+	return SharedRandom.Range(minNum, maxNum);
 }
 
 float HELPER::Random()
 {
-	return (float)rand() / (float)RAND_MAX;
+	return SharedRandom.Float();
 }
 
 /*
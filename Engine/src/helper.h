@@ -93,6 +93,8 @@ namespace HELPER
 	float RoundToPlaces(float aVal, int numOfPlaces);
 	glm::vec2 RoundToPlaces(glm::vec2 aVal, int numOfPlaces);
 	glm::vec3 RoundToPlaces(glm::vec3 aVal, int numOfPlaces);
+	void SeedRandom(unsigned long long seed); // Seeds the shared generator used by Random
+	unsigned long long GetRandomSeed();
 	int Random(int maxNum);
 	int Random(int minNum, int maxNum);
 	float Random(float minNum, float maxNum);
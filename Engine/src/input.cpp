@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "input.h"
+#include "replay.h"
 #include "helper.h"
 
 static InputState KeyStates[256] = { };
@@ -26,6 +27,7 @@ void GINPUT::UpdateGlobal()
 	// Update Mouse Location
 	POINT p;
 	GetCursorPos(&p);
+	REPLAY::Sync(REPLAY::EChannel::Mouse, &p, sizeof(p));
 	
 	MouseLocationOld = MouseLocation;
 	MouseLocation = glm::vec2(p.x, p.y);
@@ -33,18 +35,30 @@ void GINPUT::UpdateGlobal()
 	// Update Key States
 	BYTE keyStatesNew[256] = { };
 	GetKeyState(0);
-	if (GetKeyboardState(keyStatesNew))
+	if (GetKeyboardState(keyStatesNew) || REPLAY::IsPlaying())
 	{
+		// Only whether each key is down is replayed, toggle states are left out
+		uint8_t keysDown[32] = { };
+
 		for (int i = 0; i < 256; ++i)
 		{
+			IfThenStatement(keyStatesNew[i] >= 128, keysDown[i / 8] |= 1 << (i % 8));
+		}
+
+		REPLAY::Sync(REPLAY::EChannel::Keyboard, keysDown, sizeof(keysDown));
+
+		for (int i = 0; i < 256; ++i)
+		{
+			bool down = (keysDown[i / 8] & (1 << (i % 8))) != 0;
+
 			// Key Down
-			if (KeyStates[i] == InputState::INPUT_UP && keyStatesNew[i] >= 128)
+			if (KeyStates[i] == InputState::INPUT_UP && down)
 			{
 				KeyStates[i] = InputState::INPUT_DOWN_FIRST;
 				KeyStatesToBeUpdated.push_back(i);
 			}
 			// Key Up
-			else if (KeyStates[i] == InputState::INPUT_DOWN && keyStatesNew[i] <= 1)
+			else if (KeyStates[i] == InputState::INPUT_DOWN && !down)
 			{
 				KeyStates[i] = InputState::INPUT_UP_FIRST;
 				KeyStatesToBeUpdated.push_back(i);
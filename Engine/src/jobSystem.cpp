@@ -0,0 +1,410 @@
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+#include "jobSystem.h"
+#include "helper.h"
+
+#define JOB_QUEUE_SIZE 4096 // Must be a power of two
+#define JOB_QUEUE_MASK (JOB_QUEUE_SIZE - 1)
+#define JOB_SPIN_COUNT 64 // Failed attempts to find a job before a worker goes to sleep
+#define MAX_WORKER_COUNT 63
+
+struct SJob
+{
+	JOBS::JobFunction Function;
+	JOBS::SCounter* Counter = nullptr;
+	const JOBS::SCounter* Dependency = nullptr;
+	std::atomic<bool> Active = false;
+};
+
+/*
+	Chase-Lev work stealing deque, the owning thread pushes and pops from the bottom
+	while any other thread can steal from the top
+*/
+class CJobDeque
+{
+public:
+	CJobDeque()
+	{
+		for (std::atomic<SJob*>& slot : Buffer) { slot.store(nullptr, std::memory_order_relaxed); }
+	}
+
+	bool Push(SJob* job)
+	{
+		long long bottom = Bottom.load(std::memory_order_relaxed);
+		long long top = Top.load(std::memory_order_acquire);
+
+		if (bottom - top >= JOB_QUEUE_SIZE) { return false; }
+
+		Buffer[bottom & JOB_QUEUE_MASK].store(job, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	SJob* Pop()
+	{
+		long long bottom = Bottom.load(std::memory_order_relaxed) - 1;
+		Bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		long long top = Top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			// Queue was empty
+			Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		SJob* job = Buffer[bottom & JOB_QUEUE_MASK].load(std::memory_order_relaxed);
+
+		if (top == bottom)
+		{
+			// Last job in the queue, race any thieves for it
+			if (!Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				job = nullptr;
+			}
+
+			Bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+
+		return job;
+	}
+
+	SJob* Steal()
+	{
+		long long top = Top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		long long bottom = Bottom.load(std::memory_order_acquire);
+
+		if (top >= bottom) { return nullptr; }
+
+		SJob* job = Buffer[top & JOB_QUEUE_MASK].load(std::memory_order_relaxed);
+
+		// Another thread took the job first
+		if (!Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			return nullptr;
+		}
+
+		return job;
+	}
+
+private:
+	alignas(64) std::atomic<long long> Top = 0;
+	alignas(64) std::atomic<long long> Bottom = 0;
+	alignas(64) std::atomic<SJob*> Buffer[JOB_QUEUE_SIZE];
+};
+
+struct SWorker
+{
+	CJobDeque Queue;
+
+	SJob Jobs[JOB_QUEUE_SIZE]; // Job storage owned by this thread, reused in a ring
+	unsigned int NextJob = 0;
+
+	std::vector<SJob*> Deferred; // Jobs taken off a queue before their dependency had finished
+	std::thread Thread;
+};
+
+static std::vector<SWorker*> Workers; // Index 0 is the main thread
+static thread_local int WorkerIndex = -1;
+
+static std::atomic<bool> Running = false;
+static std::atomic<int> QueuedJobs = 0;
+static std::atomic<int> SleepingWorkers = 0;
+
+static std::mutex SleepLock;
+static std::condition_variable WakeCondition;
+
+/*
+	Runs a job and signals its counter
+
+	@param job The job to run
+*/
+static void Execute(SJob* job)
+{
+	job->Function();
+	job->Function = nullptr;
+
+	JOBS::SCounter* counter = job->Counter;
+	job->Active.store(false, std::memory_order_release);
+
+	// The counter may be released by a waiting thread as soon as this hits zero, so it is the last thing touched
+	counter->Pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+/*
+	Finds the next job that is ready to run for a worker, looking in its own queue first
+	before stealing from the other workers
+
+	@param index The index of the worker looking for a job
+	@return A job that is ready to run, or nullptr if there is none
+*/
+static SJob* GetJob(int index)
+{
+	SWorker* worker = Workers[index];
+	int workerCount = (int)Workers.size();
+
+	SJob* job = worker->Queue.Pop();
+
+	for (int i = 1; job == nullptr && i < workerCount; ++i)
+	{
+		job = Workers[(index + i) % workerCount]->Queue.Steal();
+	}
+
+	if (job != nullptr)
+	{
+		QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+		// Hold onto the job until what it depends on has finished
+		if (job->Dependency != nullptr && !job->Dependency->IsDone())
+		{
+			worker->Deferred.push_back(job);
+			job = nullptr;
+		}
+	}
+
+	// Check if any of the deferred jobs are now ready
+	for (int i = 0; job == nullptr && i < (int)worker->Deferred.size(); ++i)
+	{
+		if (worker->Deferred[i]->Dependency->IsDone())
+		{
+			job = worker->Deferred[i];
+			worker->Deferred[i] = worker->Deferred.back();
+			worker->Deferred.pop_back();
+		}
+	}
+
+	return job;
+}
+
+/*
+	Main loop for each worker thread, sleeps when there is no work available
+
+	@param index The index of the worker
+*/
+static void WorkerLoop(int index)
+{
+	WorkerIndex = index;
+	SWorker* worker = Workers[index];
+	int idleCount = 0;
+
+	while (Running.load(std::memory_order_relaxed))
+	{
+		SJob* job = GetJob(index);
+
+		if (job != nullptr)
+		{
+			Execute(job);
+			idleCount = 0;
+		}
+		else if (!worker->Deferred.empty() || ++idleCount < JOB_SPIN_COUNT)
+		{
+			std::this_thread::yield();
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock(SleepLock);
+			SleepingWorkers.fetch_add(1);
+			WakeCondition.wait(lock, []() { return QueuedJobs.load() > 0 || !Running.load(); });
+			SleepingWorkers.fetch_sub(1);
+			idleCount = 0;
+		}
+	}
+}
+
+/*
+	Starts the worker threads, the calling thread is treated as the main thread and will
+	help run jobs while it waits on them
+
+	@param workerCount Number of threads to create, -1 will use one less than the number of hardware threads
+*/
+void JOBS::Initialise(int workerCount)
+{
+	if (workerCount < 0)
+	{
+		workerCount = std::max((int)std::thread::hardware_concurrency() - 1, 0);
+	}
+
+	workerCount = std::min(workerCount, MAX_WORKER_COUNT);
+
+	Running = true;
+
+	for (int i = 0; i <= workerCount; ++i)
+	{
+		SWorker* worker = new SWorker();
+		worker->Deferred.reserve(JOB_QUEUE_SIZE);
+		Workers.push_back(worker);
+	}
+
+	WorkerIndex = 0;
+
+	for (int i = 1; i <= workerCount; ++i)
+	{
+		Workers[i]->Thread = std::thread(WorkerLoop, i);
+	}
+}
+
+/*
+	Stops and joins all of the worker threads
+*/
+void JOBS::CleanUp()
+{
+	{
+		std::lock_guard<std::mutex> lock(SleepLock);
+		Running = false;
+	}
+
+	WakeCondition.notify_all();
+
+	for (SWorker* worker : Workers)
+	{
+		if (worker->Thread.joinable()) { worker->Thread.join(); }
+		delete worker;
+	}
+
+	Workers.clear();
+	WorkerIndex = -1;
+}
+
+int JOBS::GetWorkerCount()
+{
+	return std::max((int)Workers.size() - 1, 0);
+}
+
+int JOBS::GetThreadCount()
+{
+	return std::max((int)Workers.size(), 1);
+}
+
+bool JOBS::IsMainThread()
+{
+	return WorkerIndex == 0;
+}
+
+/*
+	Adds a job to the calling thread's queue, if called from a thread that isn't part of the job system
+	the job will be run straight away
+
+	@param job The function to run
+	@param counter Counter incremented now and decremented once the job has finished
+	@param dependency Optional counter that must reach zero before the job will start
+*/
+void JOBS::Schedule(JobFunction job, SCounter* counter, const SCounter* dependency)
+{
+	int index = WorkerIndex;
+
+	if (index < 0)
+	{
+		while (dependency != nullptr && !dependency->IsDone()) { std::this_thread::yield(); }
+		job();
+		return;
+	}
+
+	SWorker* worker = Workers[index];
+	SJob* newJob = &worker->Jobs[worker->NextJob & JOB_QUEUE_MASK];
+
+	// Help out until the storage slot has been freed up
+	while (newJob->Active.load(std::memory_order_acquire))
+	{
+		SJob* otherJob = GetJob(index);
+		IfThenStatement(otherJob != nullptr, Execute(otherJob));
+	}
+
+	++worker->NextJob;
+
+	newJob->Function = std::move(job);
+	newJob->Counter = counter;
+	newJob->Dependency = dependency;
+	newJob->Active.store(true, std::memory_order_relaxed);
+
+	counter->Pending.fetch_add(1, std::memory_order_relaxed);
+
+	if (!worker->Queue.Push(newJob))
+	{
+		// Queue is full, run it on this thread once it's ready
+		while (dependency != nullptr && !dependency->IsDone())
+		{
+			SJob* otherJob = GetJob(index);
+			IfThenStatement(otherJob != nullptr, Execute(otherJob));
+		}
+
+		Execute(newJob);
+		return;
+	}
+
+	QueuedJobs.fetch_add(1);
+
+	if (SleepingWorkers.load() > 0)
+	{
+		{ std::lock_guard<std::mutex> lock(SleepLock); }
+		WakeCondition.notify_one();
+	}
+}
+
+/*
+	Blocks until the counter reaches zero, running other jobs in the meantime
+
+	@param counter The counter to wait on
+*/
+void JOBS::Wait(SCounter* counter)
+{
+	int index = WorkerIndex;
+
+	while (!counter->IsDone())
+	{
+		SJob* job = (index >= 0) ? GetJob(index) : nullptr;
+
+		if (job != nullptr)
+		{
+			Execute(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+/*
+	Splits a range into batches and runs them across the workers, returns once every batch has finished
+
+	@param count The number of items in the range
+	@param batchSize The number of items in each job, 0 or less will pick a size based on the number of threads
+	@param function Called with the start and end (exclusive) of each batch
+*/
+void JOBS::ParallelFor(int count, int batchSize, const RangeFunction& function)
+{
+	IfThenReturn(count <= 0, );
+
+	int threadCount = GetThreadCount();
+
+	if (batchSize <= 0)
+	{
+		batchSize = std::max(count / (threadCount * 4), 1);
+	}
+
+	// Not worth splitting up
+	if (threadCount == 1 || WorkerIndex < 0 || count <= batchSize)
+	{
+		function(0, count);
+		return;
+	}
+
+	SCounter counter;
+
+	for (int start = batchSize; start < count; start += batchSize)
+	{
+		int end = std::min(start + batchSize, count);
+		Schedule([&function, start, end]() { function(start, end); }, &counter);
+	}
+
+	// Run the first batch on this thread
+	function(0, batchSize);
+	Wait(&counter);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <atomic>
+#include <functional>
+
+namespace JOBS
+{
+	// Tracks a group of scheduled jobs, reaches zero once every job in the group has finished
+	struct SCounter
+	{
+		std::atomic<int> Pending = 0;
+
+		bool IsDone() const { return Pending.load(std::memory_order_acquire) == 0; }
+	};
+
+	typedef std::function<void()> JobFunction;
+	typedef std::function<void(int, int)> RangeFunction;
+
+	void Initialise(int workerCount = -1); // Start the worker threads, -1 will use one less than the number of hardware threads
+	void CleanUp(); // Stop and join the worker threads
+
+	int GetWorkerCount();
+	int GetThreadCount(); // Workers plus the main thread
+	bool IsMainThread();
+
+	void Schedule(JobFunction job, SCounter* counter, const SCounter* dependency = nullptr);
+	void Wait(SCounter* counter);
+
+	void ParallelFor(int count, int batchSize, const RangeFunction& function);
+}
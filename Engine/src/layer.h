@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
 
+#include "profiler.h"
+
 class ILayer
 {
 public:
@@ -9,8 +11,17 @@ public:
 	virtual void Update() = 0;
 	virtual void Render() = 0;
 	std::string GetLayerType() { return LayerType; }
+	const char* GetProfileName() { return (ProfileName != nullptr) ? ProfileName : (ProfileName = PROFILER::InternName(LayerType)); }
+
+	// Runs before Update on a worker thread alongside the other layers, must not touch GL or anything owned by another layer
+	virtual void UpdateParallel() {}
+	bool HasParallelPhase() { return ParallelPhase; }
 
 protected:
 	std::string LayerType;
+	bool ParallelPhase = false;
+
+private:
+	const char* ProfileName = nullptr;
 };
 
@@ -12,38 +12,54 @@
 #include "layer.h"
 #include "font.h"
 #include "room.h"
-#include "layer.h"
+#include "jobSystem.h"
+#include "profiler.h"
+#include "renderStats.h"
+#include "frameArena.h"
+#include "animationLibrary.h"
+#include "alarmWheel.h"
+#include "helper.h"
+#include "replay.h"
 
 
 void CManager::Initialise()
 {
 	srand(static_cast<unsigned int>(time(0)));
+	HELPER::SeedRandom(static_cast<unsigned long long>(time(0)));
+	STATS::Initialise();
 
 	CProgram::GeneratePrograms();
 	CMesh::GenerateMeshes();
 	CTexture::GenerateTextures();
 	CFont::GenerateFonts();
+	CAnimationLibrary::GenerateLibraries();
 
 	SFX::Initialise();
 	SFX::GenerateSounds();
 
 	GFX::Initialise();
 	TIMER::Initialise();
+	ARENA::Initialise();
+	JOBS::Initialise(WorkerThreads);
+	PROFILER::Initialise();
 
 	CCamera::SetScreenSize(ScreenWidth, ScreenHeight);
 }
 
 void CManager::Update()
 {
+	PROFILE_SCOPE("CManager::Update");
+	ALARM::Update();
 	Rooms[CurrentRoomIndex]->Update();
-	std::for_each(GlobalLayers.begin(), GlobalLayers.end(), [](ILayer* aLayer) { aLayer->Update(); });
+	CRoom::UpdateLayers(GlobalLayers);
 	Rooms[CurrentRoomIndex]->UpdateCamera();
 }
 
 void CManager::Render()
 {
+	PROFILE_SCOPE("CManager::Render");
 	Rooms[CurrentRoomIndex]->Render();
-	std::for_each(GlobalLayers.begin(), GlobalLayers.end(), [](ILayer* aLayer) { aLayer->Render(); });
+	CRoom::RenderLayers(GlobalLayers);
 }
 
 void CManager::CleanUp()
@@ -53,8 +69,15 @@ void CManager::CleanUp()
 	Rooms.clear();
 	GlobalLayers.clear();
 
+	ALARM::CleanUp();
+	REPLAY::Stop();
+	JOBS::CleanUp();
+	PROFILER::CleanUp();
+	ARENA::CleanUp();
+
 	CProgram::CleanUp();
 	CMesh::CleanUp();
+	CAnimationLibrary::CleanUp();
 	CTexture::CleanUp();
 	CFont::CleanUp();
 
@@ -11,6 +11,7 @@ class CManager
 public:
 	unsigned int ScreenWidth = 0;
 	unsigned int ScreenHeight = 0;
+	int WorkerThreads = -1; // Number of job system workers, -1 picks based on the hardware
 
 	std::vector<CRoom*> Rooms;
 	std::vector<ILayer*> GlobalLayers;
@@ -0,0 +1,235 @@
+#include <atomic>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <malloc.h>
+#include <algorithm>
+#include <cstring>
+
+#include "memoryTracker.h"
+#include "profiler.h"
+
+#define MAX_TRACKED_SCOPES 256 // Must be a power of two
+
+/*
+	Replaces the global new and delete so every heap allocation in the program is counted.
+	Nothing in here may allocate, and everything is zero initialised before any constructors
+	run so allocations made during static initialisation are safe to count
+*/
+
+struct SScopeSlot
+{
+	std::atomic<const char*> Name;
+	std::atomic<int> Count;
+	std::atomic<long long> Bytes;
+};
+
+static std::atomic<int> FrameAllocations;
+static std::atomic<int> FrameFrees;
+static std::atomic<long long> FrameBytes;
+static std::atomic<long long> TotalAllocations;
+
+static int LastAllocations = 0;
+static int LastFrees = 0;
+static long long LastBytes = 0;
+
+static SScopeSlot ScopeSlots[MAX_TRACKED_SCOPES];
+static MEMORY::SScopeAllocations LastScopes[MAX_TRACKED_SCOPES];
+static int LastScopeCount = 0;
+
+static const char UnscopedName[] = "(No Scope)";
+
+/*
+	Adds an allocation to the frame totals and to the profiler scope open on this thread
+
+	@param size Number of bytes requested
+*/
+static void RecordAllocation(std::size_t size)
+{
+	FrameAllocations.fetch_add(1, std::memory_order_relaxed);
+	FrameBytes.fetch_add((long long)size, std::memory_order_relaxed);
+	TotalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	// Scopes are only known while the profiler is recording
+	if (!PROFILER::IsEnabled()) { return; }
+
+	const char* scope = PROFILER::GetCurrentScope();
+	if (scope == nullptr) { scope = UnscopedName; }
+
+	// Open addressing on the name pointer, slots are claimed once and never released
+	std::size_t index = ((std::uintptr_t)scope >> 3) & (MAX_TRACKED_SCOPES - 1);
+
+	for (int i = 0; i < MAX_TRACKED_SCOPES; ++i)
+	{
+		SScopeSlot& slot = ScopeSlots[index];
+		const char* name = slot.Name.load(std::memory_order_acquire);
+
+		if (name == nullptr && slot.Name.compare_exchange_strong(name, scope, std::memory_order_acq_rel))
+		{
+			name = scope;
+		}
+
+		if (name == scope)
+		{
+			slot.Count.fetch_add(1, std::memory_order_relaxed);
+			slot.Bytes.fetch_add((long long)size, std::memory_order_relaxed);
+			return;
+		}
+
+		index = (index + 1) & (MAX_TRACKED_SCOPES - 1);
+	}
+}
+
+static void* Allocate(std::size_t size)
+{
+	RecordAllocation(size);
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+static void* AllocateAligned(std::size_t size, std::align_val_t alignment)
+{
+	RecordAllocation(size);
+	return _aligned_malloc(size == 0 ? 1 : size, (std::size_t)alignment);
+}
+
+static void Free(void* memory)
+{
+	if (memory == nullptr) { return; }
+
+	FrameFrees.fetch_add(1, std::memory_order_relaxed);
+	std::free(memory);
+}
+
+static void FreeAligned(void* memory)
+{
+	if (memory == nullptr) { return; }
+
+	FrameFrees.fetch_add(1, std::memory_order_relaxed);
+	_aligned_free(memory);
+}
+
+void* operator new(std::size_t size)
+{
+	void* memory = Allocate(size);
+	if (memory == nullptr) { throw std::bad_alloc(); }
+	return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+	void* memory = Allocate(size);
+	if (memory == nullptr) { throw std::bad_alloc(); }
+	return memory;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	void* memory = AllocateAligned(size, alignment);
+	if (memory == nullptr) { throw std::bad_alloc(); }
+	return memory;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	void* memory = AllocateAligned(size, alignment);
+	if (memory == nullptr) { throw std::bad_alloc(); }
+	return memory;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return AllocateAligned(size, alignment); }
+
+void operator delete(void* memory) noexcept { Free(memory); }
+void operator delete[](void* memory) noexcept { Free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { Free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { Free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { Free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { Free(memory); }
+
+void operator delete(void* memory, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { FreeAligned(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(memory); }
+
+/*
+	Latches the counts for the frame that just finished, should be called once at the end of every frame
+*/
+void MEMORY::EndFrame()
+{
+	LastAllocations = FrameAllocations.exchange(0, std::memory_order_relaxed);
+	LastFrees = FrameFrees.exchange(0, std::memory_order_relaxed);
+	LastBytes = FrameBytes.exchange(0, std::memory_order_relaxed);
+
+	LastScopeCount = 0;
+
+	for (SScopeSlot& slot : ScopeSlots)
+	{
+		const char* name = slot.Name.load(std::memory_order_acquire);
+		if (name == nullptr) { continue; }
+
+		int count = slot.Count.exchange(0, std::memory_order_relaxed);
+		long long bytes = slot.Bytes.exchange(0, std::memory_order_relaxed);
+		if (count == 0) { continue; }
+
+		LastScopes[LastScopeCount++] = { name, count, bytes };
+	}
+
+	std::sort(LastScopes, LastScopes + LastScopeCount, [](const SScopeAllocations& a, const SScopeAllocations& b) { return a.Count > b.Count; });
+}
+
+int MEMORY::GetFrameAllocations()
+{
+	return LastAllocations;
+}
+
+int MEMORY::GetFrameFrees()
+{
+	return LastFrees;
+}
+
+long long MEMORY::GetFrameBytes()
+{
+	return LastBytes;
+}
+
+long long MEMORY::GetTotalAllocations()
+{
+	return TotalAllocations.load(std::memory_order_relaxed);
+}
+
+/*
+	Copies out the scopes that allocated during the last frame, this is only filled while the profiler is enabled
+
+	@param scopes Array to copy into
+	@param maxScopes Size of the array
+	@return Number of scopes copied
+*/
+int MEMORY::GetScopeAllocations(SScopeAllocations* scopes, int maxScopes)
+{
+	int count = std::min(maxScopes, LastScopeCount);
+	std::copy(LastScopes, LastScopes + count, scopes);
+	return count;
+}
+
+/*
+	Counts the allocations made last frame in a profiler scope, this is only filled while the profiler is enabled.
+	Scopes are matched by name as the same name can be opened in several places
+
+	@param name Name the scope was opened with
+	@return Number of allocations made in the scope
+*/
+int MEMORY::GetScopeAllocations(const char* name)
+{
+	int count = 0;
+
+	for (int i = 0; i < LastScopeCount; ++i)
+	{
+		if (std::strcmp(LastScopes[i].Name, name) == 0) { count += LastScopes[i].Count; }
+	}
+
+	return count;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+namespace MEMORY
+{
+	struct SScopeAllocations
+	{
+		const char* Name; // Profiler scope the allocations were made in
+		int Count;
+		long long Bytes;
+	};
+
+	void EndFrame(); // Stores the counts for the frame that just finished and starts the next one
+
+	int GetFrameAllocations(); // Values from the last finished frame
+	int GetFrameFrees();
+	long long GetFrameBytes();
+	long long GetTotalAllocations(); // Since the program started
+
+	int GetScopeAllocations(SScopeAllocations* scopes, int maxScopes); // Scopes that allocated last frame, most allocations first
+	int GetScopeAllocations(const char* name); // Allocations made last frame in every scope with this name
+}
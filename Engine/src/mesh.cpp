@@ -4,6 +4,7 @@
 #include "mesh.h"
 #include "helper.h"
 #include "perlinNoise.h"
+#include "renderStats.h"
 
 std::map<std::string, CMesh*> CMesh::Meshes; // Map of all the meshes
 
@@ -58,6 +59,7 @@ void CMesh::Draw()
 {
 	glBindVertexArray(VAO);
 	glDrawElements(GL_TRIANGLES, IndiceCount, GL_UNSIGNED_INT, 0);
+	STATS::Count(STATS::ECounter::DrawCalls);
 	glBindVertexArray(0);
 }
 
@@ -1,4 +1,5 @@
 #include "meshArray.h"
+#include "renderStats.h"
 
 CMeshArray::CMeshArray(GLuint vao, int elementCount, GLenum drawMode) :
 	CMesh(vao, -1)
@@ -11,6 +12,7 @@ void CMeshArray::Draw()
 {
 	glBindVertexArray(GetVAO());
 	glDrawArrays(DrawMode, 0, ElementCount);
+	STATS::Count(STATS::ECounter::DrawCalls);
 	glBindVertexArray(0);
 }
 
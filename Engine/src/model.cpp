@@ -1,5 +1,6 @@
 #include "model.h"
 #include "program.h"
+#include "renderStats.h"
 
 #pragma warning(push)
 #pragma warning(disable:26495 26812)
@@ -235,6 +236,7 @@ GLuint CModel::TextureFromFile(const char* path, std::string directory)
 	
 	// Assign texture to ID
 	glBindTexture(GL_TEXTURE_2D, textureID);
+	STATS::Count(STATS::ECounter::TextureBinds);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
 	glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -1,6 +1,7 @@
 #include "modelMesh.h"
 #include "program.h"
 #include "camera.h"
+#include "renderStats.h"
 
 #include <sstream>
 #include <gtc\matrix_transform.hpp>
@@ -48,6 +49,7 @@ void CModelMesh::Draw(CProgram* aProgram)
 		glActiveTexture(GL_TEXTURE0 + i);
 		glUniform1i(aProgram->GetUniform(name + number), i);
 		glBindTexture(GL_TEXTURE_2D, Textures[i].id);
+		STATS::Count(STATS::ECounter::TextureBinds);
 	}
 
 	//glUniform3f(aProgram->GetUniform("baseColour"), Colour.x, Colour.y, Colour.z);
@@ -55,6 +57,7 @@ void CModelMesh::Draw(CProgram* aProgram)
 	// Draw mesh
 	glBindVertexArray(VAO);
 	glDrawElements(GL_TRIANGLES, Indices.size(), GL_UNSIGNED_INT, 0);
+	STATS::Count(STATS::ECounter::DrawCalls);
 	glBindVertexArray(0);
 
 	// Always good practice to set everything back to defaults once configured.
@@ -7,11 +7,12 @@
 #include "camera.h"
 #include "timer.h"
 #include "graphics.h"
+#include "renderStats.h"
 
 /*
 	Initialises an empty new object
 */
-CObject::CObject() : Program(0), Mesh(0)
+CObject::CObject() : Program(0), Mesh(0), BuiltTransform(), TransformDirty(true), SeenStep(-1)
 {
 	Pivot = glm::vec3();
 	Scale = glm::vec3(1.0f, 1.0f, 1.0f);
@@ -28,7 +29,7 @@ CObject::CObject() : Program(0), Mesh(0)
 	@param aProgram The program object of the shaders the object will utilise
 	@param aMesh The mesh of the object
 */
-CObject::CObject(CProgram* aProgram, CMesh* aMesh) : Program(aProgram), Mesh(aMesh)
+CObject::CObject(CProgram* aProgram, CMesh* aMesh) : Program(aProgram), Mesh(aMesh), BuiltTransform(), TransformDirty(true), SeenStep(-1)
 {
 	Pivot = glm::vec3();
 	Scale = glm::vec3(1.0f, 1.0f, 1.0f);
@@ -47,8 +48,9 @@ CObject::CObject(CProgram* aProgram, CMesh* aMesh) : Program(aProgram), Mesh(aMe
 	@param aScale Scale of the object
 	@param aRot Rotation of the object
 */
-CObject::CObject(CProgram* aProgram, CMesh* aMesh, glm::vec3 aLoc, glm::vec3 aScale, float aRot) : Program(aProgram), Mesh(aMesh), Location(aLoc), Scale(aScale), RotationZ(aRot)
+CObject::CObject(CProgram* aProgram, CMesh* aMesh, glm::vec3 aLoc, glm::vec3 aScale, float aRot) : Program(aProgram), Mesh(aMesh), Location(aLoc), Scale(aScale), RotationZ(aRot), BuiltTransform(), TransformDirty(true), SeenStep(-1)
 {
+	Pivot = glm::vec3();
 	RotationX = 0.0f;
 	RotationY = 0.0f;
 }
@@ -58,6 +60,7 @@ CObject::CObject(CProgram* aProgram, CMesh* aMesh, glm::vec3 aLoc, glm::vec3 aSc
 */
 CObject::~CObject()
 {
+	ALARM::CancelAll(this);
 }
 
 CProgram* CObject::GetProgram()
@@ -86,10 +89,11 @@ CMesh* CObject::GetMesh()
 void CObject::AssignUniforms(glm::mat4& pv)
 {
 	// Assign current time uniform
-	glUniform1f(Program->GetUniform("currentTime"), TIMER::GetTotalSeconds());
+	glUniform1f(Program->GetUniform("currentTime"), TIMER::GetShaderSeconds());
 
-	// Assign the PVM matrix uniform
+	// Assign the PVM matrix uniform, drawn between the last two simulation steps by moving the translation
 	glm::mat4 model = GetModelMatrix();
+	model[3] += glm::vec4(GetRenderLocation() - Location, 0.0f);
 	glm::mat4 pvm = pv * model;
 	glUniformMatrix4fv(Program->GetUniform("PVM"), 1, GL_FALSE, glm::value_ptr(pvm));
 
@@ -99,6 +103,7 @@ void CObject::AssignUniforms(glm::mat4& pv)
 	{
 		glActiveTexture(GL_TEXTURE0 + i);
 		glBindTexture(GL_TEXTURE_2D, it->second);
+		STATS::Count(STATS::ECounter::TextureBinds);
 		glUniform1i(it->first, i);
 		i++;
 	}
@@ -168,6 +173,7 @@ void CObject::AssignUniforms(glm::mat4& pv)
 	{
 		glActiveTexture(GL_TEXTURE0 + i);
 		glBindTexture(GL_TEXTURE_2D, it->second);
+		STATS::Count(STATS::ECounter::TextureBinds);
 		glUniform1i(it->first, i);
 		i++;
 	}
@@ -257,30 +263,16 @@ void CObject::Draw(glm::mat4& pv)
 }
 
 /*
-	Updates the model matrix and alarms
+	Updates the model matrix if the transform has changed, alarms are run by ALARM::Update
 */
 void CObject::Update()
 {
-	float deltaSec = TIMER::GetDeltaSeconds();
-
-	// Loop through all the alarms
-	for (int i = 0; i < (int)Alarms.size(); ++i)
+	// Update loc rot scale for the render call, objects that haven't moved keep their matrix
+	if (HasTransformChanged())
 	{
-		// Check if alarm is in use
-		if (Alarms[i].first > 0)
-		{
-			// Remove the delta time
-			Alarms[i].first -= deltaSec;
-			if (Alarms[i].first <= 0)
-			{
-				Alarms[i].second(); // Execute function
-				Alarms.erase(Alarms.begin() + i); // Delete the alarm
-			}
-		}
+		UpdateModelMatrix();
+		STATS::Count(STATS::ECounter::TransformUpdates);
 	}
-
-	// Update loc rot scale for the render call
-	UpdateModelMatrix();
 }
 
 /*
@@ -646,6 +638,40 @@ glm::mat4& CObject::GetModelMatrix()
 	return ModelMatrix;
 }
 
+/*
+	Finds where to draw the object this frame, the simulation runs in fixed steps so the location
+	is blended from the end of the previous step to the end of the latest one
+
+	@return The location to draw at
+*/
+glm::vec3 CObject::GetRenderLocation()
+{
+	long long step = TIMER::GetStepCount();
+
+	if (step != SeenStep)
+	{
+		long long steps = step - SeenStep;
+
+		// The previous step's location is only known if this was drawn after it, otherwise estimate it
+		if (SeenStep < 0) { PreviousStepLocation = Location; }
+		else if (steps == 1) { PreviousStepLocation = StepLocation; }
+		else { PreviousStepLocation = glm::mix(StepLocation, Location, (float)(steps - 1) / (float)steps); }
+
+		StepLocation = Location;
+		SeenStep = step;
+	}
+
+	return glm::mix(PreviousStepLocation, Location, TIMER::GetInterpolation());
+}
+
+/*
+	Stops the object blending from where it was, so a teleport doesn't streak across the screen
+*/
+void CObject::ResetInterpolation()
+{
+	SeenStep = -1;
+}
+
 /*
 	Updates the current model matrix based on location, rotation, scale etc.
 */
@@ -655,13 +681,45 @@ void CObject::UpdateModelMatrix()
 	ModelMatrix = GFX::CalculateModelMatrix(Location, Scale, RotationX, RotationY, RotationZ) * pivot;
 }
 
+/*
+	Compares the location, scale, rotation and pivot against the values the model matrix was last
+	built from and stores the new values, children with extra transform state should extend this
+
+	@return If the model matrix needs to be rebuilt
+*/
+bool CObject::HasTransformChanged()
+{
+	bool changed = TransformDirty ||
+		Location != BuiltTransform.Location ||
+		Scale != BuiltTransform.Scale ||
+		Pivot != BuiltTransform.Pivot ||
+		RotationX != BuiltTransform.RotationX ||
+		RotationY != BuiltTransform.RotationY ||
+		RotationZ != BuiltTransform.RotationZ;
+
+	IfThenReturn(!changed, false);
+
+	BuiltTransform = STransformState{ Location, Scale, Pivot, RotationX, RotationY, RotationZ };
+	TransformDirty = false;
+	return true;
+}
+
+/*
+	Forces the model matrix to be rebuilt on the next update, for changes the transform values don't capture
+*/
+void CObject::MarkTransformDirty()
+{
+	TransformDirty = true;
+}
+
 /*
 	Sets an alarm function to be called in x amount of seconds
 
 	@param seconds The amount of seconds before the function is called
 	@param aFunc Function to be called when time has passed
+	@return A handle that can be passed to ALARM::Cancel
 */
-void CObject::SetAlarm(float seconds, std::function<void()> aFunc)
+AlarmHandle CObject::SetAlarm(float seconds, std::function<void()> aFunc)
 {
-	Alarms.push_back(std::make_pair(seconds, aFunc));
+	return ALARM::Set(seconds, aFunc, this);
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include <gtc/type_ptr.hpp>
 
 #include "camera.h"
+#include "alarmWheel.h"
 
 class CMesh;
 class CProgram;
@@ -62,6 +63,8 @@ public:
 
 	// Transforms
 	glm::mat4& GetModelMatrix();
+	glm::vec3 GetRenderLocation(); // Location blended between the last two simulation steps for drawing
+	void ResetInterpolation(); // Draw at the current location straight away, for teleports
 
 	glm::vec3 Location;
 	glm::vec3 Scale;
@@ -78,11 +81,30 @@ protected:
 
 	glm::mat4 ModelMatrix; // The current model matrix 
 	virtual void UpdateModelMatrix(); // Updates the current model matrix
+	virtual bool HasTransformChanged(); // Checks the transform against the one the model matrix was built from
+	void MarkTransformDirty(); // Forces the model matrix to be rebuilt on the next update
 
-	void SetAlarm(float seconds, std::function<void()> aFunc); // Sets an alarm function to call in x seconds
+	AlarmHandle SetAlarm(float seconds, std::function<void()> aFunc); // Sets an alarm function to call in x seconds, cancelled if the object is destroyed first
 
 private:
-	std::vector<std::pair<float, std::function<void()>>> Alarms;
+	// The transform the model matrix was last built from
+	struct STransformState
+	{
+		glm::vec3 Location;
+		glm::vec3 Scale;
+		glm::vec3 Pivot;
+		float RotationX;
+		float RotationY;
+		float RotationZ;
+	};
+
+	STransformState BuiltTransform;
+	bool TransformDirty;
+
+	// Locations at the end of the last two simulation steps this object was drawn after
+	glm::vec3 StepLocation;
+	glm::vec3 PreviousStepLocation;
+	long long SeenStep;
 
 	// Uniform information storage
 	std::map<GLuint, GLuint> UniformsTextures;
@@ -8,6 +8,8 @@
 #include <algorithm>
 
 #include "camera.h"
+#include "jobSystem.h"
+#include "renderStats.h"
 
 
 CParticleLayer::CParticleLayer()
@@ -15,6 +17,7 @@ CParticleLayer::CParticleLayer()
 	ColourProgram = CProgram::GetProgram("Colour");
 	SquareMesh = CMesh::GetMesh("3D Square");
 	LayerType = "CParticleLayer";
+	ParallelPhase = true;
 }
 
 CParticleLayer::~CParticleLayer()
@@ -52,6 +55,7 @@ void CParticleLayer::Render()
 
 		// Draw the particle
 		glDrawElements(GL_TRIANGLES, tempIndicieCount, GL_UNSIGNED_INT, 0);
+		STATS::Count(STATS::ECounter::DrawCalls);
 	}
 
 	// Unbind mesh
@@ -61,24 +65,32 @@ void CParticleLayer::Render()
 	glUseProgram(0);
 }
 
+void CParticleLayer::UpdateParallel()
+{
+	JOBS::ParallelFor((int)Particles.size(), 256, [this](int start, int end)
+	{
+		for (int i = start; i < end; ++i) { Particles[i]->Update(); }
+	});
+}
+
 void CParticleLayer::Update()
 {
-	std::vector<CParticle*>::iterator it = Particles.begin();
+	// Compact the survivors in place rather than erasing one at a time
+	int alive = 0;
 
-	while (it != Particles.end())
+	for (int i = 0; i < (int)Particles.size(); ++i)
 	{
-		(*it)->Update();
-
-		if ((*it)->IsDead())
+		if (Particles[i]->IsDead())
 		{
-			delete (*it);
-			it = Particles.erase(it);
+			delete Particles[i];
 		}
 		else
 		{
-			++it;
+			Particles[alive++] = Particles[i];
 		}
 	}
+
+	Particles.resize(alive);
 }
 
 void CParticleLayer::SpawnBurst(ParticleType& aType, glm::vec2 aLocation, int count)
@@ -37,6 +37,7 @@ public:
 	virtual ~CParticleLayer();
 
 	void Render() override;
+	void UpdateParallel() override;
 	void Update() override;
 
 	void SpawnBurst(ParticleType& aType, glm::vec2 aLocation, int count);
@@ -13,6 +13,7 @@
 #include "texture.h"
 
 #include "camera3D.h"
+#include "renderStats.h"
 
 CParticleLayer3D::CParticleLayer3D(std::shared_ptr<CCamera3D> cam)
 {
@@ -62,6 +63,7 @@ void CParticleLayer3D::Render()
 	
 	glBindVertexArray(VAO);
 	glDrawArrays(GL_POINTS, 0, MeshPoints.size());
+	STATS::Count(STATS::ECounter::DrawCalls);
 	glBindVertexArray(0);
 
 	Uniforms->UnbindTextures();
@@ -0,0 +1,328 @@
+#include <glew.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <set>
+#include <fstream>
+#include <iostream>
+
+#include "profiler.h"
+#include "helper.h"
+
+#define PROFILER_BUFFER_SIZE 65536 // Events kept per thread, must be a power of two
+#define PROFILER_BUFFER_MASK (PROFILER_BUFFER_SIZE - 1)
+#define PROFILER_MAX_DEPTH 64
+#define PROFILER_GPU_QUERIES 128
+#define PROFILER_GPU_DEPTH 8
+
+struct SProfileEvent
+{
+	const char* Name;
+	long long Start; // Nanoseconds since the profiler was initialised
+	long long End;
+};
+
+/*
+	Events recorded by a single thread, only that thread writes to it so recording never locks.
+	WriteIndex is published after each event so a reader can tell which events are complete
+*/
+struct SThreadBuffer
+{
+	SProfileEvent Events[PROFILER_BUFFER_SIZE];
+	std::atomic<unsigned long long> WriteIndex = 0;
+
+	SProfileEvent Stack[PROFILER_MAX_DEPTH];
+	int Depth = 0;
+	int SkippedDepth = 0; // Scopes opened past the maximum depth, these are closed without recording
+
+	int ThreadID = 0;
+	std::string ThreadName;
+};
+
+struct SGPUQuery
+{
+	const char* Name = nullptr;
+	GLuint Queries[2] = { 0, 0 };
+	bool Pending = false;
+};
+
+static std::atomic<bool> Enabled = false;
+static std::chrono::steady_clock::time_point StartTime;
+static long long FrameStart = 0;
+
+static std::mutex BuffersLock; // Only taken the first time a thread records and while saving
+static std::vector<SThreadBuffer*> Buffers;
+static thread_local SThreadBuffer* LocalBuffer = nullptr;
+
+static std::mutex NamesLock;
+static std::set<std::string> Names;
+
+static SGPUQuery GPUQueries[PROFILER_GPU_QUERIES];
+static unsigned int NextGPUQuery = 0;
+static int OpenGPUQueries[PROFILER_GPU_DEPTH];
+static int GPUDepth = 0;
+static int GPUSkippedDepth = 0;
+static long long GPUOffset = 0; // Difference between the CPU and GPU clocks in nanoseconds
+static SThreadBuffer* GPUBuffer = nullptr;
+
+static long long Now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - StartTime).count();
+}
+
+static SThreadBuffer* CreateBuffer(std::string name)
+{
+	SThreadBuffer* buffer = new SThreadBuffer();
+
+	std::lock_guard<std::mutex> lock(BuffersLock);
+	buffer->ThreadID = (int)Buffers.size();
+	buffer->ThreadName = (name == "") ? "Thread " + std::to_string(buffer->ThreadID) : name;
+	Buffers.push_back(buffer);
+
+	return buffer;
+}
+
+static SThreadBuffer* GetBuffer()
+{
+	IfThenStatement(LocalBuffer == nullptr, LocalBuffer = CreateBuffer(""));
+	return LocalBuffer;
+}
+
+static void PushEvent(SThreadBuffer* buffer, const SProfileEvent& profileEvent)
+{
+	unsigned long long index = buffer->WriteIndex.load(std::memory_order_relaxed);
+	buffer->Events[index & PROFILER_BUFFER_MASK] = profileEvent;
+	buffer->WriteIndex.store(index + 1, std::memory_order_release);
+}
+
+/*
+	Sets the start time and creates the GL queries, must be called after the GL context has been created
+*/
+void PROFILER::Initialise()
+{
+	StartTime = std::chrono::steady_clock::now();
+	FrameStart = 0;
+
+	for (SGPUQuery& query : GPUQueries) { glGenQueries(2, query.Queries); }
+
+	// Line the GPU timestamps up with the CPU clock
+	GLint64 gpuTime = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+	GPUOffset = Now() - gpuTime;
+
+	// Initialise is called on the main thread, named here as the workers can record before it does
+	IfThenStatement(LocalBuffer == nullptr, LocalBuffer = CreateBuffer("Main"));
+	GPUBuffer = CreateBuffer("GPU");
+}
+
+void PROFILER::CleanUp()
+{
+	Enabled = false;
+
+	for (SGPUQuery& query : GPUQueries) { glDeleteQueries(2, query.Queries); }
+
+	std::lock_guard<std::mutex> lock(BuffersLock);
+	for (SThreadBuffer* buffer : Buffers) { delete buffer; }
+	Buffers.clear();
+
+	LocalBuffer = nullptr;
+	GPUBuffer = nullptr;
+}
+
+/*
+	Turns recording on or off, this should only be changed between frames so scopes stay balanced
+
+	@param enabled Whether markers should be recorded
+*/
+void PROFILER::SetEnabled(bool enabled)
+{
+	Enabled = enabled;
+}
+
+bool PROFILER::IsEnabled()
+{
+	return Enabled;
+}
+
+/*
+	Records the previous frame as a whole and collects GPU timings that have become available
+*/
+void PROFILER::BeginFrame()
+{
+	IfThenReturn(!Enabled, );
+
+	long long now = Now();
+	PushEvent(GetBuffer(), { "Frame", FrameStart, now });
+	FrameStart = now;
+
+	for (SGPUQuery& query : GPUQueries)
+	{
+		IfThenStatement(!query.Pending, continue);
+
+		GLint available = 0;
+		glGetQueryObjectiv(query.Queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+		IfThenStatement(!available, continue);
+
+		GLuint64 start = 0;
+		GLuint64 end = 0;
+		glGetQueryObjectui64v(query.Queries[0], GL_QUERY_RESULT, &start);
+		glGetQueryObjectui64v(query.Queries[1], GL_QUERY_RESULT, &end);
+
+		PushEvent(GPUBuffer, { query.Name, (long long)start + GPUOffset, (long long)end + GPUOffset });
+		query.Pending = false;
+	}
+}
+
+/*
+	Opens a timed scope on the calling thread, scopes must be closed in the reverse order they were opened
+
+	@param name Name shown in the trace, must stay valid until the trace has been saved
+*/
+void PROFILER::BeginScope(const char* name)
+{
+	IfThenReturn(!Enabled, );
+
+	SThreadBuffer* buffer = GetBuffer();
+
+	// Jobs run inside the scope that waits on them so scopes can nest deeply, the skipped ones still need closing
+	if (buffer->Depth >= PROFILER_MAX_DEPTH)
+	{
+		buffer->SkippedDepth++;
+		return;
+	}
+
+	buffer->Stack[buffer->Depth++] = { name, Now(), 0 };
+}
+
+void PROFILER::EndScope()
+{
+	SThreadBuffer* buffer = LocalBuffer;
+	IfThenReturn(buffer == nullptr, );
+
+	// Closing a scope that was never recorded, the scope it's inside stays open
+	if (buffer->SkippedDepth > 0)
+	{
+		buffer->SkippedDepth--;
+		return;
+	}
+
+	IfThenReturn(buffer->Depth == 0, );
+
+	SProfileEvent& profileEvent = buffer->Stack[--buffer->Depth];
+	profileEvent.End = Now();
+	PushEvent(buffer, profileEvent);
+}
+
+const char* PROFILER::GetCurrentScope()
+{
+	SThreadBuffer* buffer = LocalBuffer;
+	return (buffer == nullptr || buffer->Depth == 0) ? nullptr : buffer->Stack[buffer->Depth - 1].Name;
+}
+
+/*
+	Places a GL timestamp query before the following GL commands, the result is collected
+	in a later BeginFrame once the GPU has caught up
+
+	@param name Name shown in the trace, must stay valid until the trace has been saved
+*/
+void PROFILER::BeginGPUScope(const char* name)
+{
+	IfThenReturn(!Enabled, );
+
+	if (GPUDepth >= PROFILER_GPU_DEPTH)
+	{
+		GPUSkippedDepth++;
+		return;
+	}
+
+	int index = NextGPUQuery++ % PROFILER_GPU_QUERIES;
+	SGPUQuery& query = GPUQueries[index];
+
+	// The GPU is running too far behind to reuse this query, drop the old result
+	query.Pending = false;
+	query.Name = name;
+	glQueryCounter(query.Queries[0], GL_TIMESTAMP);
+
+	OpenGPUQueries[GPUDepth++] = index;
+}
+
+void PROFILER::EndGPUScope()
+{
+	if (GPUSkippedDepth > 0)
+	{
+		GPUSkippedDepth--;
+		return;
+	}
+
+	IfThenReturn(GPUDepth == 0, );
+
+	SGPUQuery& query = GPUQueries[OpenGPUQueries[--GPUDepth]];
+	glQueryCounter(query.Queries[1], GL_TIMESTAMP);
+	query.Pending = true;
+}
+
+/*
+	Stores a copy of a name so it can be used by a scope after the original string has gone
+
+	@param name The name to store
+	@return Pointer to the stored name
+*/
+const char* PROFILER::InternName(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(NamesLock);
+	return Names.insert(name).first->c_str();
+}
+
+/*
+	Writes every recorded event to a JSON file that can be opened with chrome://tracing or Perfetto
+
+	@param filename The file to write to
+	@return If the file was written successfully
+*/
+bool PROFILER::SaveChromeTrace(std::string filename)
+{
+	std::ofstream file(filename, std::ofstream::out | std::ofstream::trunc);
+
+	if (!file.is_open())
+	{
+		std::cout << "WARNING: Unable to save profile to " << filename << std::endl;
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(BuffersLock);
+
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+
+	for (SThreadBuffer* buffer : Buffers)
+	{
+		file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->ThreadID
+			 << ",\"args\":{\"name\":\"" << buffer->ThreadName << "\"}}";
+		first = false;
+
+		// Other threads keep recording while this reads, only the events published before now are read
+		unsigned long long end = buffer->WriteIndex.load(std::memory_order_acquire);
+		unsigned long long start = (end > PROFILER_BUFFER_SIZE) ? end - PROFILER_BUFFER_SIZE : 0;
+
+		for (unsigned long long i = start; i < end; ++i)
+		{
+			SProfileEvent profileEvent = buffer->Events[i & PROFILER_BUFFER_MASK];
+
+			// The writer may have come back round to this slot while it was copied, then the copy can be torn
+			std::atomic_thread_fence(std::memory_order_acquire);
+			IfThenStatement(i + PROFILER_BUFFER_SIZE <= buffer->WriteIndex.load(std::memory_order_relaxed), continue);
+
+			// Chrome trace times are in microseconds
+			file << ",\n{\"name\":\"" << profileEvent.Name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->ThreadID
+				 << ",\"ts\":" << (double)profileEvent.Start / 1000.0
+				 << ",\"dur\":" << (double)(profileEvent.End - profileEvent.Start) / 1000.0 << "}";
+		}
+	}
+
+	file << "\n]}\n";
+	file.close();
+
+	HELPER::PrintToOutput("Saved profile to " + filename);
+	return true;
+}
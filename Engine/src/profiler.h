@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+
+namespace PROFILER
+{
+	void Initialise();
+	void CleanUp();
+
+	void SetEnabled(bool enabled);
+	bool IsEnabled();
+
+	void BeginFrame(); // Marks the start of a frame and collects any finished GPU timings
+
+	void BeginScope(const char* name);
+	void EndScope();
+	const char* GetCurrentScope(); // Innermost open scope on the calling thread, or nullptr
+
+	void BeginGPUScope(const char* name); // Must be called from the thread that owns the GL context
+	void EndGPUScope();
+
+	const char* InternName(const std::string& name); // Gives a pointer that stays valid for the life of the program
+
+	bool SaveChromeTrace(std::string filename);
+}
+
+class CProfileScope
+{
+public:
+	CProfileScope(const char* name) { PROFILER::BeginScope(name); }
+	~CProfileScope() { PROFILER::EndScope(); }
+};
+
+class CGPUProfileScope
+{
+public:
+	CGPUProfileScope(const char* name) { PROFILER::BeginGPUScope(name); }
+	~CGPUProfileScope() { PROFILER::EndGPUScope(); }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+# define PROFILE_SCOPE(name) CProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+# define PROFILE_GPU_SCOPE(name) CGPUProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(name)
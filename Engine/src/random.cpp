@@ -0,0 +1,73 @@
+#include "random.h"
+
+CRandom::CRandom()
+{
+	Seed(0);
+}
+
+CRandom::CRandom(uint64_t seed, uint64_t stream)
+{
+	Seed(seed, stream);
+}
+
+/*
+	Restarts the generator
+
+	@param seed The starting point of the sequence
+	@param stream Which of the independent sequences to use
+*/
+void CRandom::Seed(uint64_t seed, uint64_t stream)
+{
+	State = 0;
+	Increment = (stream << 1) | 1;
+	Next();
+	State += seed;
+	Next();
+}
+
+/*
+	Generates the next number in the sequence
+
+	@return A random 32 bit number
+*/
+uint32_t CRandom::Next()
+{
+	uint64_t oldState = State;
+	State = oldState * 6364136223846793005ULL + Increment;
+
+	uint32_t shifted = (uint32_t)(((oldState >> 18) ^ oldState) >> 27);
+	uint32_t rotation = (uint32_t)(oldState >> 59);
+	return (shifted >> rotation) | (shifted << ((~rotation + 1) & 31));
+}
+
+/*
+	Generates a random number inbetween 0 and a number exclusive, without the bias of using %
+
+	@param maxNum Maximum random number
+	@return A random integer inbetween 0 and maxNum, 0 if maxNum isn't positive
+*/
+int CRandom::Range(int maxNum)
+{
+	if (maxNum <= 0) { return 0; }
+	return (int)(((uint64_t)Next() * (uint64_t)maxNum) >> 32);
+}
+
+int CRandom::Range(int minNum, int maxNum)
+{
+	return Range(maxNum - minNum) + minNum;
+}
+
+float CRandom::Range(float minNum, float maxNum)
+{
+	return Float() * (maxNum - minNum) + minNum;
+}
+
+float CRandom::Float()
+{
+	return (Next() >> 8) * (1.0f / 16777216.0f);
+}
+
+bool CRandom::Chance(float percent)
+{
+	return Float() * 100.0f < percent;
+}
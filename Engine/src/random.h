@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+
+/*
+	A small seedable random number generator (PCG32). Every generator with the same seed and stream
+	produces the same numbers, so anything that owns one behaves the same on every run. It can be
+	passed to std::shuffle and the other standard algorithms
+*/
+class CRandom
+{
+public:
+	typedef uint32_t result_type;
+
+	CRandom();
+	CRandom(uint64_t seed, uint64_t stream = 0);
+
+	void Seed(uint64_t seed, uint64_t stream = 0); // Generators on different streams never repeat each other
+
+	uint32_t Next();
+	int Range(int maxNum); // 0 to maxNum exclusive
+	int Range(int minNum, int maxNum); // minNum to maxNum exclusive
+	float Range(float minNum, float maxNum);
+	float Float(); // 0 to 1 exclusive
+	bool Chance(float percent); // True percent% of the time
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return UINT32_MAX; }
+	result_type operator()() { return Next(); }
+
+private:
+	uint64_t State;
+	uint64_t Increment;
+};
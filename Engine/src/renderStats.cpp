@@ -0,0 +1,190 @@
+#include <glew.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "renderStats.h"
+#include "helper.h"
+
+#define FRAME_HISTORY 240 // Number of frames used for the frame time percentiles
+#define COUNTER_COUNT (int)STATS::ECounter::Count
+
+static int CurrentCounters[COUNTER_COUNT];
+static int LastCounters[COUNTER_COUNT];
+
+static std::vector<std::string> ValueNames;
+static std::vector<int> Values;
+
+static float FrameTimes[FRAME_HISTORY];
+static float SortedFrameTimes[FRAME_HISTORY];
+static int FrameTimeCount = 0;
+static int FrameTimeIndex = 0;
+static bool FrameTimesSorted = false;
+static std::chrono::steady_clock::time_point LastFrameTime;
+
+/*
+	The GL 2.0+ functions are loaded by GLEW through function pointers, so the counted ones are
+	swapped for wrappers that count the call before forwarding it on. GL 1.1 functions such as
+	glDrawElements and glBindTexture can't be swapped and are counted at the call site instead
+*/
+#define COUNTED_GL(name, procType, counter, amount, params, args) \
+	static procType Original##name = nullptr; \
+	static void GLAPIENTRY Counted##name params { CurrentCounters[(int)STATS::ECounter::counter] += (amount); Original##name args; }
+
+#define HOOK_GL(name) if (__glew##name != nullptr && __glew##name != Counted##name) { Original##name = __glew##name; __glew##name = Counted##name; }
+
+COUNTED_GL(UseProgram, PFNGLUSEPROGRAMPROC, ProgramBinds, program != 0, (GLuint program), (program))
+COUNTED_GL(BindVertexArray, PFNGLBINDVERTEXARRAYPROC, VAOBinds, vao != 0, (GLuint vao), (vao))
+COUNTED_GL(BufferData, PFNGLBUFFERDATAPROC, BufferBytes, (int)size, (GLenum target, GLsizeiptr size, const void* data, GLenum usage), (target, size, data, usage))
+COUNTED_GL(BufferSubData, PFNGLBUFFERSUBDATAPROC, BufferBytes, (int)size, (GLenum target, GLintptr offset, GLsizeiptr size, const void* data), (target, offset, size, data))
+
+COUNTED_GL(Uniform1f, PFNGLUNIFORM1FPROC, UniformUploads, 1, (GLint location, GLfloat v0), (location, v0))
+COUNTED_GL(Uniform1i, PFNGLUNIFORM1IPROC, UniformUploads, 1, (GLint location, GLint v0), (location, v0))
+COUNTED_GL(Uniform2f, PFNGLUNIFORM2FPROC, UniformUploads, 1, (GLint location, GLfloat v0, GLfloat v1), (location, v0, v1))
+COUNTED_GL(Uniform2i, PFNGLUNIFORM2IPROC, UniformUploads, 1, (GLint location, GLint v0, GLint v1), (location, v0, v1))
+COUNTED_GL(Uniform3f, PFNGLUNIFORM3FPROC, UniformUploads, 1, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2), (location, v0, v1, v2))
+COUNTED_GL(Uniform3i, PFNGLUNIFORM3IPROC, UniformUploads, 1, (GLint location, GLint v0, GLint v1, GLint v2), (location, v0, v1, v2))
+COUNTED_GL(Uniform3fv, PFNGLUNIFORM3FVPROC, UniformUploads, 1, (GLint location, GLsizei count, const GLfloat* value), (location, count, value))
+COUNTED_GL(Uniform4f, PFNGLUNIFORM4FPROC, UniformUploads, 1, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (location, v0, v1, v2, v3))
+COUNTED_GL(Uniform4i, PFNGLUNIFORM4IPROC, UniformUploads, 1, (GLint location, GLint v0, GLint v1, GLint v2, GLint v3), (location, v0, v1, v2, v3))
+COUNTED_GL(UniformMatrix3fv, PFNGLUNIFORMMATRIX3FVPROC, UniformUploads, 1, (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value), (location, count, transpose, value))
+COUNTED_GL(UniformMatrix4fv, PFNGLUNIFORMMATRIX4FVPROC, UniformUploads, 1, (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value), (location, count, transpose, value))
+
+/*
+	Swaps the GLEW function pointers for the counted versions and starts timing frames
+*/
+void STATS::Initialise()
+{
+	HOOK_GL(UseProgram);
+	HOOK_GL(BindVertexArray);
+	HOOK_GL(BufferData);
+	HOOK_GL(BufferSubData);
+
+	HOOK_GL(Uniform1f);
+	HOOK_GL(Uniform1i);
+	HOOK_GL(Uniform2f);
+	HOOK_GL(Uniform2i);
+	HOOK_GL(Uniform3f);
+	HOOK_GL(Uniform3i);
+	HOOK_GL(Uniform3fv);
+	HOOK_GL(Uniform4f);
+	HOOK_GL(Uniform4i);
+	HOOK_GL(UniformMatrix3fv);
+	HOOK_GL(UniformMatrix4fv);
+
+	std::fill(std::begin(CurrentCounters), std::end(CurrentCounters), 0);
+	std::fill(std::begin(LastCounters), std::end(LastCounters), 0);
+	LastFrameTime = std::chrono::steady_clock::now();
+}
+
+/*
+	Latches the counters for the frame that has just finished and records how long it took
+*/
+void STATS::EndFrame()
+{
+	std::copy(std::begin(CurrentCounters), std::end(CurrentCounters), std::begin(LastCounters));
+	std::fill(std::begin(CurrentCounters), std::end(CurrentCounters), 0);
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	FrameTimes[FrameTimeIndex] = std::chrono::duration<float, std::milli>(now - LastFrameTime).count();
+	LastFrameTime = now;
+
+	FrameTimeIndex = (FrameTimeIndex + 1) % FRAME_HISTORY;
+	FrameTimeCount = std::min(FrameTimeCount + 1, FRAME_HISTORY);
+	FrameTimesSorted = false;
+}
+
+void STATS::Count(ECounter counter, int amount)
+{
+	CurrentCounters[(int)counter] += amount;
+}
+
+int STATS::GetCounter(ECounter counter)
+{
+	return LastCounters[(int)counter];
+}
+
+std::string STATS::GetCounterName(ECounter counter)
+{
+	switch (counter)
+	{
+		case ECounter::DrawCalls: return "Draw Calls";
+		case ECounter::ProgramBinds: return "Program Binds";
+		case ECounter::TextureBinds: return "Texture Binds";
+		case ECounter::VAOBinds: return "VAO Binds";
+		case ECounter::UniformUploads: return "Uniform Uploads";
+		case ECounter::BufferBytes: return "Buffer Bytes";
+		case ECounter::TransformUpdates: return "Transform Updates";
+		default: return "";
+	}
+}
+
+/*
+	Adds a named value to the stats, registering a name twice will return the same index
+
+	@param name Name of the value
+	@return Index used to set and get the value
+*/
+int STATS::RegisterValue(std::string name)
+{
+	std::vector<std::string>::iterator it = std::find(ValueNames.begin(), ValueNames.end(), name);
+	IfThenReturn(it != ValueNames.end(), (int)(it - ValueNames.begin()));
+
+	ValueNames.push_back(name);
+	Values.push_back(0);
+	return (int)Values.size() - 1;
+}
+
+void STATS::SetValue(int index, int value)
+{
+	Values[index] = value;
+}
+
+int STATS::GetValue(int index)
+{
+	return Values[index];
+}
+
+int STATS::GetValue(std::string name)
+{
+	std::vector<std::string>::iterator it = std::find(ValueNames.begin(), ValueNames.end(), name);
+	return (it != ValueNames.end()) ? Values[it - ValueNames.begin()] : 0;
+}
+
+int STATS::GetValueCount()
+{
+	return (int)Values.size();
+}
+
+std::string STATS::GetValueName(int index)
+{
+	return ValueNames[index];
+}
+
+float STATS::GetLastFrameMilliseconds()
+{
+	IfThenReturn(FrameTimeCount == 0, 0.0f);
+	return FrameTimes[(FrameTimeIndex + FRAME_HISTORY - 1) % FRAME_HISTORY];
+}
+
+/*
+	Gets a percentile of the recent frame times
+
+	@param percentile Between 0 and 100
+	@return Frame time in milliseconds
+*/
+float STATS::GetFrameTimePercentile(float percentile)
+{
+	IfThenReturn(FrameTimeCount == 0, 0.0f);
+
+	if (!FrameTimesSorted)
+	{
+		std::copy(FrameTimes, FrameTimes + FrameTimeCount, SortedFrameTimes);
+		std::sort(SortedFrameTimes, SortedFrameTimes + FrameTimeCount);
+		FrameTimesSorted = true;
+	}
+
+	int index = (int)std::round(glm::clamp(percentile, 0.0f, 100.0f) / 100.0f * (FrameTimeCount - 1));
+	return SortedFrameTimes[index];
+}
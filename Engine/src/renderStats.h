@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+
+namespace STATS
+{
+	enum class ECounter
+	{
+		DrawCalls,
+		ProgramBinds,
+		TextureBinds,
+		VAOBinds,
+		UniformUploads,
+		BufferBytes,
+		TransformUpdates, // Model matrices rebuilt because an object moved
+		Count,
+	};
+
+	void Initialise(); // Hooks the counted GL functions, must be called after glewInit
+	void EndFrame(); // Stores the counters for the frame that just finished and starts the next one
+
+	void Count(ECounter counter, int amount = 1);
+	int GetCounter(ECounter counter); // Value from the last finished frame
+	std::string GetCounterName(ECounter counter);
+
+	int RegisterValue(std::string name); // Adds a named value such as an object count, returns the index used to set it
+	void SetValue(int index, int value);
+	int GetValue(int index);
+	int GetValue(std::string name);
+	int GetValueCount();
+	std::string GetValueName(int index);
+
+	float GetLastFrameMilliseconds();
+	float GetFrameTimePercentile(float percentile); // Over the rolling window of recent frames
+}
@@ -0,0 +1,276 @@
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+#include "replay.h"
+#include "helper.h"
+
+#define REPLAY_VERSION 1
+#define REPLAY_FLUSH_SIZE 65536 // Bytes buffered before they're written to the file
+#define CHANNEL_COUNT (int)REPLAY::EChannel::Count
+
+/*
+	Trace layout: SReplayHeader, then records of varint steps since the last record, a channel byte,
+	a varint size and the value. Values carry on until a record for the same channel replaces them.
+	The trace ends with an empty record on channel Count at the last step that was recorded
+*/
+struct SReplayHeader
+{
+	char Magic[4];
+	uint32_t Version;
+	uint64_t Seed;
+	uint32_t StepRate;
+};
+
+enum class EReplayMode
+{
+	Off,
+	Recording,
+	Playing,
+};
+
+static EReplayMode Mode = EReplayMode::Off;
+static std::ofstream OutFile;
+static std::ifstream InFile;
+static std::vector<char> WriteBuffer;
+
+static uint64_t Step = 0;
+static uint64_t LastRecordStep = 0;
+
+static std::vector<char> Values[CHANNEL_COUNT]; // Latest value of each channel
+static bool HasValue[CHANNEL_COUNT] = { };
+
+// The next record waiting to be played
+static bool HasPending = false;
+static uint64_t PendingStep = 0;
+static int PendingChannel = 0;
+static std::vector<char> PendingValue;
+
+static void WriteVarint(uint64_t value)
+{
+	do
+	{
+		uint8_t byte = value & 0x7F;
+		value >>= 7;
+		WriteBuffer.push_back((char)(byte | (value != 0 ? 0x80 : 0)));
+	} while (value != 0);
+}
+
+static bool ReadVarint(uint64_t& value)
+{
+	value = 0;
+
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		char byte;
+		IfThenReturn(!InFile.get(byte), false);
+
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		IfThenReturn((byte & 0x80) == 0, true);
+	}
+
+	return false;
+}
+
+static void Flush()
+{
+	IfThenReturn(WriteBuffer.empty(), );
+	OutFile.write(WriteBuffer.data(), WriteBuffer.size());
+	WriteBuffer.clear();
+}
+
+/*
+	Reads the next record from the trace into the pending record
+*/
+static void ReadPending()
+{
+	uint64_t steps = 0;
+	uint64_t size = 0;
+	char channel = 0;
+
+	HasPending = ReadVarint(steps) && InFile.get(channel) && ReadVarint(size) && (int)(uint8_t)channel <= CHANNEL_COUNT;
+	IfThenReturn(!HasPending, );
+
+	PendingStep += steps;
+	PendingChannel = (uint8_t)channel;
+	PendingValue.resize((size_t)size);
+	HasPending = (bool)InFile.read(PendingValue.data(), size);
+}
+
+/*
+	Makes every record up to the current step the latest value of its channel
+*/
+static void ApplyPending()
+{
+	while (HasPending && PendingChannel != CHANNEL_COUNT && PendingStep <= Step)
+	{
+		Values[PendingChannel].swap(PendingValue);
+		HasValue[PendingChannel] = true;
+		ReadPending();
+	}
+}
+
+static void ResetChannels()
+{
+	for (int i = 0; i < CHANNEL_COUNT; ++i)
+	{
+		Values[i].clear();
+		HasValue[i] = false;
+	}
+
+	Step = 0;
+	LastRecordStep = 0;
+	PendingStep = 0;
+	HasPending = false;
+}
+
+/*
+	Starts writing a trace, any trace already being recorded or played is stopped
+
+	@param filename File to write
+	@param seed The random seed the run was started with
+	@param stepRate The simulation steps per second
+	@return If the file could be opened
+*/
+bool REPLAY::StartRecording(const std::string& filename, unsigned long long seed, int stepRate)
+{
+	Stop();
+
+	OutFile.open(filename, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+	if (!OutFile.is_open())
+	{
+		std::cout << "WARNING: Unable to record replay to " << filename << std::endl;
+		return false;
+	}
+
+	SReplayHeader header = { { 'R', 'P', 'L', 'Y' }, REPLAY_VERSION, seed, (uint32_t)stepRate };
+	OutFile.write((const char*)&header, sizeof(header));
+
+	ResetChannels();
+	Mode = EReplayMode::Recording;
+	return true;
+}
+
+/*
+	Starts playing a trace back, any trace already being recorded or played is stopped
+
+	@param filename File to play
+	@param seed Set to the random seed the trace was recorded with
+	@param stepRate Set to the steps per second the trace was recorded with
+	@return If the trace could be opened
+*/
+bool REPLAY::StartPlayback(const std::string& filename, unsigned long long& seed, int& stepRate)
+{
+	Stop();
+
+	InFile.open(filename, std::ifstream::in | std::ifstream::binary);
+	SReplayHeader header = {};
+
+	if (!InFile.is_open() || !InFile.read((char*)&header, sizeof(header)) || std::memcmp(header.Magic, "RPLY", 4) != 0 || header.Version != REPLAY_VERSION)
+	{
+		std::cout << "WARNING: " << filename << " is not a replay that can be played" << std::endl;
+		InFile.close();
+		return false;
+	}
+
+	seed = header.Seed;
+	stepRate = (int)header.StepRate;
+
+	// Values recorded before the first step, such as the desktop the run started on, are needed straight away
+	ResetChannels();
+	ReadPending();
+	ApplyPending();
+	Mode = EReplayMode::Playing;
+	return true;
+}
+
+void REPLAY::Stop()
+{
+	if (Mode == EReplayMode::Recording)
+	{
+		// Mark the end so playback knows how many steps were recorded
+		WriteVarint(Step - LastRecordStep);
+		WriteBuffer.push_back((char)CHANNEL_COUNT);
+		WriteVarint(0);
+
+		Flush();
+		OutFile.close();
+	}
+
+	IfThenStatement(Mode == EReplayMode::Playing, InFile.close());
+	Mode = EReplayMode::Off;
+}
+
+bool REPLAY::IsRecording()
+{
+	return Mode == EReplayMode::Recording;
+}
+
+bool REPLAY::IsPlaying()
+{
+	return Mode == EReplayMode::Playing;
+}
+
+/*
+	Moves on to the next simulation step, when playing this loads every value recorded for the step
+*/
+void REPLAY::BeginStep()
+{
+	IfThenReturn(Mode == EReplayMode::Off, );
+	Step++;
+
+	IfThenReturn(Mode != EReplayMode::Playing, );
+
+	ApplyPending();
+
+	// Carry on with live input once every recorded step has been played
+	if (!HasPending || (PendingChannel == CHANNEL_COUNT && PendingStep < Step))
+	{
+		std::cout << "Replay finished after " << Step << " steps" << std::endl;
+		InFile.close();
+		Mode = EReplayMode::Off;
+	}
+}
+
+void REPLAY::Sync(EChannel channel, void* data, size_t size)
+{
+	IfThenReturn(Mode == EReplayMode::Off, );
+
+	std::vector<char> value((char*)data, (char*)data + size);
+	Sync(channel, value);
+
+	// A recorded value of a different size doesn't belong here, keep the live one
+	IfThenStatement(value.size() == size, std::memcpy(data, value.data(), size));
+}
+
+/*
+	Records a value if it has changed since it was last recorded, or replaces it with the recorded value
+
+	@param channel What the value is
+	@param data The value
+*/
+void REPLAY::Sync(EChannel channel, std::vector<char>& data)
+{
+	int index = (int)channel;
+
+	if (Mode == EReplayMode::Recording)
+	{
+		IfThenReturn(HasValue[index] && Values[index] == data, );
+
+		WriteVarint(Step - LastRecordStep);
+		WriteBuffer.push_back((char)index);
+		WriteVarint(data.size());
+		WriteBuffer.insert(WriteBuffer.end(), data.begin(), data.end());
+
+		LastRecordStep = Step;
+		Values[index] = data;
+		HasValue[index] = true;
+
+		IfThenStatement(WriteBuffer.size() >= REPLAY_FLUSH_SIZE, Flush());
+	}
+	else if (Mode == EReplayMode::Playing && HasValue[index])
+	{
+		data = Values[index];
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*
+	Records everything from outside the program that the simulation reads (input, monitors and windows)
+	into a compact binary trace, and plays it back so the same run can be repeated exactly. A value is
+	only written when it changes, once per simulation step at most. Recording and playback happen on the main thread
+*/
+namespace REPLAY
+{
+	enum class EChannel : uint8_t
+	{
+		Mouse,
+		Keyboard,
+		Monitors,
+		Windows,
+		Count,
+	};
+
+	bool StartRecording(const std::string& filename, unsigned long long seed, int stepRate);
+	bool StartPlayback(const std::string& filename, unsigned long long& seed, int& stepRate); // Gives back the seed and step rate the trace was recorded with
+	void Stop(); // Finishes writing the trace or stops playing it
+
+	bool IsRecording();
+	bool IsPlaying();
+
+	void BeginStep(); // Should be called at the start of every simulation step
+
+	// Records the value when recording, replaces it with the recorded value when playing
+	void Sync(EChannel channel, void* data, size_t size);
+	void Sync(EChannel channel, std::vector<char>& data);
+}
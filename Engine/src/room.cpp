@@ -1,7 +1,10 @@
 #include <algorithm>
 
 #include "room.h"
+#include "helper.h"
 #include "layer.h"
+#include "jobSystem.h"
+#include "profiler.h"
 
 CRoom::CRoom(std::shared_ptr<CCamera> camera)
 {
@@ -21,14 +24,58 @@ void CRoom::UpdateCamera()
 
 void CRoom::Update()
 {
-	std::for_each(Layers.begin(), Layers.end(), [](ILayer* aLay) { aLay->Update(); });
+	PROFILE_SCOPE("CRoom::Update");
+	UpdateLayers(Layers);
 }
 
 void CRoom::Render()
 {
-	std::for_each(Layers.begin(), Layers.end(), [](ILayer* aLay) { aLay->Render(); });
+	PROFILE_SCOPE("CRoom::Render");
+	RenderLayers(Layers);
 }
 
 void CRoom::OnSelect()
 {
 }
+
+/*
+	Runs the parallel phase of every layer that has one across the job system, then the
+	regular updates in order on the calling thread
+
+	@param layers The layers to update
+*/
+void CRoom::UpdateLayers(std::vector<ILayer*>& layers)
+{
+	JOBS::SCounter counter;
+
+	for (ILayer* aLay : layers)
+	{
+		IfThenStatement(!aLay->HasParallelPhase(), continue);
+
+		const char* name = aLay->GetProfileName();
+		JOBS::Schedule([aLay, name]() { PROFILE_SCOPE(name); aLay->UpdateParallel(); }, &counter);
+	}
+
+	JOBS::Wait(&counter);
+
+	for (ILayer* aLay : layers)
+	{
+		PROFILE_SCOPE(aLay->GetProfileName());
+		aLay->Update();
+	}
+}
+
+/*
+	Renders each layer in order, timing both the CPU and GPU side of each one
+
+	@param layers The layers to render
+*/
+void CRoom::RenderLayers(std::vector<ILayer*>& layers)
+{
+	for (ILayer* aLay : layers)
+	{
+		PROFILE_SCOPE(aLay->GetProfileName());
+		PROFILE_GPU_SCOPE(aLay->GetProfileName());
+		aLay->Render();
+	}
+}
@@ -17,6 +17,9 @@ public:
 	virtual void Render();
 	virtual void OnSelect();
 
+	static void UpdateLayers(std::vector<ILayer*>& layers);
+	static void RenderLayers(std::vector<ILayer*>& layers);
+
 	std::vector<ILayer*> Layers;
 
 private:
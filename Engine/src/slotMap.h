@@ -0,0 +1,111 @@
+#pragma once
+#include <vector>
+
+// Refers to a value in a slot map, the handle goes stale once the value is removed
+struct SSlotHandle
+{
+	unsigned int Index = 0;
+	unsigned int Generation = 0; // Slots start at generation 1 so a default handle is always stale
+
+	bool operator==(const SSlotHandle& other) const { return Index == other.Index && Generation == other.Generation; }
+	bool operator!=(const SSlotHandle& other) const { return !(*this == other); }
+};
+
+/*
+	Keeps values packed together in one array for iterating over, while handing out handles that stay
+	valid as other values come and go. Adding and removing are constant time, removing moves the last
+	value into the gap so the order of the values changes. A handle to a removed value is detected by
+	its slot's generation having moved on, even once the slot has been reused
+*/
+template<typename T>
+class CSlotMap
+{
+public:
+	SSlotHandle Insert(const T& value)
+	{
+		unsigned int slot;
+
+		if (FreeSlots.empty())
+		{
+			slot = (unsigned int)Slots.size();
+			Slots.push_back(SSlot{ 0, 1 });
+		}
+		else
+		{
+			slot = FreeSlots.back();
+			FreeSlots.pop_back();
+		}
+
+		Slots[slot].DenseIndex = (unsigned int)Values.size();
+		Values.push_back(value);
+		DenseToSlot.push_back(slot);
+
+		return SSlotHandle{ slot, Slots[slot].Generation };
+	}
+
+	bool Remove(SSlotHandle handle)
+	{
+		if (!IsValid(handle)) { return false; }
+
+		SSlot& slot = Slots[handle.Index];
+		unsigned int last = (unsigned int)Values.size() - 1;
+
+		// Fill the gap with the last value so the values stay packed
+		if (slot.DenseIndex != last)
+		{
+			Values[slot.DenseIndex] = std::move(Values[last]);
+			DenseToSlot[slot.DenseIndex] = DenseToSlot[last];
+			Slots[DenseToSlot[last]].DenseIndex = slot.DenseIndex;
+		}
+
+		Values.pop_back();
+		DenseToSlot.pop_back();
+
+		// Skip generation 0 when it wraps around, it's what a default handle has
+		slot.Generation = slot.Generation + 1 != 0 ? slot.Generation + 1 : 1;
+		FreeSlots.push_back(handle.Index);
+		return true;
+	}
+
+	bool IsValid(SSlotHandle handle) const
+	{
+		return handle.Index < Slots.size() && Slots[handle.Index].Generation == handle.Generation;
+	}
+
+	T* Get(SSlotHandle handle) // nullptr if the handle is stale
+	{
+		return IsValid(handle) ? &Values[Slots[handle.Index].DenseIndex] : nullptr;
+	}
+
+	SSlotHandle GetHandle(int index) const // Handle of the value at an index of the packed array
+	{
+		unsigned int slot = DenseToSlot[index];
+		return SSlotHandle{ slot, Slots[slot].Generation };
+	}
+
+	void Clear()
+	{
+		while (!Values.empty()) { Remove(GetHandle(Size() - 1)); }
+	}
+
+	int Size() const { return (int)Values.size(); }
+	bool Empty() const { return Values.empty(); }
+
+	T& operator[](int index) { return Values[index]; }
+	T* Data() { return Values.data(); }
+
+	typename std::vector<T>::iterator begin() { return Values.begin(); }
+	typename std::vector<T>::iterator end() { return Values.end(); }
+
+private:
+	struct SSlot
+	{
+		unsigned int DenseIndex;
+		unsigned int Generation;
+	};
+
+	std::vector<T> Values;
+	std::vector<unsigned int> DenseToSlot; // Which slot each value belongs to
+	std::vector<SSlot> Slots;
+	std::vector<unsigned int> FreeSlots;
+};
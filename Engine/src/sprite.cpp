@@ -5,47 +5,19 @@
 #include "mesh.h"
 #include "program.h"
 #include "timer.h"
+#include "profiler.h"
 
-SSpriteAnimation::SSpriteAnimation()
-{
-}
-
-SSpriteAnimation::SSpriteAnimation(CTexture* spriteSheet, int splitX, int splitY, glm::vec2 pivot, std::vector<glm::ivec2> frames, EAnimationType animationType, float fps, bool flipped)
-{
-	SpriteSheet = spriteSheet;
-	SplitX = splitX;
-	SplitY = splitY;
-	Pivot = pivot;
-	Frames = frames;
-	AnimationType = animationType;
-	FPS = fps;
-	Flipped = flipped;
-}
-
-SSpriteAnimation::SSpriteAnimation(CTexture* spriteSheet, int splitX, int splitY, glm::vec2 pivot, EAnimationType animationType, float fps, bool flipped)
-{
-	SpriteSheet = spriteSheet;
-	SplitX = splitX;
-	SplitY = splitY;
-	Pivot = pivot;
-	AnimationType = animationType;
-	FPS = fps;
-	Flipped = flipped;
-
-	for (int y = 0; y < splitY; ++y)
-	{
-		for (int x = 0; x < splitX; ++x)
-		{
-			Frames.push_back({ x, y });
-		}
-	}
-}
+static const std::string NoAnimationName = ""; // Name given when no animation is playing
+static const SSpriteAnimation EmptyAnimation;
 
 /*
 	Initialises a blank new sprite
 */
 CSprite::CSprite() : CObject(CProgram::GetProgram("SpriteSheet"), CMesh::GetMesh("2D Square"))
 {
+	Library = nullptr;
+	OwnsLibrary = false;
+	CurrentAnimation = NO_ANIMATION;
 	AnimationSpeed = 1.0f;
 	AnimationFrame = 0.0f;
 	GenerateAnimations();
@@ -59,9 +31,14 @@ CSprite::CSprite() : CObject(CProgram::GetProgram("SpriteSheet"), CMesh::GetMesh
 */
 CSprite::CSprite(SSpriteAnimation animation, glm::vec3 aLoc) : CObject(CProgram::GetProgram("SpriteSheet"), CMesh::GetMesh("2D Square"), aLoc)
 {
-	// Create a default animation
-	Animations.insert({ "Default", animation });
-	SetAnimationIndex("Default");
+	// Create a default animation in a library only this sprite uses
+	Library = new CAnimationLibrary();
+	OwnsLibrary = true;
+	CurrentAnimation = NO_ANIMATION;
+	AnimationSpeed = 1.0f;
+	AnimationFrame = 0.0f;
+
+	SetAnimation(Library->AddAnimation("Default", animation));
 }
 
 /*
@@ -69,7 +46,8 @@ CSprite::CSprite(SSpriteAnimation animation, glm::vec3 aLoc) : CObject(CProgram:
 */
 CSprite::~CSprite()
 {
-	Animations.clear();
+	IfThenStatement(OwnsLibrary, delete Library);
+	Library = nullptr;
 }
 
 /*
@@ -79,8 +57,8 @@ void CSprite::Update()
 {
 	CObject::Update(); // Update the model matrix
 
-	IfThenReturn(AnimationIndex == "", ); // If the animation index is empty then break out (don't update the animation)
-	SSpriteAnimation tempAnim = Animations[AnimationIndex];
+	IfThenReturn(CurrentAnimation == NO_ANIMATION, ); // If there is no animation then break out (don't update the animation)
+	const SSpriteAnimation& tempAnim = Library->GetAnimation(CurrentAnimation);
 	AnimationFrame += tempAnim.FPS * AnimationSpeed * TIMER::GetDeltaSeconds(); // Increase animation frame
 
 	// Check if animations is finished
@@ -98,13 +76,12 @@ void CSprite::Update()
 */
 void CSprite::Draw(glm::mat4& pv)
 {
-	IfThenReturn(AnimationIndex == "", ); // If the animation index is empty then break out (don't update the animation)
+	IfThenReturn(CurrentAnimation == NO_ANIMATION, ); // If there is no animation then break out (don't draw)
 
 	// Update uniforms
-	SSpriteAnimation tempAnim = Animations[AnimationIndex];
+	const SSpriteAnimation& tempAnim = Library->GetAnimation(CurrentAnimation);
 	UpdateUniformTexture("tex", tempAnim.SpriteSheet->GetID());
-	UpdateUniformiVec2("splitNumber", { tempAnim.SplitX, tempAnim.SplitY });
-	UpdateUniformiVec2("spriteIndex", tempAnim.Frames[CalculateFrame()]);
+	UpdateUniformfVec4("uvRect", tempAnim.UVRects[CalculateFrame()]);
 
 	// Draw the sprite
 	CObject::Draw(pv);
@@ -117,9 +94,8 @@ void CSprite::Draw(glm::mat4& pv)
 */
 float CSprite::GetImageWidth()
 {
-	IfThenReturn(AnimationIndex == "", 0); // If the animation index is empty then break out (don't update the animation)
-	SSpriteAnimation tempAnim = Animations[AnimationIndex];
-	return tempAnim.SpriteSheet->GetWidth() / static_cast<float>(tempAnim.SplitX);
+	IfThenReturn(CurrentAnimation == NO_ANIMATION, 0); // If there is no animation then break out
+	return Library->GetAnimation(CurrentAnimation).FrameSize.x;
 }
 
 /*
@@ -129,31 +105,53 @@ float CSprite::GetImageWidth()
 */
 float CSprite::GetImageHeight()
 {
-	IfThenReturn(AnimationIndex == "", 0); // If the animation index is empty then break out (don't update the animation)
-	SSpriteAnimation tempAnim = Animations[AnimationIndex];
-	return tempAnim.SpriteSheet->GetHeight() / static_cast<float>(tempAnim.SplitY);
+	IfThenReturn(CurrentAnimation == NO_ANIMATION, 0); // If there is no animation then break out
+	return Library->GetAnimation(CurrentAnimation).FrameSize.y;
+}
+
+/*
+	Sets the new animation
+
+	@param handle The handle of the new animation in the sprites library, NO_ANIMATION to stop animating
+*/
+void CSprite::SetAnimation(AnimationHandle handle)
+{
+	// Test if it is a new animation
+	IfThenReturn(CurrentAnimation == handle, );
+
+	// Reset animations
+	CurrentAnimation = handle;
+	AnimationFrame = 0;
+	AnimationSpeed = 1;
+
+	IfThenReturn(CurrentAnimation == NO_ANIMATION, ); // If there is no animation then break out (don't update the animation)
+	Pivot = glm::vec3(Library->GetAnimation(CurrentAnimation).Pivot, 0.0f); // Update the pivot based on the animation
+
+	UpdateModelMatrix();
+}
+
+AnimationHandle CSprite::GetAnimationHandle()
+{
+	return CurrentAnimation;
 }
 
 /*
-	Sets the new animation based on the name
+	Sets the new animation based on the name, prefer SetAnimation with a stored handle on hot paths
 
 	@param anAnimationIndex The name index of the new animation
 */
-void CSprite::SetAnimationIndex(std::string anAnimationIndex)
+void CSprite::SetAnimationIndex(const std::string& anAnimationIndex)
 {
-	// Test if it is a new animation index
-	if (AnimationIndex != anAnimationIndex)
-	{
-		// Reset animations
-		AnimationIndex = anAnimationIndex;
-		AnimationFrame = 0;
-		AnimationSpeed = 1;
+	PROFILE_SCOPE("CSprite::SetAnimationIndex");
 
-		IfThenReturn(AnimationIndex == "", ); // If the animation index is empty then break out (don't update the animation)
-		Pivot = glm::vec3(Animations[AnimationIndex].Pivot, 0.0f); // Update the pivot based on the animation
+	AnimationHandle handle = (Library != nullptr && anAnimationIndex != "") ? Library->GetHandle(anAnimationIndex) : NO_ANIMATION;
 
-		UpdateModelMatrix();
+	if (handle == NO_ANIMATION && anAnimationIndex != "")
+	{
+		std::cout << "WARNING: Animation " << anAnimationIndex << " does not exist" << std::endl;
 	}
+
+	SetAnimation(handle);
 }
 
 /*
@@ -161,19 +159,35 @@ void CSprite::SetAnimationIndex(std::string anAnimationIndex)
 
 	@return The name index of the current animation
 */
-std::string CSprite::GetAnimationIndex()
+const std::string& CSprite::GetAnimationIndex()
 {
-	return AnimationIndex;
+	return (CurrentAnimation == NO_ANIMATION) ? NoAnimationName : Library->GetName(CurrentAnimation);
 }
 
-SSpriteAnimation& CSprite::GetAnimation(std::string anAnimationIndex)
+const SSpriteAnimation& CSprite::GetAnimation(const std::string& anAnimationIndex)
 {
-	return Animations[anAnimationIndex];
+	AnimationHandle handle = (Library != nullptr) ? Library->GetHandle(anAnimationIndex) : NO_ANIMATION;
+	return (handle == NO_ANIMATION) ? EmptyAnimation : Library->GetAnimation(handle);
+}
+
+/*
+	Changes the animations the sprite can play, the current animation is stopped
+
+	@param library The shared library to use
+*/
+void CSprite::SetAnimationLibrary(CAnimationLibrary* library)
+{
+	IfThenStatement(OwnsLibrary, delete Library);
+	OwnsLibrary = false;
+
+	Library = library;
+	CurrentAnimation = NO_ANIMATION;
+	MarkTransformDirty();
 }
 
-std::map<std::string, SSpriteAnimation>& CSprite::GetAnimations()
+CAnimationLibrary* CSprite::GetAnimationLibrary()
 {
-	return Animations;
+	return Library;
 }
 
 /*
@@ -183,8 +197,8 @@ std::map<std::string, SSpriteAnimation>& CSprite::GetAnimations()
 */
 int CSprite::CalculateFrame()
 {
-	IfThenReturn(AnimationIndex == "", -1); // If the animation index is empty then break out (don't update the animation)
-	SSpriteAnimation tempAnim = Animations[AnimationIndex];
+	IfThenReturn(CurrentAnimation == NO_ANIMATION, -1); // If there is no animation then break out
+	const SSpriteAnimation& tempAnim = Library->GetAnimation(CurrentAnimation);
 	int frameSize = tempAnim.Frames.size();
 
 	// Return the frame based on the animation type
@@ -214,8 +228,8 @@ int CSprite::CalculateFrame()
 */
 int CSprite::GetFrameCount()
 {
-	IfThenReturn(AnimationIndex == "", 0); // If the animation index is empty then break out (don't update the animation)
-	return Animations[AnimationIndex].Frames.size();
+	IfThenReturn(CurrentAnimation == NO_ANIMATION, 0); // If there is no animation then break out
+	return Library->GetAnimation(CurrentAnimation).Frames.size();
 }
 
 /*
@@ -229,15 +243,15 @@ void CSprite::GenerateAnimations() { }
 void CSprite::OnAnimationEnd() { }
 
 /*
-	Calculates and updates the current model matrix (automaticaly scales to image width and height)
+	Calculates and updates the current model matrix (automaticaly scales to image width and height),
+	the transform is built as a 2D affine and only expanded to a mat4 at the end
 */
 void CSprite::UpdateModelMatrix()
 {
-	glm::mat4 spriteScale = glm::scale(glm::mat4(), glm::vec3(GetImageWidth(), GetImageHeight(), 1.0f));
-	glm::mat4 pivot = glm::translate(glm::mat4(), -Pivot);
-	glm::mat4 scale = glm::scale(glm::mat4(), glm::vec3(Scale.x * (Animations[AnimationIndex].Flipped ? -1.0f : 1.0f), Scale.y, Scale.z));
-	glm::mat4 rotation = glm::rotate(glm::mat4(), glm::radians(RotationZ), glm::vec3(0.0f, 0.0f, 1.0f));
-	glm::mat4 translation = glm::translate(glm::mat4(), Location);
+	bool flipped = CurrentAnimation != NO_ANIMATION && Library->GetAnimation(CurrentAnimation).Flipped;
+	glm::vec2 scale = glm::vec2(Scale.x * (flipped ? -1.0f : 1.0f), Scale.y);
+	SAffine2D spriteScale = SAffine2D(glm::vec2(GetImageWidth(), 0.0f), glm::vec2(0.0f, GetImageHeight()), glm::vec2());
 
-	ModelMatrix = translation * rotation * scale * pivot * spriteScale;
+	Transform2D = SAffine2D::Compose(glm::vec2(Location), scale, RotationZ, glm::vec2(Pivot)) * spriteScale;
+	ModelMatrix = Transform2D.ToMat4(Location.z - Scale.z * Pivot.z, Scale.z);
 }
@@ -4,29 +4,8 @@
 
 #include "object.h"
 #include "texture.h"
-
-enum class EAnimationType
-{
-	Toggle,
-	Loop,
-	PingPong,
-};
-
-struct SSpriteAnimation
-{
-	CTexture* SpriteSheet = nullptr; // The ID of the sprite sheet for the animation
-	int SplitX = 0; // The number of sprites going horizontaly on the sprite sheet
-	int SplitY = 0; // The number of sprites going verticaly on the sprite sheet
-	glm::vec2 Pivot = glm::vec2(); // The pivot of one frame
-	std::vector<glm::ivec2> Frames; // A list of frames which map to sprite sheet coords
-	EAnimationType AnimationType; // The type of animation (What happens after it is done etc.)
-	float FPS = 0.0f; // The frames per second of the animation
-	bool Flipped = false; // Whether the sprite is flipped on the x-axis
-
-	SSpriteAnimation();
-	SSpriteAnimation(CTexture* spriteSheet, int splitX, int splitY, glm::vec2 pivot, std::vector<glm::ivec2> frames, EAnimationType animationType, float fps, bool flipped = false);
-	SSpriteAnimation(CTexture* spriteSheet, int splitX, int splitY, glm::vec2 pivot, EAnimationType animationType, float fps, bool flipped = false);
-};
+#include "animationLibrary.h"
+#include "affine2D.h"
 
 class CSprite :
 	public CObject
@@ -43,10 +22,14 @@ public:
 	float GetImageHeight(); // Find sub sprite width
 	int GetFrameCount(); // Find the number of frames in the current animation
 
-	void SetAnimationIndex(std::string anAnimationIndex); // Set the current animation
-	std::string GetAnimationIndex(); // Get the current animation index
-	SSpriteAnimation& GetAnimation(std::string anAnimationIndex);
-	std::map<std::string, SSpriteAnimation>& GetAnimations();
+	void SetAnimation(AnimationHandle handle); // Set the current animation
+	AnimationHandle GetAnimationHandle(); // Get the current animation, NO_ANIMATION if there isn't one
+	void SetAnimationIndex(const std::string& anAnimationIndex); // Set the current animation by name
+	const std::string& GetAnimationIndex(); // Get the name of the current animation
+	const SSpriteAnimation& GetAnimation(const std::string& anAnimationIndex);
+
+	void SetAnimationLibrary(CAnimationLibrary* library);
+	CAnimationLibrary* GetAnimationLibrary();
 
 	int CalculateFrame(); // Get the current index of the animation
 
@@ -54,12 +37,14 @@ public:
 	virtual void OnAnimationEnd();
 
 protected:
-	std::map<std::string, SSpriteAnimation> Animations; // List of Animations
+	CAnimationLibrary* Library; // Shared animations, owned by the library registry unless OwnsLibrary is set
 	float AnimationSpeed; // The speed of the animation (1.0f is normal speed)
 	float AnimationFrame; // The current frame of the animation (number is rounded to get the frame
+	SAffine2D Transform2D; // The model matrix before it is expanded to a mat4
 
 	void UpdateModelMatrix() override;
 
 private:
-	std::string AnimationIndex; // The index of the current animation defaults to ""
+	AnimationHandle CurrentAnimation; // The current animation defaults to NO_ANIMATION
+	bool OwnsLibrary;
 };
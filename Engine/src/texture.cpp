@@ -5,6 +5,7 @@
 
 #include "helper.h"
 #include "texture.h"
+#include "renderStats.h"
 
 // The begining file path for all textures
 const char ImageFilePath[] = "Resources\\Images\\";
@@ -25,6 +26,7 @@ CTexture::CTexture(std::string filename)
 
 	glGenTextures(1, &ID);
 	glBindTexture(GL_TEXTURE_2D, ID);
+	STATS::Count(STATS::ECounter::TextureBinds);
 
 	// Texture will mirror repeat on the x and y axis
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -51,6 +53,7 @@ CTexture::CTexture(void* data, unsigned int width, unsigned int height, GLenum f
 
 	glGenTextures(1, &ID);
 	glBindTexture(GL_TEXTURE_2D, ID);
+	STATS::Count(STATS::ECounter::TextureBinds);
 	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, Width, Height, 0, format, GL_UNSIGNED_BYTE, data);
 	
 	// Texture will mirror repeat on the x and y axis
@@ -82,6 +85,7 @@ CTexture::CTexture(unsigned int width, unsigned int height, bool rgb)
 
 	glGenTextures(1, &ID);
 	glBindTexture(GL_TEXTURE_2D, ID);
+	STATS::Count(STATS::ECounter::TextureBinds);
 
 	// Create an empty data array to create a blank texture
 	int size = Width * Height * (rgb ? 3 : 4);// *sizeof(GLuint)
@@ -168,16 +172,25 @@ CTexture* CTexture::GetTexture(std::string textureName)
 	}
 }
 
+/*
+	Stores a texture under a name, the texture will be deleted on clean up. Replacing a texture keeps the
+	existing CTexture and moves the new one into it, as sprites and animation libraries hold on to the pointer
+
+	@param textureName The name to store the texture under
+	@param texture The texture to store, this is deleted if it replaces an existing texture
+*/
 void CTexture::SetTexture(std::string textureName, CTexture* texture)
 {
 	auto it = TextureIDs.find(textureName);
 	if (it != TextureIDs.end())
 	{
-		GLuint id = it->second->GetID();
-		glDeleteTextures(1, &id);
+		CTexture* existing = it->second;
+		IfThenReturn(existing == texture, );
+
+		glDeleteTextures(1, &existing->ID);
 
-		delete it->second;
-		it->second = texture;
+		*existing = *texture;
+		delete texture;
 	}
 	else
 	{
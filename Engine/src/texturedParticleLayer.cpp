@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "texturedParticleLayer.h"
 
 #include <gtc/type_ptr.hpp>
@@ -8,35 +10,44 @@
 #include "mesh.h"
 #include "camera.h"
 #include "graphics.h"
+#include "jobSystem.h"
+#include "renderStats.h"
+#include "frameArena.h"
 
 CTexturedParticleLayer::CTexturedParticleLayer()
 {
 	TextureProgram = CProgram::GetProgram("Texture");
 	SquareMesh = CMesh::GetMesh("3D Square");
 	LayerType = "CTexturedParticleLayer";
+	ParallelPhase = true;
+	ParticlesStat = STATS::RegisterValue("Particles");
 }
 
-void CTexturedParticleLayer::Update()
+void CTexturedParticleLayer::UpdateParallel()
 {
 	float dt = TIMER::GetDeltaSeconds();
 
-	std::list<TexturedParticle>::iterator it = Particles.begin();
-	while (it != Particles.end())
+	JOBS::ParallelFor((int)Particles.size(), 256, [this, dt](int start, int end)
 	{
-		it->LifeTime -= dt;
-
-		if (it->LifeTime <= 0.0f)
-		{
-			it = Particles.erase(it);
-		}
-		else
+		for (int i = start; i < end; ++i)
 		{
-			it->Velocity += it->Acceleration * dt;
-			it->Location += it->Velocity * dt;
-			it->Scale = (it->LifeTime / it->OriginalLifeTime) * it->OriginalScale;
-			++it;
+			TexturedParticle& p = Particles[i];
+			p.LifeTime -= dt;
+
+			IfThenStatement(p.LifeTime <= 0.0f, continue);
+
+			p.Velocity += p.Acceleration * dt;
+			p.Location += p.Velocity * dt;
+			p.Scale = (p.LifeTime / p.OriginalLifeTime) * p.OriginalScale;
 		}
-	}
+	});
+}
+
+void CTexturedParticleLayer::Update()
+{
+	// Remove the dead particles now that integration has finished
+	Particles.erase(std::remove_if(Particles.begin(), Particles.end(), [](const TexturedParticle& p) { return p.LifeTime <= 0.0f; }), Particles.end());
+	STATS::SetValue(ParticlesStat, (int)Particles.size());
 }
 
 void CTexturedParticleLayer::Render()
@@ -55,19 +66,35 @@ void CTexturedParticleLayer::Render()
 
 	GLuint pvmID = TextureProgram->GetUniform("PVM");
 	GLuint texID = TextureProgram->GetUniform("tex");
+	glUniform1i(texID, 0);
+
+	// Group the particles by texture so each texture is only bound once
+	FrameVector<std::pair<GLuint, int>> order;
+	order.reserve(Particles.size());
+	for (int i = 0; i < (int)Particles.size(); ++i) { order.emplace_back(Particles[i].TextureID, i); }
+	std::sort(order.begin(), order.end());
 
-	for (TexturedParticle& p : Particles)
+	GLuint boundTexture = 0;
+
+	for (const std::pair<GLuint, int>& entry : order)
 	{
+		TexturedParticle& p = Particles[entry.second];
+
 		// Set the matrix
 		glm::mat4 pvm = viewProjMat * GFX::CalculateModelMatrix(p.Location, glm::vec2(p.Scale, -p.Scale));
 		glUniformMatrix4fv(pvmID, 1, GL_FALSE, glm::value_ptr(pvm));
 
-		// Set the colou
-		glBindTexture(GL_TEXTURE_2D, p.TextureID);
-		glUniform1i(texID, 0); 
+		// Set the texture
+		if (p.TextureID != boundTexture)
+		{
+			glBindTexture(GL_TEXTURE_2D, p.TextureID);
+			STATS::Count(STATS::ECounter::TextureBinds);
+			boundTexture = p.TextureID;
+		}
 
 		// Draw the particle
 		glDrawElements(GL_TRIANGLES, tempIndicieCount, GL_UNSIGNED_INT, 0);
+		STATS::Count(STATS::ECounter::DrawCalls);
 	}
 
 	// Unbind
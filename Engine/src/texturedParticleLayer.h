@@ -5,7 +5,7 @@
 #include <glm/glm.hpp>
 
 #include <map>
-#include <list>
+#include <vector>
 
 class CProgram;
 class CMesh;
@@ -35,6 +35,7 @@ class CTexturedParticleLayer :
 public:
     CTexturedParticleLayer();
 
+    void UpdateParallel() override;
     void Update() override;
     void Render() override;
 
@@ -62,7 +63,8 @@ private:
         GLuint TextureID;
     };
 
-    std::list<TexturedParticle> Particles;
+    std::vector<TexturedParticle> Particles;
+    int ParticlesStat;
     std::map<std::string, TexturedParticleType> ParticleTypes;
 
 
@@ -11,6 +11,7 @@
 #include "mesh.h"
 #include "program.h"
 #include "helper.h"
+#include "renderStats.h"
 
 std::map<std::string, CTilemapLayer*> CTilemapLayer::Tilemaps;
 
@@ -87,6 +88,7 @@ int TilemapTexture::GetLocationY(int ID)
 CTilemapLayer::CTilemapLayer(TilemapTexture* aTileSet, TilemapGrid* aTileGrid)
 {
 	LayerType = "CTilemapLayer";
+	ParallelPhase = true;
 
 	TileSet = aTileSet;
 	TileGrid = aTileGrid;
@@ -113,17 +115,18 @@ void CTilemapLayer::Render()
 	// Set Texture
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, TileSet->TilesTexture->GetID());
+	STATS::Count(STATS::ECounter::TextureBinds);
 	glUniform1i(SpriteSheetProgram->GetUniform("tex"), 0);
 
 	// Bind mesh
 	glBindVertexArray(TileMesh->GetVAO());
 	int tempIndicieCount = TileMesh->GetIndicieCount();
 
-	GLuint spriteIndexID = SpriteSheetProgram->GetUniform("spriteIndex");
+	GLuint uvRectID = SpriteSheetProgram->GetUniform("uvRect");
 	GLuint pvmID = SpriteSheetProgram->GetUniform("PVM");
 
-	// Set number of splits
-	glUniform2i(SpriteSheetProgram->GetUniform("splitNumber"), TileSet->SplitX, TileSet->SplitY);
+	// Size of one tile on the tile set
+	glm::vec2 uvSize = glm::vec2(1.0f / TileSet->SplitX, 1.0f / TileSet->SplitY);
 
 	for (int x = 0; x < TileGrid->Width; x++)
 	{
@@ -139,11 +142,12 @@ void CTilemapLayer::Render()
 				glm::mat4 pvm = viewProjMat * glm::translate(glm::mat4(), glm::vec3(locX, y * TileSet->TileHeight, 0.0f));
 				glUniformMatrix4fv(pvmID, 1, GL_FALSE, glm::value_ptr(pvm));
 
-				// Set the sprite index
-				glUniform2i(spriteIndexID, TileSet->GetLocationX(val), TileSet->GetLocationY(val));
+				// Set the sprite rectangle
+				glUniform4f(uvRectID, TileSet->GetLocationX(val) * uvSize.x, TileSet->GetLocationY(val) * uvSize.y, uvSize.x, uvSize.y);
 
 				// Draw the tile
 				glDrawElements(GL_TRIANGLES, tempIndicieCount, GL_UNSIGNED_INT, 0);
+				STATS::Count(STATS::ECounter::DrawCalls);
 			}
 		}
 	}
@@ -159,6 +163,15 @@ void CTilemapLayer::Render()
 	glUseProgram(0);
 }
 
+void CTilemapLayer::UpdateParallel()
+{
+	// Step the animated tiles once per frame rather than every time they are drawn
+	double time = TIMER::GetTotalSeconds();
+	int count = TileGrid->Width * TileGrid->Height;
+
+	for (int i = 0; i < count; ++i) { TileGrid->Grid[i]->Animate(time); }
+}
+
 void CTilemapLayer::Update()
 {
 }
@@ -409,9 +422,15 @@ int StaticTile::GetID()
 AnimatedTile::AnimatedTile(std::vector<int> ids)
 {
 	IDs = ids;
+	Animate(TIMER::GetTotalSeconds());
 }
 
 int AnimatedTile::GetID()
 {
-	return IDs[(int)std::floorf(std::fmodf(TIMER::GetTotalSeconds() * 15.0f, (float)IDs.size()))];
+	return CurrentID;
+}
+
+void AnimatedTile::Animate(double time)
+{
+	CurrentID = IDs[(int)std::floor(std::fmod(time * 15.0, (double)IDs.size()))];
 }
@@ -27,6 +27,7 @@ struct TilemapTexture
 struct Tile
 {
 	virtual int GetID() = 0;
+	virtual void Animate(double time) {}
 };
 
 struct StaticTile : Tile
@@ -40,9 +41,11 @@ struct StaticTile : Tile
 struct AnimatedTile : Tile
 {
 	std::vector<int> IDs;
+	int CurrentID;
 
 	AnimatedTile(std::vector<int> ids);
 	int GetID() override;
+	void Animate(double time) override;
 };
 
 struct TilemapGrid
@@ -70,6 +73,7 @@ public:
 	void Save(std::string filename);
 
 	void Render() override;
+	void UpdateParallel() override;
 	void Update() override;
 
 	int GetCell(int x, int y);
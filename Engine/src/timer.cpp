@@ -1,73 +1,162 @@
 #include <chrono>
+#include <cmath>
+#include <algorithm>
 
 #include "timer.h"
 #include "object.h"
+#include "helper.h"
+
+#define SHADER_SECONDS_PERIOD 3600.0 // Shader time wraps every hour
 
 // Variables to contain time values so they don't have to be calculated every time you want it
-static std::chrono::steady_clock::time_point StartTime;
 static std::chrono::steady_clock::time_point OldTime;
 
+static long long StepNanoseconds = 1000000000LL / DEFAULT_STEP_RATE;
+static long long AccumulatedNanoseconds = 0; // Real time waiting to be simulated
+static long long StepCount = 0;
+static double TimeScale = 1.0;
+
+static float FrameSeconds = 0.0f;
+
+// Wrapped float copies for shaders that hold a reference to them, updated every step
 static float TotalSeconds = 0.0f;
 static float TotalMilliseconds = 0.0f;
 
-static float DeltaSeconds = 0.0f;
-static float DeltaMilliseconds = 0.0f;
+static float DeltaSeconds = 1.0f / DEFAULT_STEP_RATE;
+static float DeltaMilliseconds = 1000.0f / DEFAULT_STEP_RATE;
 
 /*
 	Sets the start time of the application, this can be called again to reset the total times
 */
 void TIMER::Initialise()
 {
-	StartTime = std::chrono::high_resolution_clock::now();
-	OldTime = StartTime;
+	OldTime = std::chrono::steady_clock::now();
+	AccumulatedNanoseconds = 0;
+	StepCount = 0;
+
+	TotalSeconds = 0.0f;
+	TotalMilliseconds = 0.0f;
 }
 
 /*
-	Updates the delta and total times
+	Adds the real time since the last frame to the time waiting to be simulated
 */
 void TIMER::Update()
 {
-	std::chrono::steady_clock::time_point newTime = std::chrono::high_resolution_clock::now();
+	std::chrono::steady_clock::time_point newTime = std::chrono::steady_clock::now();
+	long long frameNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(newTime - OldTime).count();
+	OldTime = newTime;
 
-	std::chrono::duration<float, std::milli> tempDeltaMilli = newTime - OldTime;
-	std::chrono::duration<float> tempDeltaSec = newTime - OldTime;
+	FrameSeconds = frameNanoseconds / 1000000000.0f;
 
-	std::chrono::duration<float, std::milli> tempTotalMilli = newTime - StartTime;
-	std::chrono::duration<float> tempTotalSec = newTime - StartTime;
+	// Drop anything past the step limit, after a sleep or a breakpoint the simulation carries on from where it was.
+	// When fast forwarding the limit covers a short real frame at the scaled rate instead
+	long long limit = std::max(StepNanoseconds * MAX_STEPS_PER_FRAME, (long long)(MAX_FRAME_SECONDS * 1000000000.0 * TimeScale));
+	long long scaledNanoseconds = TimeScale == 1.0 ? frameNanoseconds : (long long)(frameNanoseconds * TimeScale);
 
-	OldTime = newTime;
+	AccumulatedNanoseconds = std::min(AccumulatedNanoseconds + scaledNanoseconds, limit);
+}
+
+/*
+	Changes how fast the simulation runs compared to real time, a scale of 60 simulates a minute every second.
+	Steps keep the same length so a faster scale costs more steps per frame
+
+	@param scale Simulated seconds per real second, 0 pauses the simulation
+*/
+void TIMER::SetTimeScale(double scale)
+{
+	IfThenReturn(scale < 0.0, );
+	TimeScale = scale;
+}
+
+double TIMER::GetTimeScale()
+{
+	return TimeScale;
+}
+
+/*
+	Advances the simulation by one step if a full step of real time has built up
+
+	@return If a step should be simulated
+*/
+bool TIMER::StepSimulation()
+{
+	IfThenReturn(AccumulatedNanoseconds < StepNanoseconds, false);
+
+	AccumulatedNanoseconds -= StepNanoseconds;
+	StepCount++;
+
+	TotalSeconds = GetShaderSeconds();
+	TotalMilliseconds = TotalSeconds * 1000.0f;
+
+	return true;
+}
+
+/*
+	Changes how many simulation steps are run every second
+
+	@param stepsPerSecond The new step rate
+*/
+void TIMER::SetStepRate(int stepsPerSecond)
+{
+	IfThenReturn(stepsPerSecond <= 0, );
 
-	DeltaSeconds = tempDeltaSec.count();
-	DeltaMilliseconds = tempDeltaMilli.count();
+	// Keep the total time continuous across the change
+	double totalSeconds = GetTotalSeconds();
+
+	StepNanoseconds = 1000000000LL / stepsPerSecond;
+	StepCount = (long long)std::llround(totalSeconds * 1000000000.0 / StepNanoseconds);
+	AccumulatedNanoseconds = std::min(AccumulatedNanoseconds, StepNanoseconds);
+
+	DeltaSeconds = StepNanoseconds / 1000000000.0f;
+	DeltaMilliseconds = StepNanoseconds / 1000000.0f;
+}
+
+int TIMER::GetStepRate()
+{
+	return (int)(1000000000LL / StepNanoseconds);
+}
+
+long long TIMER::GetStepCount()
+{
+	return StepCount;
+}
 
-	TotalSeconds = tempTotalSec.count();
-	TotalMilliseconds = tempTotalMilli.count();
+/*
+	Returns how far the current frame is between the last simulated step and the next one,
+	for drawing objects between where they were and where they are
 
+	@return A value from 0 to 1
+*/
+float TIMER::GetInterpolation()
+{
+	return std::min((float)AccumulatedNanoseconds / (float)StepNanoseconds, 1.0f);
 }
 
 /*
 	Return the total seconds
 
-	@return Float of seconds passed since the start time
+	@return Seconds of simulation since the start time
 */
-float TIMER::GetTotalSeconds()
+double TIMER::GetTotalSeconds()
 {
-	return TotalSeconds;
+	return (double)StepCount * (double)StepNanoseconds / 1000000000.0;
 }
+
 /*
 	Return the total milliseconds
 
-	@return Float of milliseconds passed since the start time
+	@return Milliseconds of simulation since the start time
 */
-float TIMER::GetTotalMilliseconds()
+double TIMER::GetTotalMilliseconds()
 {
-	return TotalMilliseconds;
+	return (double)StepCount * (double)StepNanoseconds / 1000000.0;
 }
 
 /*
 	Return the delta seconds
 
-	@return Float of seconds passed since the last frame
+	@return Float of seconds in one simulation step
 */
 float TIMER::GetDeltaSeconds()
 {
@@ -77,13 +166,29 @@ float TIMER::GetDeltaSeconds()
 /*
 	Return the delta milliseconds
 
-	@return Float of milliseconds passed since the last frame
+	@return Float of milliseconds in one simulation step
 */
 float TIMER::GetDeltaMilliseconds()
 {
 	return DeltaMilliseconds;
 }
 
+float TIMER::GetFrameSeconds()
+{
+	return FrameSeconds;
+}
+
+/*
+	Returns the simulation time wrapped to an hour, a float of the full time since start stops being able
+	to tell frames apart after a few days
+
+	@return Seconds from 0 up to an hour
+*/
+float TIMER::GetShaderSeconds()
+{
+	return (float)std::fmod(GetTotalSeconds(), SHADER_SECONDS_PERIOD);
+}
+
 void TIMER::AssignTotalSeconds(CObject* anObj, std::string uniformName)
 {
 	anObj->UpdateUniformFloatR(uniformName, TotalSeconds);
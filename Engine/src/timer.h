@@ -1,21 +1,43 @@
 #pragma once
 #include <string>
 
+#define DEFAULT_STEP_RATE 60 // Simulation steps per second
+#define MAX_STEPS_PER_FRAME 8 // Time past this is dropped rather than simulated, stops a long stall snowballing
+#define MAX_FRAME_SECONDS 0.25 // Longest real frame that is simulated when fast forwarding
+
 class CObject;
 
+/*
+	The simulation runs on a fixed step clock that is separate from how often frames are drawn. TIMER::Update
+	adds the real time that has passed to an accumulator and TIMER::StepSimulation is called until it
+	runs out, every step sees the same delta. Time is kept as a whole number of steps so it never loses precision.
+	The time scale speeds the simulation up or slows it down, fast forwarding runs more steps per frame rather than
+	longer ones so the cats behave exactly as they would in real time
+*/
 namespace TIMER
 {
 	void Initialise(); //Initialise or restart the start time
-	void Update();
+	void Update(); // Adds the real time since the last frame to the simulation accumulator
+	bool StepSimulation(); // Advances the simulation one step if enough time has built up, call until it returns false
+
+	void SetStepRate(int stepsPerSecond);
+	int GetStepRate();
+	void SetTimeScale(double scale); // Simulated seconds per real second
+	double GetTimeScale();
+	long long GetStepCount(); // Steps simulated since the start time
+	float GetInterpolation(); // How far between the last step and the next one the current frame is, 0 to 1
 
-	float GetTotalSeconds();
-	float GetTotalMilliseconds();
+	double GetTotalSeconds(); // Simulation time
+	double GetTotalMilliseconds();
 
-	float GetDeltaSeconds();
+	float GetDeltaSeconds(); // The length of one simulation step
 	float GetDeltaMilliseconds();
 
+	float GetFrameSeconds(); // Real time between the last two frames
+	float GetShaderSeconds(); // Simulation time wrapped so it keeps full precision as a float
+
 	void AssignTotalSeconds(CObject* anObj, std::string uniformName);
 	void AssignTotalMilliseconds(CObject* anObj, std::string uniformName);
 	void AssignDeltaSeconds(CObject* anObj, std::string uniformName);
 	void AssignDeltaMilliseconds(CObject* anObj, std::string uniformName);
-}
\ No newline at end of file
+}
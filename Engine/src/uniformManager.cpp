@@ -1,5 +1,6 @@
 #include "uniformManager.h"
 #include "program.h"
+#include "renderStats.h"
 
 #include <iostream>
 #include <gtc\type_ptr.hpp>
@@ -17,6 +18,7 @@ void CUniformManager::AssignUniforms()
 	{
 		glActiveTexture(GL_TEXTURE0 + i);
 		glBindTexture(GL_TEXTURE_2D, it->second);
+		STATS::Count(STATS::ECounter::TextureBinds);
 		glUniform1i(it->first, i);
 		i++;
 	}
@@ -7,14 +7,11 @@ out vec4 color;
 uniform sampler2D tex;
 uniform vec3 lookup[255];
 
-uniform ivec2 splitNumber;
-uniform ivec2 spriteIndex;
+uniform vec4 uvRect; // Offset (xy) and size (zw) of the frame on the sprite sheet
 
 void main(void)
 {
-	vec2 spriteSize = (vec2(1, 1) / splitNumber);
-
-	vec4 pixel = texture(tex, fragTexCoord * spriteSize + spriteIndex * spriteSize);
+	vec4 pixel = texture(tex, uvRect.xy + fragTexCoord * uvRect.zw);
 	vec3 lookupColor = abs(lookup[int(round(pixel.x * 255.0f))]);
 	color = vec4(lookupColor * pixel.y, pixel.w);
 }
\ No newline at end of file
@@ -5,11 +5,9 @@ in vec2 fragTexCoord;
 out vec4 color;
 
 uniform sampler2D tex;
-uniform ivec2 splitNumber;
-uniform ivec2 spriteIndex;
+uniform vec4 uvRect; // Offset (xy) and size (zw) of the frame on the sprite sheet
 
 void main(void)
 {
-	vec2 spriteSize = (vec2(1, 1) / splitNumber);
-	color = texture(tex, fragTexCoord * spriteSize + spriteIndex * spriteSize);
+	color = texture(tex, uvRect.xy + fragTexCoord * uvRect.zw);
 }
\ No newline at end of file